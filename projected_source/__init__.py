@@ -4,21 +4,20 @@ projected-source: Extract and project source code into documentation.
 
 import logging
 
-from rich.logging import RichHandler
-
 __version__ = "0.1.0"
 
 # Package-level logger
 logger = logging.getLogger(__name__)
 
 
-def setup_logging(level=logging.INFO, use_rich=True):
+def setup_logging(level=logging.INFO, use_rich=True, stderr=False):
     """
     Setup logging for the entire package.
 
     Args:
         level: Logging level
         use_rich: Use rich handler for pretty output
+        stderr: Log to stderr even with the rich handler (for commands whose stdout is a protocol)
     """
     root_logger = logging.getLogger("projected_source")
     root_logger.setLevel(level)
@@ -27,7 +26,11 @@ def setup_logging(level=logging.INFO, use_rich=True):
     root_logger.handlers = []
 
     if use_rich:
-        handler = RichHandler(rich_tracebacks=True, show_path=False, markup=True)
+        from rich.console import Console
+        from rich.logging import RichHandler
+
+        console = Console(stderr=True) if stderr else None
+        handler = RichHandler(console=console, rich_tracebacks=True, show_path=False, markup=True)
         handler.setFormatter(logging.Formatter("%(message)s"))
     else:
         handler = logging.StreamHandler()
@@ -1,22 +1,47 @@
 """
 Command-line interface for projected-source.
+
+Subcommand modules are imported only when their command runs (or help lists them),
+so `projected-source render` never pays for serve, bench or the proto grammar.
 """
 
+import importlib
 import logging
 
 import click
-from rich.table import Table
 
 from .. import setup_logging
-from .ai_guide import ai_guide
-from .find_markers import find_markers
-from .helpers import console
-from .render import render
 
 logger = logging.getLogger(__name__)
 
+# Command name -> "module:attribute" under this package
+COMMANDS = {
+    "render": "render:render",
+    "extract": "extract:extract",
+    "serve": "serve:serve",
+    "ai-guide": "ai_guide:ai_guide",
+    "find-markers": "find_markers:find_markers",
+    "index": "index:index",
+    "bench": "bench:bench",
+}
+
+
+class LazyGroup(click.Group):
+    """Click group that imports subcommands from COMMANDS on first use."""
+
+    def list_commands(self, ctx):
+        return sorted(set(super().list_commands(ctx)) | set(COMMANDS))
+
+    def get_command(self, ctx, cmd_name):
+        command = super().get_command(ctx, cmd_name)
+        if command is None and cmd_name in COMMANDS:
+            module_name, attribute = COMMANDS[cmd_name].split(":")
+            command = getattr(importlib.import_module(f".{module_name}", __name__), attribute)
+            self.add_command(command, cmd_name)
+        return command
 
-@click.group()
+
+@click.group(cls=LazyGroup)
 @click.option("--verbose", "-v", is_flag=True, help="Enable verbose logging")
 @click.option("--debug", "-d", is_flag=True, help="Enable debug logging")
 def cli(verbose, debug):
@@ -29,15 +54,13 @@ def cli(verbose, debug):
         setup_logging(logging.WARNING)
 
 
-# Register commands
-cli.add_command(render)
-cli.add_command(ai_guide)
-cli.add_command(find_markers)
-
-
 @cli.command()
 def list_functions():
     """List available extraction functions."""
+    from rich.table import Table
+
+    from .helpers import console
+
     table = Table(title="Available Extraction Functions")
     table.add_column("Function", style="cyan")
     table.add_column("Description", style="green")
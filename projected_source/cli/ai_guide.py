@@ -22,7 +22,7 @@ codebase. Uses tree-sitter for accurate parsing.
 Extraction priority (best to worst):
 1. `function='Name'` - functions, methods (use `signature=` for overloads)
 2. `struct='Name'` / `var='Name'` - types, constants, variables (C/C++)
-3. `message='Name'` / `enum='Name'` / `service='Name'` - protobuf definitions
+3. `message='Name'` / `enum='Name'` / `service='Name'` / `rpc='Service.Method'` - protobuf definitions
 4. `function_macro=` / `macro_definition=` - macro-based code
 5. `function='X', marker='Y'` - subsection within a function (when needed)
 6. `marker='X'` - standalone markers (last resort)
@@ -52,6 +52,16 @@ projected-source render docs/ -V auto              # auto-detect base
 projected-source render docs/ -V origin/main       # specific base
 projected-source render docs/ -V HEAD~5..HEAD~2    # commit range
 projected-source render docs/ -V auto --strict     # exit 1 if uncovered
+
+# Look up many snippets in one process (JSONL in, JSONL out, in order)
+projected-source extract requests.jsonl
+echo '{"id": 1, "file": "src/file.cpp", "function": "main"}' | projected-source extract
+# -> {"id": 1, "file": "src/file.cpp", "start_line": 3, "end_line": 9, "code": "...",
+#     "language": "cpp", "permalink": "https://github.com/..."}
+
+# Or keep one warm process for the whole session (JSON-RPC on stdio, MCP tools
+# "extract" and "render"); follow-up lookups take milliseconds
+projected-source serve
 ```
 
 ## Template Functions
@@ -87,10 +97,16 @@ projected-source render docs/ -V auto --strict     # exit 1 if uncovered
 {# Extract macro definition #}
 {{ code('src/file.h', macro_definition='MAX_BUFFER_SIZE') }}
 
+{# File unknown: look the symbol up in the index (qualify names that occur in several files) #}
+{{ code(function='net::Peer::onMessage', signature='TMProposeSet') }}
+{{ code(struct='Config') }}
+
 {# Protocol Buffers (.proto) #}
 {{ code('src/proto/messages.proto', message='Transaction') }}
 {{ code('src/proto/messages.proto', enum='MessageType') }}
 {{ code('src/proto/messages.proto', service='PeerService') }}
+{{ code('src/proto/messages.proto', rpc='PeerService.GetLedger') }}
+{{ code('src/proto/messages.proto', enum='TMGetObjectByHash.ObjectType') }}  {# nested names #}
 {{ code('src/proto/messages.proto', message='Transaction', marker='key-fields') }}
 
 {# Options #}
@@ -147,9 +163,9 @@ Example output:
 Shows uncovered code changes with actual source:
 
 ```
-⚠ 3 uncovered regions:
+⚠ 3 uncovered regions (41/95 changed lines in 4 files documented):
 
-━━━ src/handlers/Submit.cpp ━━━
+━━━ src/handlers/Submit.cpp (20% covered) ━━━
 230-261:
    230 void handleSubmit() {
    231     // new code not documented
@@ -162,9 +178,12 @@ Shows uncovered code changes with actual source:
 2. **Use `signature=` for overloads** - e.g., `function='onMessage', signature='TMProposeSet'`
 3. **Markers only for subsections** - When you need part of a function/message, not the whole thing
 4. **Never use line ranges** unless absolutely necessary - they break on any edit
-5. **Use relative paths** from repo root in code() calls
+5. **Use relative paths** from repo root in code() calls, or omit the path for a
+   qualified symbol name and let the index find the file (`--include-root` narrows it)
 6. **Use ignore_changes()** at the top of templates for test files, build configs
 7. **Check -V output** to ensure all changes are documented
-8. **Proto files** - Use `message=`, `enum=`, `service=` for .proto extraction
+8. **Proto files** - Use `message=`, `enum=`, `service=`, `rpc=` for .proto extraction
+9. **Batch lookups** - To read many snippets outside a template, send them all to one
+   `extract` process instead of running `render - -` once per snippet
 """
     click.echo(guide)
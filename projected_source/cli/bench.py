@@ -0,0 +1,128 @@
+"""
+Bench command - measure extraction throughput and compare against a baseline.
+"""
+
+import json
+import sys
+import tempfile
+from pathlib import Path
+
+import click
+from rich.table import Table
+
+from ..core.benchmark import compare_baselines, over_budget, run_benchmarks
+from .helpers import console
+
+
+@click.command("bench")
+@click.option(
+    "--repo-path", "-r", type=click.Path(exists=True, path_type=Path), default=Path.cwd(), help="Repository root path"
+)
+@click.option("--iterations", "-n", type=int, default=20, show_default=True, help="Runs per case (cold and warm each)")
+@click.option(
+    "--synthetic-size", type=int, default=2000, show_default=True, help="Functions in the generated C++ file"
+)
+@click.option("--filter", "-k", "name_filter", default=None, help="Only run cases whose name contains this")
+@click.option("--output", "-o", type=click.Path(path_type=Path), default=None, help="Write results as a JSON baseline")
+@click.option(
+    "--compare",
+    "baseline_path",
+    type=click.Path(exists=True, path_type=Path),
+    default=None,
+    help="Baseline JSON to compare against; exits 1 on regressions",
+)
+@click.option(
+    "--threshold", type=float, default=0.2, show_default=True, help="Relative p50 slowdown counted as a regression"
+)
+@click.option("--no-startup", is_flag=True, help="Skip the cold CLI startup measurements")
+def bench(repo_path, iterations, synthetic_size, name_filter, output, baseline_path, threshold, no_startup):
+    """
+    Benchmark every extraction type.
+
+    Cases cover examples/, tests/fixtures/ and generated large C++/proto files.
+    "cold" runs start from an empty parse cache (read + parse + lookup), "warm"
+    runs reuse cached trees and symbol tables. Cold CLI startup is timed in
+    fresh interpreters and exits 1 when over its budget.
+
+    Examples:
+        projected-source bench
+        projected-source bench -o bench.json
+        projected-source bench --compare bench.json --threshold 0.1
+    """
+    with tempfile.TemporaryDirectory(prefix="projected-source-bench-") as work_dir:
+        results = run_benchmarks(
+            repo_path,
+            Path(work_dir),
+            iterations=iterations,
+            synthetic_size=synthetic_size,
+            name_filter=name_filter,
+            progress=lambda name: console.print(f"[dim]  {name}[/dim]"),
+            startup=not no_startup,
+        )
+
+    table = Table(title=f"Extraction latency (ms, {iterations} runs)")
+    table.add_column("Case", style="cyan")
+    for column in ("cold p50", "cold p90", "cold p99", "warm p50", "warm p99"):
+        table.add_column(column, justify="right")
+    for name, result in results["cases"].items():
+        if "error" in result:
+            table.add_row(name, f"[red]{result['error']}[/red]", "", "", "", "")
+            continue
+        cold, warm = result["cold"], result["warm"]
+        table.add_row(
+            name,
+            f"{cold['p50_ms']:.3f}",
+            f"{cold['p90_ms']:.3f}",
+            f"{cold['p99_ms']:.3f}",
+            f"{warm['p50_ms']:.3f}",
+            f"{warm['p99_ms']:.3f}",
+        )
+    console.print(table)
+
+    parse_table = Table(title="Parse throughput (uncached)")
+    parse_table.add_column("File", style="cyan")
+    parse_table.add_column("KB", justify="right")
+    parse_table.add_column("parses/s", justify="right")
+    parse_table.add_column("MB/s", justify="right")
+    for name, stats in results["parse"].items():
+        parse_table.add_row(
+            name, f"{stats['bytes'] / 1024:.0f}", f"{stats['parses_per_s']:.1f}", f"{stats['mb_per_s']:.1f}"
+        )
+    console.print(parse_table)
+
+    if results["startup"]:
+        startup_table = Table(title="Cold startup (ms, new process)")
+        startup_table.add_column("Command", style="cyan")
+        for column in ("p50", "p90", "budget"):
+            startup_table.add_column(column, justify="right")
+        for name, stats in results["startup"].items():
+            if "error" in stats:
+                startup_table.add_row(name, f"[red]{stats['error']}[/red]", "", "")
+                continue
+            budget = f"{stats['budget_ms']:.0f}" if stats.get("budget_ms") else "-"
+            startup_table.add_row(name, f"{stats['p50_ms']:.1f}", f"{stats['p90_ms']:.1f}", budget)
+        console.print(startup_table)
+
+    if results["peak_rss_mb"] is not None:
+        console.print(f"Peak RSS: {results['peak_rss_mb']:.1f} MB")
+
+    if output:
+        output.write_text(json.dumps(results, indent=2) + "\n")
+        console.print(f"[green]✓[/green] Baseline written to {output}")
+
+    slow_starts = over_budget(results["startup"])
+    for name, p50, budget in slow_starts:
+        console.print(f"[red]✗ Startup '{name}' p50 {p50:.1f} ms is over its {budget:.0f} ms budget[/red]")
+
+    if baseline_path:
+        baseline = json.loads(baseline_path.read_text())
+        regressions = compare_baselines(baseline, results, threshold)
+        if regressions:
+            console.print(f"\n[red]✗ {len(regressions)} regression(s) over {threshold:.0%}:[/red]")
+            for name, mode, before, after in regressions:
+                console.print(f"  • {name} ({mode}): {before:.3f} → {after:.3f} ms")
+            sys.exit(1)
+        console.print(f"[green]✓ No regressions over {threshold:.0%} against {baseline_path}[/green]")
+
+    if slow_starts:
+        sys.exit(1)
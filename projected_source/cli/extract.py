@@ -0,0 +1,167 @@
+"""
+Extract command - resolve a batch of code() requests to JSON in one process.
+"""
+
+import json
+from pathlib import Path
+from typing import Any, Dict, Iterable, Iterator, Optional, Tuple
+
+import click
+
+from ..core.git_source import GitTreeSource
+from ..core.parse_cache import get_parse_cache
+from ..core.render_cache import RenderCache, set_render_cache
+from ..core.renderer import TemplateRenderer
+from ..core.symbol_index import SymbolIndex, default_index_path, get_symbol_index, set_symbol_index
+from ..core.symbol_resolver import SymbolResolver, set_symbol_resolver
+
+
+def iter_requests(lines: Iterable[str]) -> Iterator[Tuple[Optional[Dict[str, Any]], Optional[str]]]:
+    """
+    Parse a batch: one JSON object per line, or a single JSON array of objects.
+
+    Lines are parsed as they arrive, so a JSONL producer gets each answer before
+    sending the next request.
+
+    Yields:
+        (request, None), or (None, error message) for an entry that is not a JSON object
+    """
+    lines = iter(lines)
+    for line in lines:
+        if not line.strip():
+            continue
+        if line.lstrip().startswith("["):
+            try:
+                entries = json.loads(line + "".join(lines))
+            except json.JSONDecodeError as e:
+                yield None, f"Invalid JSON array: {e}"
+                return
+        else:
+            try:
+                entries = [json.loads(line)]
+            except json.JSONDecodeError as e:
+                yield None, f"Invalid JSON line: {e}"
+                continue
+        for entry in entries:
+            if isinstance(entry, dict):
+                yield entry, None
+            else:
+                yield None, f"Request must be a JSON object, got {type(entry).__name__}"
+
+
+def snippet_arguments(request: Dict[str, Any]) -> Tuple[Optional[str], Dict[str, Any]]:
+    """
+    Split a request into extract_snippet() arguments.
+
+    Returns:
+        (file path from "file" or "file_path", remaining code() arguments with JSON lists made tuples)
+    """
+    arguments = dict(request)
+    file_path = arguments.pop("file", None)
+    file_path = arguments.pop("file_path", file_path)
+    if isinstance(arguments.get("lines"), list):
+        arguments["lines"] = tuple(arguments["lines"])
+    return file_path, arguments
+
+
+def run_request(renderer: TemplateRenderer, request: Dict[str, Any]) -> Dict[str, Any]:
+    """
+    Extract one request.
+
+    Args:
+        renderer: Renderer whose caches and git metadata all requests share
+        request: code() arguments, with "file" for the path and an optional "id" echoed back
+
+    Returns:
+        extract_snippet() result, or {"error": message}; "id" first if the request had one
+    """
+    request = dict(request)
+    request_id = request.pop("id", None)
+    file_path, arguments = snippet_arguments(request)
+
+    try:
+        result = renderer.extract_snippet(file_path, **arguments)
+    except Exception as e:
+        result = {"error": str(e)}
+    return {"id": request_id, **result} if request_id is not None else result
+
+
+@click.command("extract")
+@click.argument("input_path", type=click.Path(path_type=Path), default="-")
+@click.option(
+    "--repo-path", "-r", type=click.Path(exists=True, path_type=Path), default=Path.cwd(), help="Repository root path"
+)
+@click.option(
+    "--output", "-o", type=click.Path(path_type=Path), default=None, help="Write results here instead of stdout"
+)
+@click.option("--commit", "-c", type=str, default=None, help="Read sources at this commit/branch/tag")
+@click.option(
+    "--index-path",
+    type=click.Path(path_type=Path),
+    default=None,
+    help="Symbol index for requests without a file (default: <repo>/.projected-source/index.db)",
+)
+@click.option(
+    "--cache-dir",
+    type=click.Path(path_type=Path),
+    default=None,
+    help="Cache extraction results here, keyed by file content (as in render)",
+)
+def extract(input_path, repo_path, output, commit, index_path, cache_dir):
+    """
+    Extract many snippets in one process, as JSON lines.
+
+    INPUT_PATH ('-' for stdin, the default) holds one request per line (JSONL) or a
+    JSON array of requests. A request takes the code() selection arguments plus
+    "file" and an optional "id":
+
+        {"id": 1, "file": "src/a.cpp", "function": "onMessage", "signature": "TMProposeSet"}
+
+    Each request produces one line, in order:
+
+        {"id": 1, "file": ..., "start_line": ..., "end_line": ..., "code": ...,
+         "language": "cpp", "permalink": "https://github.com/..."}
+
+    or {"id": 1, "error": "..."}. Files are read, parsed and indexed once for the
+    whole batch, and JSONL input is answered line by line, so a tool can keep one
+    process open instead of starting the CLI per snippet.
+
+    Examples:
+        projected-source extract requests.jsonl -o results.jsonl
+        echo '{"file": "src/a.cpp", "function": "main"}' | projected-source extract
+    """
+    if index_path is None and default_index_path(repo_path).exists():
+        index_path = default_index_path(repo_path)
+    if index_path is not None:
+        set_symbol_index(SymbolIndex(index_path))
+    set_symbol_resolver(SymbolResolver([repo_path], index_path or default_index_path(repo_path)))
+    if cache_dir is not None:
+        set_render_cache(RenderCache(cache_dir))
+
+    source = GitTreeSource(repo_path, commit) if commit else None
+    get_parse_cache().set_source(source)
+    renderer = TemplateRenderer(template_dir=Path.cwd(), repo_path=repo_path, commit=source.commit if source else None)
+
+    extracted = failed = 0
+    try:
+        with click.open_file(str(input_path), "r") as requests, click.open_file(str(output or "-"), "w") as out:
+            for request, error in iter_requests(requests):
+                result = run_request(renderer, request) if request is not None else {"error": error}
+                if "error" in result:
+                    failed += 1
+                else:
+                    extracted += 1
+                out.write(json.dumps(result) + "\n")
+                out.flush()
+    finally:
+        get_parse_cache().set_source(None)
+        if source:
+            source.close()
+        set_symbol_resolver(None)
+        symbol_index = get_symbol_index()
+        if symbol_index:
+            symbol_index.close()
+            set_symbol_index(None)
+        set_render_cache(None)
+
+    click.echo(f"{extracted} extracted, {failed} failed", err=True)
@@ -2,15 +2,12 @@
 Find markers command - locate and optionally remove markers in changed files.
 """
 
-import re
-import subprocess
 import sys
-from collections import defaultdict
 from pathlib import Path
-from typing import Dict, List, Tuple
 
 import click
 
+from ..core.marker_cleanup import find_changed_markers, remove_markers
 from .helpers import console
 
 
@@ -33,89 +30,52 @@ from .helpers import console
     default=Path.cwd(),
     help="Repository root path",
 )
-def find_markers(since: str, remove: bool, repo_path: Path):
+@click.option(
+    "--whole-files",
+    is_flag=True,
+    help="Scan the full contents of changed files, not only the lines the changeset added",
+)
+@click.option("--jobs", "-j", type=int, default=None, help="Files scanned or edited in parallel (default: per CPU)")
+def find_markers(since: str, remove: bool, repo_path: Path, whole_files: bool, jobs: int):
     """
     Find //@@start and //@@end markers in changed C/C++ files.
 
     Scans files changed since <ref> for marker comments used by projected-source.
     Useful for cleaning up markers after documentation is finalized.
 
+    For a plain ref, only the lines added since it (including uncommitted edits)
+    are scanned, straight from `git diff -U0`. An explicit range (a..b) or
+    --whole-files scans every changed file in full, in parallel.
+
     Examples:
         projected-source find-markers --since origin/dev
         projected-source find-markers --since HEAD~5 --remove
+        projected-source find-markers --since origin/dev..HEAD --whole-files
     """
-    # Get changed files from git
-    diff_range = since if ".." in since else f"{since}..HEAD"
-
-    result = subprocess.run(
-        ["git", "diff", diff_range, "--name-only"],
-        capture_output=True,
-        cwd=repo_path,
-        text=True,
-    )
-
-    if result.returncode != 0:
-        console.print(f"[red]✗ git diff failed: {result.stderr}[/red]")
+    try:
+        by_file = find_changed_markers(repo_path, since, whole_files=whole_files, jobs=jobs)
+    except RuntimeError as e:
+        console.print(f"[red]✗ {e}[/red]")
         sys.exit(1)
 
-    # Filter for C/C++ files
-    cpp_extensions = {".h", ".hpp", ".cpp", ".cc", ".cxx", ".c", ".hxx", ".ipp"}
-    changed_files = []
-    for line in result.stdout.strip().split("\n"):
-        if line:
-            path = Path(line)
-            if path.suffix.lower() in cpp_extensions:
-                changed_files.append(repo_path / path)
-
-    if not changed_files:
-        console.print(f"[yellow]No C/C++ files changed since {since}[/yellow]")
-        return
-
-    console.print(f"[cyan]Scanning {len(changed_files)} file(s) for markers...[/cyan]\n")
-
-    # Pattern for marker comments on their own line
-    marker_pattern = re.compile(r"^(\s*)//@@(start|end)\s+([\w-]+)\s*$")
-
-    # Collect all markers
-    all_markers: List[Tuple[Path, int, str, str, str]] = []  # (file, line, type, name, full_line)
-
-    for file_path in changed_files:
-        if not file_path.exists():
-            continue
-
-        try:
-            lines = file_path.read_text().splitlines()
-        except Exception as e:
-            console.print(f"[red]Could not read {file_path}: {e}[/red]")
-            continue
-
-        for line_num, line in enumerate(lines, 1):
-            match = marker_pattern.match(line)
-            if match:
-                indent, marker_type, marker_name = match.groups()
-                all_markers.append((file_path, line_num, marker_type, marker_name, line))
-
-    if not all_markers:
-        console.print("[green]No markers found in changed files[/green]")
+    if not by_file:
+        console.print(f"[green]No markers found in C/C++ files changed since {since}[/green]")
         return
 
-    # Group by file for display
-    by_file: Dict[Path, List[Tuple[int, str, str, str]]] = defaultdict(list)
-    for file_path, line_num, marker_type, marker_name, full_line in all_markers:
-        by_file[file_path].append((line_num, marker_type, marker_name, full_line))
-
-    # Display markers
-    console.print(f"[bold]Found {len(all_markers)} marker(s):[/bold]\n")
+    total = sum(len(directives) for directives in by_file.values())
+    console.print(f"[bold]Found {total} marker(s) in {len(by_file)} file(s):[/bold]\n")
 
-    for file_path, markers in sorted(by_file.items()):
+    def relative(file_path: Path) -> Path:
         try:
-            rel_path = file_path.relative_to(repo_path)
+            return file_path.relative_to(repo_path)
         except ValueError:
-            rel_path = file_path
-        console.print(f"[cyan]{rel_path}:[/cyan]")
-        for line_num, marker_type, marker_name, full_line in markers:
-            type_color = "green" if marker_type == "start" else "yellow"
-            console.print(f"  {line_num:4}: [{type_color}]//@@{marker_type} {marker_name}[/{type_color}]")
+            return file_path
+
+    for file_path, directives in sorted(by_file.items()):
+        console.print(f"[cyan]{relative(file_path)}:[/cyan]")
+        for directive in directives:
+            type_color = "green" if directive.kind == "start" else "yellow"
+            console.print(f"  {directive.line:4}: [{type_color}]//@@{directive.kind} {directive.name}[/{type_color}]")
         console.print()
 
     # Remove markers if requested
@@ -123,25 +83,11 @@ def find_markers(since: str, remove: bool, repo_path: Path):
         console.print("[bold]Removing markers...[/bold]\n")
 
         removed_count = 0
-        for file_path, markers in by_file.items():
-            lines_to_remove = {m[0] for m in markers}  # line numbers (1-based)
-
-            try:
-                original_lines = file_path.read_text().splitlines()
-                new_lines = [line for i, line in enumerate(original_lines, 1) if i not in lines_to_remove]
-
-                if len(new_lines) < len(original_lines):
-                    file_path.write_text("\n".join(new_lines) + "\n")
-                    count = len(original_lines) - len(new_lines)
-                    removed_count += count
-
-                    try:
-                        rel_path = file_path.relative_to(repo_path)
-                    except ValueError:
-                        rel_path = file_path
-                    console.print(f"  [green]✓[/green] {rel_path}: removed {count} marker(s)")
-
-            except Exception as e:
-                console.print(f"  [red]✗[/red] {file_path}: {e}")
+        for file_path, (count, error) in sorted(remove_markers(by_file, jobs).items()):
+            if error:
+                console.print(f"  [red]✗[/red] {relative(file_path)}: {error}")
+            elif count:
+                removed_count += count
+                console.print(f"  [green]✓[/green] {relative(file_path)}: removed {count} marker(s)")
 
         console.print(f"\n[bold green]Removed {removed_count} marker(s) total[/bold green]")
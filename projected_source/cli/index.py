@@ -0,0 +1,56 @@
+"""
+Index command - build or refresh the on-disk symbol index.
+"""
+
+from pathlib import Path
+
+import click
+
+from ..core.symbol_index import SymbolIndex, default_index_path, index_files, iter_source_files
+from .helpers import console
+
+
+@click.command("index")
+@click.argument("paths", nargs=-1, type=click.Path(exists=True, path_type=Path))
+@click.option(
+    "--repo-path", "-r", type=click.Path(exists=True, path_type=Path), default=Path.cwd(), help="Repository root path"
+)
+@click.option(
+    "--index-path",
+    type=click.Path(path_type=Path),
+    default=None,
+    help="Index database (default: <repo>/.projected-source/index.db)",
+)
+@click.option("--prune", is_flag=True, help="Drop indexed content no longer referenced by any file")
+def index(paths, repo_path, index_path, prune):
+    """
+    Build or refresh the symbol index for C/C++ sources.
+
+    Records every function, method, struct/class/enum, #define and function-macro
+    invocation per file, keyed by git blob hash. `render` uses the index when it
+    exists, so unchanged files are not re-walked on later runs.
+
+    PATHS default to the repository root.
+
+    Examples:
+        projected-source index
+        projected-source index src/ include/
+    """
+    index_path = index_path or default_index_path(repo_path)
+    symbol_index = SymbolIndex(index_path)
+
+    try:
+        files = list(iter_source_files(list(paths) or [repo_path]))
+        stats = index_files(files, symbol_index)
+        pruned = symbol_index.prune() if prune else 0
+    finally:
+        symbol_index.close()
+
+    console.print(
+        f"[green]✓[/green] Indexed {stats.files} file(s) → {index_path}: "
+        f"{stats.built} built, {stats.reused} reused, {stats.unchanged} unchanged"
+    )
+    if pruned:
+        console.print(f"[dim]Pruned {pruned} stale table(s)[/dim]")
+    if stats.failed:
+        console.print(f"[yellow]⚠ {stats.failed} file(s) could not be indexed (see log)[/yellow]")
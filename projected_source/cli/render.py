@@ -2,58 +2,52 @@
 Render command for processing Jinja2 templates.
 """
 
-import shutil
-import subprocess
+import os
 import sys
 import tempfile
 from collections import defaultdict
-from contextlib import contextmanager
+from concurrent.futures import ProcessPoolExecutor
+from contextlib import contextmanager, nullcontext
 from pathlib import Path
-from typing import Optional
+from typing import Iterable, List, Optional, Tuple
 
 import click
 
 from ..core.changes_set import ChangesSet
-from ..core.renderer import TemplateRenderer
+from ..core.git_source import GitTreeSource
+from ..core.github import GitHubIntegration
+from ..core.parse_cache import get_parse_cache
+from ..core.profiler import Profiler, get_profiler, set_profiler
+from ..core.render_cache import RenderCache, get_render_cache, set_render_cache
+from ..core.render_manifest import RenderManifest, build_entry
+from ..core.renderer import TemplateRenderer, find_custom_tags_file
+from ..core.shared_analysis import SharedAnalysis
+from ..core.symbol_index import SymbolIndex, default_index_path, get_symbol_index, set_symbol_index
+from ..core.symbol_resolver import SymbolResolver, get_symbol_resolver, set_symbol_resolver
 from .helpers import FixtureCollector, console, get_fixture_collector, set_fixture_collector
+from .watch import TemplateWatcher
 
 
 @contextmanager
-def git_worktree_at_commit(repo_path: Path, commit: str):
+def git_tree_at_commit(repo_path: Path, commit: str):
     """
-    Create a temporary git worktree at the specified commit.
+    Read sources at the specified commit instead of the working directory.
 
-    Yields the path to the worktree directory.
-    Cleans up the worktree on exit.
+    Nothing is checked out: extractors read blobs on demand through the parse cache
+    (see GitTreeSource), so only files the templates reference are touched.
+
+    Yields the resolved commit hash.
     """
-    # Create temp directory for worktree
-    tmpdir = tempfile.mkdtemp(prefix="projected-source-")
-    worktree_path = Path(tmpdir)
+    source = GitTreeSource(repo_path, commit)
+    cache = get_parse_cache()
+    cache.set_source(source)
+    console.print(f"[cyan]Using commit: {commit}[/cyan]")
 
     try:
-        # Add worktree at the specified commit (detached HEAD)
-        result = subprocess.run(
-            ["git", "worktree", "add", "--detach", str(worktree_path), commit],
-            capture_output=True,
-            cwd=repo_path,
-            text=True,
-        )
-        if result.returncode != 0:
-            raise RuntimeError(f"Failed to create worktree: {result.stderr}")
-
-        console.print(f"[cyan]Using commit: {commit}[/cyan]")
-        yield worktree_path
-
+        yield source.commit
     finally:
-        # Remove the worktree
-        subprocess.run(
-            ["git", "worktree", "remove", "--force", str(worktree_path)],
-            capture_output=True,
-            cwd=repo_path,
-        )
-        # Clean up temp directory if it still exists
-        if worktree_path.exists():
-            shutil.rmtree(worktree_path, ignore_errors=True)
+        cache.set_source(None)
+        source.close()
 
 
 @click.command()
@@ -90,6 +84,75 @@ def git_worktree_at_commit(repo_path: Path, commit: str):
     default=None,
     help="Render against a specific commit/branch/tag instead of working directory",
 )
+@click.option(
+    "--index-path",
+    type=click.Path(path_type=Path),
+    default=None,
+    help="Symbol index to use and update (default: <repo>/.projected-source/index.db if it exists)",
+)
+@click.option(
+    "--include-root",
+    "include_roots",
+    multiple=True,
+    type=click.Path(exists=True, path_type=Path),
+    help="Where code() calls without a file path look for symbols (repeatable; default: the repository). "
+    "Given roots are indexed in the background while templates load.",
+)
+@click.option(
+    "--cache-dir",
+    type=click.Path(path_type=Path),
+    default=None,
+    help="Cache extraction results here, keyed by file content (share it between CI jobs)",
+)
+@click.option(
+    "--jobs",
+    "-j",
+    type=int,
+    default=1,
+    show_default=True,
+    help="Render directory templates in N worker processes (0 = one per CPU)",
+)
+@click.option(
+    "--resolve-workers",
+    type=int,
+    default=1,
+    show_default=True,
+    help="Resolve code() snippets on N threads after the template pass, overlapping git and file I/O with parsing",
+)
+@click.option(
+    "--memory-budget",
+    type=float,
+    default=None,
+    metavar="MB",
+    help="Bound the estimated memory of cached sources, trees and tables (split across --jobs workers)",
+)
+@click.option(
+    "--stream",
+    is_flag=True,
+    help="Write output chunk by chunk as templates render (flat memory for very large outputs)",
+)
+@click.option(
+    "--profile",
+    is_flag=True,
+    help="Time every stage and print the slowest snippets, parses per file, cache hit rates and git processes",
+)
+@click.option(
+    "--profile-trace",
+    type=click.Path(path_type=Path),
+    default=None,
+    help="Write the profile as Chrome trace-event JSON (chrome://tracing, Perfetto); implies --profile",
+)
+@click.option(
+    "--watch",
+    "-w",
+    is_flag=True,
+    help="Keep running and re-render templates whose sources change",
+)
+@click.option(
+    "--incremental",
+    is_flag=True,
+    help="Directory renders: skip outputs whose templates and sources are unchanged since the last render",
+)
 def render(
     input_path,
     output_path,
@@ -99,6 +162,17 @@ def render(
     changes_base,
     strict,
     commit,
+    index_path,
+    include_roots,
+    cache_dir,
+    jobs,
+    resolve_workers,
+    memory_budget,
+    stream,
+    profile,
+    profile_trace,
+    watch,
+    incremental,
 ):
     """
     Render Jinja2 templates to markdown.
@@ -123,6 +197,30 @@ def render(
         # Render against a specific commit/branch
         projected-source render docs/ --commit v1.0.0
         projected-source render docs/ -c origin/main
+
+        # Reuse extraction results from earlier runs
+        projected-source render docs/ --cache-dir .cache/projected-source
+
+        # Overlap `git cat-file` reads, blame and parsing when rendering another commit
+        projected-source render docs/ --commit origin/main --resolve-workers 8
+
+        # Write huge context bundles without holding them in memory
+        projected-source render bundle.md.j2 - --stream | gzip > bundle.md.gz
+
+        # Re-render on every save while writing docs
+        projected-source render docs/ --watch
+
+        # Only re-render docs whose templates or sources changed since the last render
+        projected-source render docs/ out/ --incremental
+
+        # Find out where a slow doc build spends its time
+        projected-source render docs/ --profile --profile-trace render-trace.json
+
+        # Keep 8 workers over huge generated headers within about 4 GB
+        projected-source render docs/ --jobs 8 --memory-budget 4096
+
+        # Let code(function='ns::Cls::method') find the file under src/ and include/
+        projected-source render docs/ --include-root src --include-root include
     """
     # Set up fixture collection if requested
     if collect_error_fixtures:
@@ -132,6 +230,24 @@ def render(
         set_fixture_collector(FixtureCollector(fixtures_dir))
         console.print(f"[yellow]Fixture collection enabled → {fixtures_dir}[/yellow]")
 
+    profiler = Profiler() if profile or profile_trace else None
+    set_profiler(profiler)
+
+    # Use the symbol index when one was built (tables are keyed by content, so this also serves --commit)
+    if index_path is None and default_index_path(repo_path).exists():
+        index_path = default_index_path(repo_path)
+    if index_path is not None:
+        set_symbol_index(SymbolIndex(index_path))
+    # code() calls without a path look symbols up in the index, built on first use
+    resolver = SymbolResolver(include_roots or [repo_path], index_path or default_index_path(repo_path))
+    set_symbol_resolver(resolver)
+    if include_roots:
+        resolver.start()
+    if cache_dir is not None:
+        set_render_cache(RenderCache(cache_dir))
+    if memory_budget is not None:
+        get_parse_cache().set_memory_budget(int(memory_budget * 1024 * 1024))
+
     # Check for stdin input
     if str(input_path) == "-":
         input_is_stdin = True
@@ -184,20 +300,38 @@ def render(
         console.print("[red]✗ Input and output types must match (both files or both directories)[/red]")
         sys.exit(1)
 
-    # Helper to do the actual rendering
-    def do_render(effective_repo_path: Path):
+    if stream and jobs != 1:
+        console.print("[red]✗ --stream renders one template at a time and cannot be used with --jobs[/red]")
+        sys.exit(1)
+
+    if incremental and (not input_is_dir or changes_base):
+        # Coverage needs every template's code() calls
+        console.print("[red]✗ --incremental only applies to directory input without --validate-changes[/red]")
+        sys.exit(1)
+
+    if watch:
+        if input_is_stdin or commit or changes_base or profiler:
+            console.print(
+                "[red]✗ --watch cannot be used with stdin input, --commit, --validate-changes or --profile[/red]"
+            )
+            sys.exit(1)
+        _watch(input_path, output_path, repo_path, input_is_dir, output_to_stdout, remap_dirty_lines)
+        return
+
+    # Helper to do the actual rendering (head: resolved --commit, or None for the working directory)
+    def do_render(head: Optional[str]):
         # Set up ChangesSet for validation if requested (-V / --validate-changes)
         changes_set: Optional[ChangesSet] = None
         if changes_base:
             # "auto" means auto-detect base
             base = None if changes_base == "auto" else changes_base
             try:
-                changes_set = ChangesSet.from_diff(base=base, repo_path=effective_repo_path)
+                changes_set = ChangesSet.from_diff(base=base, repo_path=repo_path, head=head or "HEAD")
                 if base and ".." in base:
                     range_display = base
                 else:
-                    detected = ChangesSet.detect_base(effective_repo_path) if base is None else base
-                    range_display = f"{detected[:12]}..HEAD"
+                    detected = ChangesSet.detect_base(repo_path, head or "HEAD") if base is None else base
+                    range_display = f"{detected[:12]}..{commit or 'HEAD'}"
                 console.print(f"[cyan]Validating changes: {range_display}[/cyan]")
             except RuntimeError as e:
                 console.print(f"[red]✗ Failed to get diff: {e}[/red]")
@@ -205,53 +339,45 @@ def render(
 
         # Process based on input type
         if input_is_stdin:
-            _render_stdin(output_path, effective_repo_path, output_to_stdout, remap_dirty_lines, changes_set)
+            _render_stdin(
+                output_path, repo_path, output_to_stdout, remap_dirty_lines, changes_set, head, stream, resolve_workers
+            )
         elif input_is_dir:
-            _render_directory(input_path, output_path, effective_repo_path, remap_dirty_lines, changes_set)
+            _render_directory(
+                input_path,
+                output_path,
+                repo_path,
+                remap_dirty_lines,
+                changes_set,
+                jobs,
+                head,
+                stream,
+                resolve_workers,
+                incremental,
+            )
         else:
-            _render_file(input_path, output_path, effective_repo_path, output_to_stdout, remap_dirty_lines, changes_set)
+            _render_file(
+                input_path,
+                output_path,
+                repo_path,
+                output_to_stdout,
+                remap_dirty_lines,
+                changes_set,
+                head,
+                stream,
+                resolve_workers,
+            )
 
-        return changes_set
+        # Report while sources are still read at the rendered commit
+        _report_validation(changes_set, repo_path, strict)
 
     # Render - either against working directory or a specific commit
-    if commit:
-        with git_worktree_at_commit(repo_path, commit) as worktree_path:
-            changes_set = do_render(worktree_path)
-    else:
-        changes_set = do_render(repo_path)
-
-    # Report validation results
-    if changes_set is not None:
-        uncovered = changes_set.uncovered()
-        if uncovered:
-            console.print(f"\n[yellow]⚠ {len(uncovered)} uncovered regions:[/yellow]")
-            # Group by file
-            by_file = defaultdict(list)
-            for region in uncovered:
-                by_file[region.file_path].append((region.start_line, region.end_line))
-
-            for abs_path, ranges in by_file.items():
-                try:
-                    rel_path = abs_path.relative_to(repo_path)
-                except ValueError:
-                    rel_path = abs_path
-                console.print(f"\n[cyan]━━━ {rel_path} ━━━[/cyan]")
-
-                # Read file once, show each range
-                try:
-                    lines = abs_path.read_text().splitlines()
-                    for start, end in ranges:
-                        console.print(f"[dim]{start}-{end}:[/dim]")
-                        for i in range(start - 1, min(end, len(lines))):
-                            console.print(f"  [dim]{i + 1:4}[/dim] {lines[i]}")
-                except Exception as e:
-                    console.print(f"  [red]Could not read file: {e}[/red]")
-
-            if strict:
-                console.print("\n[red]✗ Validation failed (--strict mode)[/red]")
-                sys.exit(1)
+    with profiler.stage("render", str(input_path)) if profiler else nullcontext():
+        if commit:
+            with git_tree_at_commit(repo_path, commit) as commit_hash:
+                do_render(commit_hash)
         else:
-            console.print("[green]✓ All changes documented[/green]")
+            do_render(None)
 
     # Finalize fixture collection
     collector = get_fixture_collector()
@@ -266,19 +392,199 @@ def render(
             console.print("[green]No errors to collect[/green]")
         set_fixture_collector(None)
 
+    set_symbol_resolver(None)
+    symbol_index = get_symbol_index()
+    if symbol_index:
+        symbol_index.close()
+        set_symbol_index(None)
+
+    render_cache = get_render_cache()
+    if render_cache:
+        console.print(f"[dim]Render cache: {render_cache.hits} hit(s), {render_cache.misses} miss(es)[/dim]")
+        set_render_cache(None)
+
+    if profiler:
+        set_profiler(None)
+        _report_profile(profiler)
+        if profile_trace:
+            profiler.write_trace(profile_trace)
+            console.print(f"[green]✓[/green] Trace written to {profile_trace}")
+
+
+def _report_profile(profiler: Profiler) -> None:
+    """Print the breakdown of a profiled render (--profile)."""
+    from rich.table import Table
+
+    summary = profiler.summary()
+
+    table = Table(title="Render profile (ms; self excludes nested stages)")
+    table.add_column("Stage", style="cyan")
+    for column in ("count", "total", "self"):
+        table.add_column(column, justify="right")
+    for category, totals in summary["stages"].items():
+        table.add_row(category, str(totals["count"]), f"{totals['total_ms']:.1f}", f"{totals['self_ms']:.1f}")
+    console.print(table)
+
+    if summary["snippets"]:
+        snippets = Table(title="Slowest snippets")
+        snippets.add_column("ms", justify="right")
+        snippets.add_column("code()", style="cyan")
+        snippets.add_column("Template")
+        for snippet in summary["snippets"]:
+            snippets.add_row(f"{snippet['ms']:.1f}", snippet["name"], snippet["template"] or "")
+        console.print(snippets)
+
+    parses = summary["parses"]
+    if parses:
+        console.print(f"Parses: {sum(parses.values())} of {len(parses)} file(s)")
+        for name, count in list(parses.items())[:10]:
+            console.print(f"  {count:4}  {name}")
+
+    counters = summary["counters"]
+    for label, prefix in (("Parse cache", "parse cache"), ("Render cache", "render cache")):
+        hits, misses = counters.get(f"{prefix} hits", 0), counters.get(f"{prefix} misses", 0)
+        if hits + misses:
+            console.print(f"{label}: {hits} hit(s), {misses} miss(es) ({hits / (hits + misses):.0%} hit rate)")
+    for key in sorted({name.rsplit(" ", 1)[0] for name in counters if name.endswith(" builds")}):
+        shared = counters.get(f"{key} shared", 0)
+        console.print(
+            f"{key}: {counters.get(f'{key} builds', 0)} built, {counters.get(f'{key} hits', 0)} reused"
+            + (f", {shared} from other workers" if shared else "")
+        )
+
+    git = summary["git"]
+    commands = ", ".join(f"{name} {n}" for name, n in sorted(git["commands"].items(), key=lambda item: -item[1]))
+    detail = f" ({commands})" if commands else ""
+    console.print(f"Git: {git['processes']} process(es), {git['total_ms']:.1f} ms{detail}")
+
+
+def _report_validation(changes_set: Optional[ChangesSet], repo_path: Path, strict: bool = False):
+    """Report changed regions no template covered (--validate-changes)."""
+    if changes_set is None:
+        return
+
+    uncovered = changes_set.uncovered()
+    coverage = {file_coverage.file_path: file_coverage for file_coverage in changes_set.coverage()}
+    changed = sum(c.changed_lines for c in coverage.values())
+    covered = sum(c.covered_lines for c in coverage.values())
+    summary = f"{covered}/{changed} changed lines in {len(coverage)} files documented"
+    if uncovered:
+        console.print(f"\n[yellow]⚠ {len(uncovered)} uncovered regions ({summary}):[/yellow]")
+        # Group by file
+        by_file = defaultdict(list)
+        for region in uncovered:
+            by_file[region.file_path].append((region.start_line, region.end_line))
+
+        for abs_path, ranges in by_file.items():
+            try:
+                rel_path = abs_path.relative_to(repo_path)
+            except ValueError:
+                rel_path = abs_path
+            file_coverage = coverage.get(abs_path)
+            detail = f" ({file_coverage.percent:.0f}% covered)" if file_coverage else ""
+            console.print(f"\n[cyan]━━━ {rel_path}{detail} ━━━[/cyan]")
+
+            # Read file once, decode only the ranges shown
+            try:
+                cache = get_parse_cache()
+                data = cache.read(abs_path)
+                offsets = cache.line_offsets(data)
+                # A final newline does not start another line
+                line_count = len(offsets) - (1 if len(offsets) > 1 and offsets[-1] == len(data) else 0)
+                for start, end in ranges:
+                    console.print(f"[dim]{start}-{end}:[/dim]")
+                    end = min(end, line_count)
+                    if start > end:
+                        continue
+                    for i, line in enumerate(cache.lines(data, start, end).split("\n"), start):
+                        console.print(f"  [dim]{i:4}[/dim] {line}")
+            except Exception as e:
+                console.print(f"  [red]Could not read file: {e}[/red]")
+
+        if strict:
+            console.print("\n[red]✗ Validation failed (--strict mode)[/red]")
+            sys.exit(1)
+    else:
+        console.print(f"[green]✓ All changes documented ({summary})[/green]")
+
+
+def _watch(input_path, output_path, repo_path, input_is_dir, output_to_stdout, remap_dirty_lines=False):
+    """Render, then keep re-rendering templates affected by file changes."""
+    if input_is_dir:
+        template_dir = input_path
+        targets = []
+        for template_path in sorted(input_path.glob("**/*.j2")):
+            rel_path = template_path.relative_to(input_path)
+            targets.append((str(rel_path), output_path / rel_path.with_suffix("")))
+    else:
+        template_dir = input_path.parent
+        targets = [(input_path.name, None if output_to_stdout else output_path)]
+
+    renderer = TemplateRenderer(template_dir=template_dir, repo_path=repo_path, remap_dirty_lines=remap_dirty_lines)
+    TemplateWatcher(renderer, targets).run()
 
-def _render_stdin(output_file, repo_path, output_to_stdout, remap_dirty_lines=False, changes_set=None):
+
+def _write_chunks(chunks: Iterable[str], output_file: Path) -> None:
+    """
+    Write rendered chunks to a file as they are produced.
+
+    Output goes to a sibling .partial file that replaces output_file once rendering
+    succeeded, so a failed render never leaves a truncated document behind.
+    """
+    output_file.parent.mkdir(parents=True, exist_ok=True)
+    partial = output_file.with_name(output_file.name + ".partial")
+    try:
+        with open(partial, "w") as out:
+            for chunk in chunks:
+                out.write(chunk)
+        os.replace(partial, output_file)
+    except BaseException:
+        partial.unlink(missing_ok=True)
+        raise
+
+
+def _echo_chunks(chunks: Iterable[str]) -> None:
+    """Write rendered chunks to stdout as they are produced (same output as click.echo of the whole text)."""
+    out = click.get_text_stream("stdout")
+    for chunk in chunks:
+        out.write(chunk)
+    out.write("\n")
+    out.flush()
+
+
+def _render_stdin(
+    output_file,
+    repo_path,
+    output_to_stdout,
+    remap_dirty_lines=False,
+    changes_set=None,
+    commit=None,
+    stream=False,
+    resolve_workers=1,
+):
     """Render template from stdin."""
     # Read template from stdin
     template_content = sys.stdin.read()
 
     # Use current directory as template directory for relative paths
     renderer = TemplateRenderer(
-        template_dir=Path.cwd(), repo_path=repo_path, remap_dirty_lines=remap_dirty_lines, changes_set=changes_set
+        template_dir=Path.cwd(),
+        repo_path=repo_path,
+        remap_dirty_lines=remap_dirty_lines,
+        changes_set=changes_set,
+        commit=commit,
+        resolve_workers=resolve_workers,
     )
 
     # Render the template directly from string
-    rendered = renderer.env.from_string(template_content).render()
+    if stream:
+        if output_to_stdout:
+            _echo_chunks(renderer.stream_string(template_content))
+        else:
+            _write_chunks(renderer.stream_string(template_content), output_file)
+            console.print(f"[green]✓[/green] stdin → {output_file}")
+        return
+    rendered = renderer.render_string(template_content)
 
     if output_to_stdout:
         # Output to stdout
@@ -290,7 +596,17 @@ def _render_stdin(output_file, repo_path, output_to_stdout, remap_dirty_lines=Fa
         console.print(f"[green]✓[/green] stdin → {output_file}")
 
 
-def _render_file(input_file, output_file, repo_path, output_to_stdout, remap_dirty_lines=False, changes_set=None):
+def _render_file(
+    input_file,
+    output_file,
+    repo_path,
+    output_to_stdout,
+    remap_dirty_lines=False,
+    changes_set=None,
+    commit=None,
+    stream=False,
+    resolve_workers=1,
+):
     """Render a single template file."""
     # Determine template directory
     template_dir = input_file.parent
@@ -298,10 +614,24 @@ def _render_file(input_file, output_file, repo_path, output_to_stdout, remap_dir
 
     # Create renderer
     renderer = TemplateRenderer(
-        template_dir=template_dir, repo_path=repo_path, remap_dirty_lines=remap_dirty_lines, changes_set=changes_set
+        template_dir=template_dir,
+        repo_path=repo_path,
+        remap_dirty_lines=remap_dirty_lines,
+        changes_set=changes_set,
+        commit=commit,
+        resolve_workers=resolve_workers,
     )
 
     try:
+        if stream:
+            chunks = renderer.stream_template(template_name)
+            if output_to_stdout:
+                _echo_chunks(chunks)
+            else:
+                _write_chunks(chunks, output_file)
+                console.print(f"[green]✓[/green] {input_file} → {output_file}")
+            return
+
         rendered = renderer.render_template(template_name)
 
         if output_to_stdout:
@@ -318,44 +648,280 @@ def _render_file(input_file, output_file, repo_path, output_to_stdout, remap_dir
         sys.exit(1)
 
 
-def _render_directory(input_dir, output_dir, repo_path, remap_dirty_lines=False, changes_set=None):
-    """Render all templates in a directory."""
+class _RecordingCollector(FixtureCollector):
+    """Fixture collector for worker processes: records errors for the parent to replay."""
+
+    def __init__(self):
+        super().__init__(Path())
+        self.records: List[Tuple[Path, str, Optional[str]]] = []
+
+    def collect(self, source_file: Path, error: str, template_context: str = None):
+        self.records.append((source_file, error, template_context))
+
+
+def _render_shard(
+    template_dir,
+    repo_path,
+    remap_dirty_lines,
+    changes_set,
+    collect_fixtures,
+    index_path,
+    include_roots,
+    cache_dir,
+    commit,
+    resolve_workers,
+    shared_dir,
+    profile,
+    memory_budget,
+    names,
+):
+    """
+    Render a shard of templates in a worker process.
+
+    Returns:
+        Tuple of ([(template name, rendered text or None, error or None, manifest entry or None)],
+        remaining ChangesSet or None, [fixture collector records], (render cache hits, misses),
+        exported profile or None)
+    """
+    # Never share the parent's database connection or collector across processes
+    set_symbol_index(SymbolIndex(index_path) if index_path else None)
+    if include_roots is not None:
+        set_symbol_resolver(SymbolResolver(include_roots, index_path or default_index_path(repo_path)))
+    render_cache = RenderCache(cache_dir) if cache_dir else None
+    set_render_cache(render_cache)
+    collector = _RecordingCollector() if collect_fixtures else None
+    set_fixture_collector(collector)
+    # Nor the parent's cat-file pipe
+    source = GitTreeSource(repo_path, commit) if commit else None
+    get_parse_cache().set_source(source)
+    # Analysis of a file is shared with the other workers of this render
+    get_parse_cache().set_shared(SharedAnalysis(shared_dir))
+    profiler = Profiler() if profile else None
+    set_profiler(profiler)
+    get_parse_cache().set_memory_budget(memory_budget)
+
+    renderer = TemplateRenderer(
+        template_dir=template_dir,
+        repo_path=repo_path,
+        remap_dirty_lines=remap_dirty_lines,
+        changes_set=changes_set,
+        commit=commit,
+        resolve_workers=resolve_workers,
+    )
+    results = []
+    try:
+        for name in names:
+            try:
+                rendered = renderer.render_template(name)
+                results.append((name, rendered, None, build_entry(renderer, name)))
+            except Exception as e:
+                results.append((name, None, str(e), None))
+    finally:
+        set_profiler(None)
+        get_parse_cache().set_shared(None)
+        if source:
+            get_parse_cache().set_source(None)
+            source.close()
+
+    cache_stats = (render_cache.hits, render_cache.misses) if render_cache else (0, 0)
+    profile_data = profiler.export() if profiler else None
+    return results, changes_set, collector.records if collector else [], cache_stats, profile_data
+
+
+def _render_parallel(
+    input_dir, templates, repo_path, remap_dirty_lines, changes_set, jobs, commit=None, resolve_workers=1
+):
+    """
+    Render templates across a process pool.
+
+    Templates are split into contiguous shards (neighbouring templates tend to share
+    sources, which then share a worker's parse cache). Symbol tables, marker tables
+    and line offsets are also shared between workers through a SharedAnalysis
+    directory, so a header used by every shard is analysed once, not once per worker.
+    Results, coverage, collected fixtures and profiles are merged in template order,
+    so output matches a serial render.
+
+    Returns:
+        List of (template name, rendered text or None, error or None, manifest entry or None)
+        in template order
+    """
+    names = [str(template_path.relative_to(input_dir)) for template_path in templates]
+    # A few shards per worker keeps the pool busy when templates differ in cost
+    shard_size = max(1, -(-len(names) // (jobs * 4)))
+    shards = [names[i : i + shard_size] for i in range(0, len(names), shard_size)]
+
+    collector = get_fixture_collector()
+    resolver = get_symbol_resolver()
+    if resolver is not None:
+        # Build once here rather than in every worker: workers then only stat files
+        # to confirm the index is current instead of each indexing the roots into the same database
+        resolver.wait()
+    include_roots = [str(root) for root in resolver.roots] if resolver else None
+    symbol_index = get_symbol_index()
+    index_path = str(symbol_index.path) if symbol_index else None
+    render_cache = get_render_cache()
+    cache_dir = str(render_cache.cache_dir) if render_cache else None
+    profiler = get_profiler()
+    # Each worker gets an equal share of the budget
+    budget = get_parse_cache().memory_budget
+    worker_budget = budget // jobs if budget is not None else None
+
+    results = []
+    with tempfile.TemporaryDirectory(prefix="projected-source-shared-") as shared_dir:
+        with ProcessPoolExecutor(max_workers=jobs) as pool:
+            futures = [
+                pool.submit(
+                    _render_shard,
+                    input_dir,
+                    repo_path,
+                    remap_dirty_lines,
+                    changes_set,
+                    collector is not None,
+                    index_path,
+                    include_roots,
+                    cache_dir,
+                    commit,
+                    resolve_workers,
+                    shared_dir,
+                    profiler is not None,
+                    worker_budget,
+                    shard,
+                )
+                for shard in shards
+            ]
+            for future in futures:
+                shard_results, shard_changes, fixture_records, (hits, misses), profile_data = future.result()
+                results.extend(shard_results)
+                if profiler is not None:
+                    profiler.merge(*profile_data)
+                if render_cache is not None:
+                    render_cache.hits += hits
+                    render_cache.misses += misses
+                if changes_set is not None:
+                    changes_set.intersection_update(shard_changes)
+                for source_file, error, template_context in fixture_records:
+                    collector.collect(source_file, error, template_context)
+
+    return results
+
+
+def _render_directory(
+    input_dir,
+    output_dir,
+    repo_path,
+    remap_dirty_lines=False,
+    changes_set=None,
+    jobs=1,
+    commit=None,
+    stream=False,
+    resolve_workers=1,
+    incremental=False,
+):
+    """
+    Render all templates in a directory.
+
+    Writes the render manifest (see render_manifest.py) next to the outputs. With
+    incremental, outputs the manifest shows to be up to date are not rendered again.
+    """
     templates = list(input_dir.glob("**/*.j2"))
 
     if not templates:
         console.print(f"[yellow]No .j2 templates found in {input_dir}[/yellow]")
         return
 
-    console.print(f"[bold]Processing {len(templates)} templates from {input_dir}[/bold]")
+    def output_name(template_path: Path) -> Path:
+        # Strip the .j2 extension
+        rel_path = template_path.relative_to(input_dir)
+        return rel_path.with_suffix("") if rel_path.suffix == ".j2" else rel_path
+
+    settings = {"remap_dirty_lines": remap_dirty_lines}
+    if incremental:
+        manifest = RenderManifest.load(output_dir, repo_path, settings)
+        head = []
+
+        def current_commit():
+            # Remote and commit permalinks would be rendered with now, looked up once
+            if not head:
+                github = GitHubIntegration(repo_path, commit=commit)
+                head.append([github.github_url, github.commit_hash])
+            return head[0]
+
+        stale = [
+            template_path
+            for template_path in templates
+            if not manifest.is_current(
+                output_name(template_path).as_posix(),
+                str(template_path.relative_to(input_dir)),
+                output_dir / output_name(template_path),
+                find_custom_tags_file(template_path.parent, repo_path),
+                current_commit,
+            )
+        ]
+        console.print(f"[dim]{len(templates) - len(stale)} of {len(templates)} outputs up to date[/dim]")
+    else:
+        manifest = RenderManifest(output_dir, repo_path, settings)
+        stale = templates
+    keep = [output_name(template_path).as_posix() for template_path in templates]
 
-    # Create renderer
-    renderer = TemplateRenderer(
-        template_dir=input_dir, repo_path=repo_path, remap_dirty_lines=remap_dirty_lines, changes_set=changes_set
-    )
+    if not stale:
+        manifest.save(keep)
+        console.print("[green]Nothing to render[/green]")
+        return
+
+    if jobs == 0:
+        jobs = os.cpu_count() or 1
+    jobs = min(jobs, len(stale))
+
+    if jobs > 1:
+        console.print(f"[bold]Processing {len(stale)} templates from {input_dir} ({jobs} jobs)[/bold]")
+        rendered_results = iter(
+            _render_parallel(input_dir, stale, repo_path, remap_dirty_lines, changes_set, jobs, commit, resolve_workers)
+        )
+        renderer = None
+    else:
+        console.print(f"[bold]Processing {len(stale)} templates from {input_dir}[/bold]")
+        rendered_results = None
+        # Create renderer
+        renderer = TemplateRenderer(
+            template_dir=input_dir,
+            repo_path=repo_path,
+            remap_dirty_lines=remap_dirty_lines,
+            changes_set=changes_set,
+            commit=commit,
+            resolve_workers=resolve_workers,
+        )
 
     # Track results
     success_count = 0
     failed = []
 
     # Process each template
-    for template_path in templates:
+    for template_path in stale:
         rel_path = template_path.relative_to(input_dir)
-
-        # Determine output path (strip .j2 extension)
-        if rel_path.suffix == ".j2":
-            output_rel_path = rel_path.with_suffix("")
-        else:
-            output_rel_path = rel_path
-
+        output_rel_path = output_name(template_path)
         output_path_full = output_dir / output_rel_path
 
         try:
+            if stream:
+                _write_chunks(renderer.stream_template(str(rel_path)), output_path_full)
+                manifest.record(output_rel_path.as_posix(), build_entry(renderer, str(rel_path)), output_path_full)
+                console.print(f"  [green]✓[/green] {rel_path} → {output_rel_path}")
+                success_count += 1
+                continue
+
             # Render template
-            rendered = renderer.render_template(str(rel_path))
+            if renderer is not None:
+                rendered = renderer.render_template(str(rel_path))
+                entry = build_entry(renderer, str(rel_path))
+            else:
+                _, rendered, error, entry = next(rendered_results)
+                if error is not None:
+                    raise RuntimeError(error)
 
             # Write output
             output_path_full.parent.mkdir(parents=True, exist_ok=True)
             output_path_full.write_text(rendered)
+            manifest.record(output_rel_path.as_posix(), entry, output_path_full)
 
             console.print(f"  [green]✓[/green] {rel_path} → {output_rel_path}")
             success_count += 1
@@ -363,6 +929,9 @@ def _render_directory(input_dir, output_dir, repo_path, remap_dirty_lines=False,
         except Exception as e:
             console.print(f"  [red]✗[/red] {rel_path}: {e}")
             failed.append((rel_path, str(e)))
+            manifest.forget(output_rel_path.as_posix())
+
+    manifest.save(keep)
 
     # Summary
     console.print("\n[bold]Summary:[/bold]")
@@ -0,0 +1,413 @@
+"""
+Serve command - answer extraction and render requests from one long-lived process.
+
+One renderer, the parse cache (trees, symbol and marker tables), the symbol index and
+git metadata stay warm for the whole session, so a request only pays for the lookup
+itself. Requests are JSON-RPC 2.0 messages, one per line, over stdio or a Unix socket.
+Besides its own methods the server speaks enough of the Model Context Protocol
+(initialize, tools/list, tools/call) to be registered as an MCP server.
+
+A poller thread watches the files read so far and git's HEAD and index. On a change,
+cached git state is dropped and the symbol index is refreshed before the next
+path-less lookup; changed sources themselves are re-read and incrementally re-parsed
+by the parse cache.
+"""
+
+import json
+import logging
+import socketserver
+import subprocess
+import sys
+import threading
+import time
+from pathlib import Path
+from typing import Any, Callable, Dict, Iterable, Optional, Set
+
+import click
+
+from .. import __version__, setup_logging
+from ..core.parse_cache import get_parse_cache
+from ..core.render_cache import RenderCache, set_render_cache
+from ..core.renderer import TemplateRenderer
+from ..core.symbol_index import SymbolIndex, default_index_path, get_symbol_index, set_symbol_index
+from ..core.symbol_resolver import SymbolResolver, set_symbol_resolver
+from .extract import snippet_arguments
+from .watch import _mtime
+
+logger = logging.getLogger(__name__)
+
+# JSON-RPC 2.0 error codes
+PARSE_ERROR = -32700
+INVALID_REQUEST = -32600
+METHOD_NOT_FOUND = -32601
+INVALID_PARAMS = -32602
+SERVER_ERROR = -32000
+
+# MCP tool descriptions (tools/list)
+TOOLS = [
+    {
+        "name": "extract",
+        "description": "Extract a code snippet (function, struct, var, marker, lines, macro or proto definition) "
+        "with its line range and GitHub permalink. Omit file to look a C/C++ symbol up in the index.",
+        "inputSchema": {
+            "type": "object",
+            "properties": {
+                "file": {"type": "string", "description": "Path relative to the repository root"},
+                "function": {"type": "string"},
+                "struct": {"type": "string"},
+                "var": {"type": "string"},
+                "marker": {"type": "string"},
+                "macro_definition": {"type": "string"},
+                "function_macro": {"type": ["string", "object"]},
+                "signature": {"type": "string", "description": "Parameter type text selecting an overload"},
+                "lines": {"type": "array", "items": {"type": "integer"}, "minItems": 2, "maxItems": 2},
+                "message": {"type": "string"},
+                "enum": {"type": "string"},
+                "service": {"type": "string"},
+                "rpc": {"type": "string", "description": "Rpc name, optionally Service.Method"},
+            },
+        },
+    },
+    {
+        "name": "render",
+        "description": "Render a Jinja2 template that uses code() to project source into markdown.",
+        "inputSchema": {
+            "type": "object",
+            "properties": {
+                "template": {"type": "string", "description": "Template source text"},
+                "path": {"type": "string", "description": "Template file under the server's template directory"},
+            },
+        },
+    },
+]
+
+
+class RpcError(Exception):
+    """Error answered with a JSON-RPC error code."""
+
+    def __init__(self, code: int, message: str):
+        super().__init__(message)
+        self.code = code
+
+
+class SnippetServer:
+    """JSON-RPC methods over one warm renderer; requests are handled one at a time."""
+
+    def __init__(self, renderer: TemplateRenderer, resolver: Optional[SymbolResolver] = None):
+        """
+        Args:
+            renderer: Renderer kept for the whole session
+            resolver: Symbol resolver used by path-less extractions, refreshed on changes
+        """
+        self.renderer = renderer
+        self.resolver = resolver
+        self.requests = 0
+        self.started = time.monotonic()
+        self.stopping = threading.Event()
+        self._lock = threading.Lock()
+        self.methods: Dict[str, Callable[[Any], Any]] = {
+            "extract": self.extract,
+            "render": self.render,
+            "status": self.status,
+            "invalidate": self.invalidate,
+            "shutdown": self.shutdown,
+            "ping": lambda params: {},
+            "initialize": self.initialize,
+            "tools/list": lambda params: {"tools": TOOLS},
+            "tools/call": self.call_tool,
+        }
+
+    def extract(self, params: Any) -> Dict[str, Any]:
+        """Same request and result as one line of the extract command."""
+        if not isinstance(params, dict):
+            raise RpcError(INVALID_PARAMS, "extract takes an object of code() arguments")
+        file_path, arguments = snippet_arguments(params)
+        return self.renderer.extract_snippet(file_path, **arguments)
+
+    def render(self, params: Any) -> Dict[str, str]:
+        """Render template source text ("template") or a template file ("path")."""
+        if isinstance(params, dict) and "template" in params:
+            return {"text": self.renderer.render_string(params["template"])}
+        if isinstance(params, dict) and "path" in params:
+            return {"text": self.renderer.render_template(params["path"])}
+        raise RpcError(INVALID_PARAMS, "render needs 'template' (source text) or 'path' (under the template directory)")
+
+    def status(self, params: Any) -> Dict[str, Any]:
+        """Session statistics."""
+        cache = get_parse_cache()
+        return {
+            "version": __version__,
+            "uptime_s": round(time.monotonic() - self.started, 1),
+            "requests": self.requests,
+            "files": len(cache.cached_paths()),
+            "parse_hits": cache.hits,
+            "parse_misses": cache.misses,
+            "incremental_parses": cache.incremental,
+            "memory_used_mb": round(cache.memory_used / (1024 * 1024), 1),
+            "memory_peak_mb": round(cache.memory_peak / (1024 * 1024), 1),
+            "evictions": cache.evictions,
+        }
+
+    def invalidate(self, params: Any = None) -> Dict[str, Any]:
+        """Forget cached git state and refresh the symbol index on its next use (the poller does this on changes)."""
+        self.renderer.github.invalidate()
+        if self.resolver is not None:
+            self.resolver.refresh()
+        return {}
+
+    def shutdown(self, params: Any) -> Dict[str, Any]:
+        """Stop serving once this request is answered."""
+        self.stopping.set()
+        return {}
+
+    def initialize(self, params: Any) -> Dict[str, Any]:
+        """MCP handshake."""
+        requested = params.get("protocolVersion") if isinstance(params, dict) else None
+        return {
+            "protocolVersion": requested or "2024-11-05",
+            "capabilities": {"tools": {}},
+            "serverInfo": {"name": "projected-source", "version": __version__},
+        }
+
+    def call_tool(self, params: Any) -> Dict[str, Any]:
+        """MCP tools/call: extraction failures are tool results with isError, not protocol errors."""
+        name = params.get("name") if isinstance(params, dict) else None
+        if name not in ("extract", "render"):
+            raise RpcError(INVALID_PARAMS, f"Unknown tool: {name}")
+        try:
+            result = self.methods[name](params.get("arguments") or {})
+        except Exception as e:
+            return {"content": [{"type": "text", "text": str(e)}], "isError": True}
+        text = result["text"] if name == "render" else json.dumps(result)
+        return {"content": [{"type": "text", "text": text}], "isError": False}
+
+    def handle(self, message: Any) -> Optional[Dict[str, Any]]:
+        """
+        Answer one JSON-RPC request.
+
+        Returns:
+            Response object, or None for notifications (requests without an id)
+        """
+        if not isinstance(message, dict) or not isinstance(message.get("method"), str):
+            request_id = message.get("id") if isinstance(message, dict) else None
+            return _error(request_id, INVALID_REQUEST, "Invalid request")
+
+        notification = "id" not in message
+        request_id = message.get("id")
+        method = self.methods.get(message["method"])
+        if method is None:
+            unknown = _error(request_id, METHOD_NOT_FOUND, f"Unknown method: {message['method']}")
+            return None if notification else unknown
+
+        try:
+            with self._lock:
+                self.requests += 1
+                result = method(message.get("params") or {})
+        except RpcError as e:
+            return None if notification else _error(request_id, e.code, str(e))
+        except Exception as e:
+            logger.debug(f"{message['method']} failed: {e}")
+            return None if notification else _error(request_id, SERVER_ERROR, str(e))
+        return None if notification else {"jsonrpc": "2.0", "id": request_id, "result": result}
+
+    def handle_line(self, line: str) -> Optional[str]:
+        """Answer one line: a request or a batch (JSON array) of requests."""
+        try:
+            message = json.loads(line)
+        except json.JSONDecodeError as e:
+            return json.dumps(_error(None, PARSE_ERROR, f"Parse error: {e}"))
+
+        if isinstance(message, list):
+            if not message:
+                return json.dumps(_error(None, INVALID_REQUEST, "Empty batch"))
+            responses = [response for response in map(self.handle, message) if response is not None]
+            return json.dumps(responses) if responses else None
+        response = self.handle(message)
+        return json.dumps(response) if response is not None else None
+
+    def serve_lines(self, lines: Iterable[str], write: Callable[[str], None]) -> None:
+        """Answer line-delimited requests until the input ends or shutdown is requested."""
+        for line in lines:
+            if line.strip():
+                response = self.handle_line(line)
+                if response is not None:
+                    write(response + "\n")
+            if self.stopping.is_set():
+                break
+
+
+def _error(request_id: Any, code: int, message: str) -> Dict[str, Any]:
+    return {"jsonrpc": "2.0", "id": request_id, "error": {"code": code, "message": message}}
+
+
+def _git_dir(repo_path: Path) -> Optional[Path]:
+    try:
+        output = subprocess.check_output(
+            ["git", "rev-parse", "--absolute-git-dir"], cwd=repo_path, stderr=subprocess.DEVNULL
+        )
+    except (OSError, subprocess.CalledProcessError):
+        return None
+    return Path(output.decode().strip())
+
+
+class ChangePoller(threading.Thread):
+    """Invalidate the server's git state and symbol index when watched files change."""
+
+    def __init__(self, server: SnippetServer, git_dir: Optional[Path], interval: float):
+        super().__init__(name="change-poller", daemon=True)
+        self.server = server
+        self.git_files = [git_dir / "HEAD", git_dir / "index"] if git_dir else []
+        self.interval = interval
+        self._mtimes: Dict[Path, Optional[int]] = {}
+
+    def _watched(self) -> Set[Path]:
+        return set(get_parse_cache().cached_paths()).union(self.git_files)
+
+    def poll(self) -> bool:
+        """Record mtimes; True if a file seen before has changed."""
+        changed = False
+        for path in self._watched():
+            mtime = _mtime(path)
+            if path in self._mtimes and self._mtimes[path] != mtime:
+                changed = True
+            self._mtimes[path] = mtime
+        return changed
+
+    def run(self) -> None:
+        while not self.server.stopping.wait(self.interval):
+            if self.poll():
+                logger.info("Repository changed; dropping cached git state")
+                with self.server._lock:
+                    self.server.invalidate()
+
+
+def _serve_stdio(server: SnippetServer) -> None:
+    def write(text: str) -> None:
+        sys.stdout.write(text)
+        sys.stdout.flush()
+
+    server.serve_lines(sys.stdin, write)
+
+
+def _serve_socket(server: SnippetServer, socket_path: Path) -> None:
+    class Handler(socketserver.StreamRequestHandler):
+        def handle(self):
+            def write(text: str) -> None:
+                self.wfile.write(text.encode("utf8"))
+                self.wfile.flush()
+
+            server.serve_lines((line.decode("utf8", errors="replace") for line in self.rfile), write)
+
+    if socket_path.is_socket():
+        # Left behind by an earlier server
+        socket_path.unlink()
+    elif socket_path.exists() or socket_path.is_symlink():
+        raise click.ClickException(f"{socket_path} exists and is not a socket; refusing to replace it")
+    with socketserver.ThreadingUnixStreamServer(str(socket_path), Handler) as unix_server:
+        unix_server.daemon_threads = True
+        threading.Thread(target=lambda: (server.stopping.wait(), unix_server.shutdown()), daemon=True).start()
+        click.echo(f"Serving on {socket_path}", err=True)
+        try:
+            unix_server.serve_forever()
+        finally:
+            socket_path.unlink(missing_ok=True)
+
+
+@click.command("serve")
+@click.option(
+    "--repo-path", "-r", type=click.Path(exists=True, path_type=Path), default=Path.cwd(), help="Repository root path"
+)
+@click.option(
+    "--template-dir",
+    type=click.Path(exists=True, file_okay=False, path_type=Path),
+    default=None,
+    help="Where render requests with a 'path' find templates (default: current directory)",
+)
+@click.option(
+    "--socket",
+    "socket_path",
+    type=click.Path(path_type=Path),
+    default=None,
+    help="Listen on this Unix socket instead of stdin/stdout",
+)
+@click.option(
+    "--index-path",
+    type=click.Path(path_type=Path),
+    default=None,
+    help="Symbol index (default: <repo>/.projected-source/index.db)",
+)
+@click.option(
+    "--include-root",
+    "include_roots",
+    multiple=True,
+    type=click.Path(exists=True, path_type=Path),
+    help="Where extractions without a file look for symbols (repeatable; default: the repository)",
+)
+@click.option(
+    "--cache-dir",
+    type=click.Path(path_type=Path),
+    default=None,
+    help="Also keep extraction results on disk here (as in render)",
+)
+@click.option(
+    "--poll-interval", type=float, default=0.5, show_default=True, help="Seconds between change checks (0 = off)"
+)
+@click.option(
+    "--memory-budget",
+    type=float,
+    default=None,
+    metavar="MB",
+    help="Bound the estimated memory of cached sources, trees and tables, evicting least recently used files",
+)
+def serve(repo_path, template_dir, socket_path, index_path, include_roots, cache_dir, poll_interval, memory_budget):
+    """
+    Keep caches warm and answer requests as JSON-RPC 2.0, one message per line.
+
+    Methods: extract (params as one line of the extract command), render
+    ({"template": text} or {"path": name}), status, invalidate, shutdown, plus MCP's
+    initialize, tools/list and tools/call with "extract" and "render" tools.
+
+    Examples:
+        projected-source serve
+        projected-source serve --socket /tmp/projected-source.sock --include-root src
+
+        > {"jsonrpc": "2.0", "id": 1, "method": "extract", "params": {"file": "src/a.cpp", "function": "main"}}
+        < {"jsonrpc": "2.0", "id": 1, "result": {"file": "src/a.cpp", "start_line": 3, ...}}
+    """
+    if socket_path is None:
+        # stdout carries the protocol
+        setup_logging(logging.getLogger("projected_source").level, stderr=True)
+
+    if index_path is None and default_index_path(repo_path).exists():
+        index_path = default_index_path(repo_path)
+    if index_path is not None:
+        set_symbol_index(SymbolIndex(index_path))
+    resolver = SymbolResolver(include_roots or [repo_path], index_path or default_index_path(repo_path))
+    set_symbol_resolver(resolver)
+    # Index (or just re-stat) the roots while the client connects
+    resolver.start()
+    if cache_dir is not None:
+        set_render_cache(RenderCache(cache_dir))
+    if memory_budget is not None:
+        get_parse_cache().set_memory_budget(int(memory_budget * 1024 * 1024))
+
+    renderer = TemplateRenderer(template_dir=template_dir or Path.cwd(), repo_path=repo_path)
+    server = SnippetServer(renderer, resolver)
+    if poll_interval > 0:
+        ChangePoller(server, _git_dir(repo_path), poll_interval).start()
+
+    try:
+        if socket_path is None:
+            _serve_stdio(server)
+        else:
+            _serve_socket(server, socket_path)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        server.stopping.set()
+        set_symbol_resolver(None)
+        symbol_index = get_symbol_index()
+        if symbol_index:
+            symbol_index.close()
+            set_symbol_index(None)
+        set_render_cache(None)
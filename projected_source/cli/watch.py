@@ -0,0 +1,123 @@
+"""
+Watch mode - re-render templates when their sources change.
+
+One TemplateRenderer and the process-wide parse cache stay alive across renders.
+Changed source files are re-parsed incrementally by the parse cache, and only the
+templates whose code() calls read a changed file are rendered again. A change to
+any template (or to .projected-source.py) re-renders everything, since templates
+can include each other.
+"""
+
+import time
+from pathlib import Path
+from typing import Dict, Iterable, List, Optional, Set, Tuple
+
+import click
+
+from ..core.renderer import TemplateRenderer
+from .helpers import console
+
+# (template name relative to the template dir, output path or None for stdout)
+WatchTarget = Tuple[str, Optional[Path]]
+
+
+def _mtime(path: Path) -> Optional[int]:
+    try:
+        return path.stat().st_mtime_ns
+    except OSError:
+        return None
+
+
+class TemplateWatcher:
+    """Poll template and source mtimes and re-render dependent templates."""
+
+    def __init__(self, renderer: TemplateRenderer, targets: List[WatchTarget], interval: float = 0.1):
+        """
+        Args:
+            renderer: Long-lived renderer whose dependency tracking drives re-renders
+            targets: Templates to render and where to write them
+            interval: Polling interval in seconds
+        """
+        self.renderer = renderer
+        self.targets = targets
+        self.interval = interval
+        self._mtimes: Dict[Path, Optional[int]] = {}
+
+    def _template_files(self) -> Set[Path]:
+        template_dir = self.renderer.template_dir
+        files = {(template_dir / name).resolve() for name, _ in self.targets}
+        files.update(path.resolve() for path in template_dir.glob("**/*.j2"))
+        custom_tags = self.renderer._find_custom_tags_file(template_dir)
+        if custom_tags:
+            files.add(custom_tags.resolve())
+        return files
+
+    def _watched_files(self) -> Set[Path]:
+        files = self._template_files()
+        for deps in self.renderer.dependencies.values():
+            files.update(deps)
+        return files
+
+    def _snapshot(self, changed: Iterable[Path] = ()) -> None:
+        """Record mtimes of changed files and of files not watched yet."""
+        for path in changed:
+            self._mtimes[path] = _mtime(path)
+        for path in self._watched_files():
+            if path not in self._mtimes:
+                self._mtimes[path] = _mtime(path)
+
+    def changed_files(self) -> Set[Path]:
+        """Watched files whose mtime changed since the last snapshot."""
+        return {path for path, mtime in self._mtimes.items() if _mtime(path) != mtime}
+
+    def affected_targets(self, changed: Iterable[Path]) -> List[WatchTarget]:
+        """Targets to re-render for a set of changed files."""
+        changed = set(changed)
+        if changed & self._template_files():
+            return list(self.targets)
+        return [target for target in self.targets if self.renderer.dependencies.get(target[0], set()) & changed]
+
+    def render(self, targets: List[WatchTarget]) -> None:
+        """Render targets, reporting failures without stopping the watch loop."""
+        # HEAD or the working tree may have moved since the last render
+        self.renderer.github.invalidate()
+
+        for name, output_path in targets:
+            started = time.perf_counter()
+            try:
+                rendered = self.renderer.render_template(name)
+            except Exception as e:
+                console.print(f"  [red]✗[/red] {name}: {e}")
+                continue
+
+            elapsed_ms = (time.perf_counter() - started) * 1000
+            if output_path is None:
+                click.echo(rendered)
+            else:
+                output_path.parent.mkdir(parents=True, exist_ok=True)
+                output_path.write_text(rendered)
+                console.print(f"  [green]✓[/green] {name} → {output_path} [dim]({elapsed_ms:.0f} ms)[/dim]")
+
+    def run(self) -> None:
+        """Render everything once, then watch until interrupted."""
+        self.render(self.targets)
+        self._snapshot()
+        console.print(f"[cyan]Watching {len(self._mtimes)} file(s) for changes (Ctrl+C to stop)...[/cyan]")
+
+        try:
+            while True:
+                time.sleep(self.interval)
+                changed = self.changed_files()
+                if not changed:
+                    continue
+
+                # Record before rendering so saves made during the render are seen next time
+                self._snapshot(changed)
+                targets = self.affected_targets(changed)
+                names = ", ".join(sorted(path.name for path in changed))
+                console.print(f"[cyan]Changed: {names} → {len(targets)} template(s)[/cyan]")
+                self.render(targets)
+                # Templates may have picked up new dependencies
+                self._snapshot()
+        except KeyboardInterrupt:
+            console.print("\n[dim]Stopped watching[/dim]")
@@ -0,0 +1,435 @@
+"""
+Extraction benchmarks.
+
+Runs every extraction type against the example sources, the test fixtures and
+generated large files, and reports per-operation latency percentiles (cold: empty
+parse cache, so parse + symbol table + lookup; warm: cached trees and tables),
+raw parse throughput, peak RSS and cold CLI startup (fresh interpreters). Results
+are plain dicts that serialize to a JSON baseline; compare_baselines() diffs two of them.
+"""
+
+import logging
+import math
+import platform
+import subprocess
+import sys
+import time
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Callable, Dict, List, Optional, Tuple
+
+from .. import __version__
+from .parse_cache import ParseCache, get_parse_cache
+from .symbol_index import get_symbol_index, set_symbol_index
+
+logger = logging.getLogger(__name__)
+
+# Bump when the baseline layout changes
+BASELINE_VERSION = 1
+
+# Cold-start p50 budgets (ms) for each STARTUP_COMMANDS entry; generous enough for slow CI machines
+STARTUP_BUDGET_MS = {"import": 750.0, "render": 1500.0}
+
+
+@dataclass
+class BenchCase:
+    """One extraction to time."""
+
+    name: str
+    op: str  # key of OPERATIONS
+    file: str  # path relative to the corpus root
+    target: str
+    extra: Dict[str, str] = field(default_factory=dict)
+
+
+def _function(extractor, path, case):
+    return extractor.extract_function(path, case.target, case.extra.get("signature"))
+
+
+def _function_macro(extractor, path, case):
+    return extractor.extract_function_macro(path, {"name": case.target, **case.extra})
+
+
+# op -> callable(extractor, path, case)
+OPERATIONS: Dict[str, Callable] = {
+    "function": _function,
+    "overload": _function,
+    "struct": lambda extractor, path, case: extractor.extract_struct(path, case.target),
+    "var": lambda extractor, path, case: extractor.extract_struct(path, case.target),
+    "function_macro": _function_macro,
+    "macro_definition": lambda extractor, path, case: extractor.extract_macro_definition(path, case.target),
+    "marker": lambda extractor, path, case: extractor.extract_marker(path, case.target),
+    "function_marker": lambda extractor, path, case: extractor.extract_function_marker(
+        path, case.target, case.extra["marker"]
+    ),
+    "message": lambda extractor, path, case: extractor.extract_message(path, case.target),
+    "enum": lambda extractor, path, case: extractor.extract_enum(path, case.target),
+    "service": lambda extractor, path, case: extractor.extract_service(path, case.target),
+    "rpc": lambda extractor, path, case: extractor.extract_rpc(path, case.target),
+}
+
+# Cases over files shipped in the repository
+REPOSITORY_CASES = [
+    BenchCase(
+        "applyHook/function_macro",
+        "function_macro",
+        "examples/applyHook.cpp",
+        "DEFINE_JS_FUNCTION",
+        {"arg1": "state_set"},
+    ),
+    BenchCase("applyHook/var", "var", "examples/applyHook.cpp", "float_one_internal"),
+    BenchCase("macro.h/macro_definition", "macro_definition", "examples/macro.h", "CAT"),
+    BenchCase("complete/function", "function", "tests/fixtures/complete.cpp", "simpleFunction"),
+    BenchCase("complete/struct", "struct", "tests/fixtures/complete.cpp", "SimpleStruct"),
+    BenchCase("complete/marker", "marker", "tests/fixtures/complete.cpp", "example1"),
+    BenchCase(
+        "complete/function_marker",
+        "function_marker",
+        "tests/fixtures/complete.cpp",
+        "functionWithMarkers",
+        {"marker": "setup"},
+    ),
+    BenchCase(
+        "overloads/overload",
+        "overload",
+        "tests/fixtures/overloads.cpp",
+        "PeerImp::onMessage",
+        {"signature": "TMGetLedger"},
+    ),
+    BenchCase("ripple.proto/message", "message", "tests/fixtures/ripple.proto", "TMManifest"),
+    BenchCase("ripple.proto/enum", "enum", "tests/fixtures/ripple.proto", "MessageType"),
+]
+
+
+def generate_cpp(functions: int) -> str:
+    """
+    A large synthetic C++ file: namespaced classes with methods, free functions
+    with markers, function-defining macro invocations and #defines.
+    """
+    out = ["#include <cstdint>", "", "#define DEFINE_JS_FUNCTION(ret, name, ...) ret name(__VA_ARGS__)", ""]
+    for i in range(functions):
+        if i % 50 == 0:
+            if i:
+                out.append("}  // namespace")
+            out.append(f"namespace gen{i // 50} {{")
+        out += [
+            f"#define GEN_LIMIT_{i} {i * 7}",
+            f"struct Record{i} {{",
+            f"    int field{i};",
+            f"    int method{i}(int x) const {{ return x + field{i}; }}",
+            "};",
+            f"int compute{i}(int a, int b) {{",
+            f"    //@@start body{i}",
+            f"    int total = a * {i} + b;",
+            "    for (int k = 0; k < b; ++k) total += k;",
+            f"    //@@end body{i}",
+            "    return total;",
+            "}",
+            f"DEFINE_JS_FUNCTION(int64_t, hook{i}, int64_t value) {{",
+            f"    return value + GEN_LIMIT_{i};",
+            "}",
+            "",
+        ]
+    out.append("}  // namespace")
+    return "\n".join(out) + "\n"
+
+
+def generate_proto(messages: int) -> str:
+    """A large synthetic .proto file with messages, enums and services."""
+    out = ['syntax = "proto2";', "package gen;", ""]
+    for i in range(messages):
+        out += [
+            f"enum Kind{i}",
+            "{",
+            f"    k{i}_a = 0;",
+            f"    k{i}_b = 1;",
+            "}",
+            f"message Message{i}",
+            "{",
+            "    required uint32 id = 1;",
+            f"    optional Kind{i} kind = 2;",
+            "    repeated bytes payload = 3;",
+            "}",
+            f"service Service{i}",
+            "{",
+            f"    rpc Call{i} (Message{i}) returns (Message{i});",
+            "}",
+            "",
+        ]
+    return "\n".join(out) + "\n"
+
+
+def synthetic_cases(directory: Path, size: int) -> List[BenchCase]:
+    """Write generated sources into directory and return cases for their last (worst-case) symbols."""
+    directory.mkdir(parents=True, exist_ok=True)
+    (directory / "generated.cpp").write_text(generate_cpp(size))
+    (directory / "generated.proto").write_text(generate_proto(max(1, size // 4)))
+    last, last_proto = size - 1, max(1, size // 4) - 1
+
+    return [
+        BenchCase("generated/function", "function", "generated.cpp", f"gen{last // 50}::compute{last}"),
+        BenchCase("generated/method", "function", "generated.cpp", f"Record{last}::method{last}"),
+        BenchCase("generated/struct", "struct", "generated.cpp", f"Record{last}"),
+        BenchCase(
+            "generated/function_macro", "function_macro", "generated.cpp", "DEFINE_JS_FUNCTION", {"arg1": f"hook{last}"}
+        ),
+        BenchCase("generated/macro_definition", "macro_definition", "generated.cpp", f"GEN_LIMIT_{last}"),
+        BenchCase("generated/marker", "marker", "generated.cpp", f"body{last}"),
+        BenchCase(
+            "generated/function_marker", "function_marker", "generated.cpp", f"compute{last}", {"marker": f"body{last}"}
+        ),
+        BenchCase("generated/message", "message", "generated.proto", f"Message{last_proto}"),
+        BenchCase("generated/enum", "enum", "generated.proto", f"Kind{last_proto}"),
+        BenchCase("generated/service", "service", "generated.proto", f"Service{last_proto}"),
+        BenchCase("generated/rpc", "rpc", "generated.proto", f"Call{last_proto}"),
+    ]
+
+
+def percentile(samples: List[float], q: float) -> float:
+    """Nearest-rank percentile of a non-empty list."""
+    ordered = sorted(samples)
+    rank = max(0, min(len(ordered) - 1, math.ceil(q / 100 * len(ordered)) - 1))
+    return ordered[rank]
+
+
+def summarize(samples: List[float]) -> Dict[str, float]:
+    """Latency summary in milliseconds."""
+    ms = [s * 1000 for s in samples]
+    return {
+        "p50_ms": round(percentile(ms, 50), 4),
+        "p90_ms": round(percentile(ms, 90), 4),
+        "p99_ms": round(percentile(ms, 99), 4),
+        "mean_ms": round(sum(ms) / len(ms), 4),
+    }
+
+
+def peak_rss_mb() -> Optional[float]:
+    """Peak resident set size of this process, if the platform reports it."""
+    try:
+        import resource
+    except ImportError:
+        return None
+    peak = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    # Linux reports KiB, macOS bytes
+    return round(peak / (1024 * 1024) if sys.platform == "darwin" else peak / 1024, 1)
+
+
+def _commit(repo_path: Path) -> Optional[str]:
+    try:
+        return (
+            subprocess.check_output(["git", "rev-parse", "HEAD"], cwd=repo_path, stderr=subprocess.DEVNULL)
+            .decode()
+            .strip()
+        )
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def startup_commands(work_dir: Path) -> Dict[str, List[str]]:
+    """
+    Commands timed by measure_startup(), in fresh interpreters.
+
+    "import" loads the CLI; "render" renders one C++ snippet to stdout, the
+    typical editor/pre-commit invocation.
+    """
+    source = work_dir / "startup.cpp"
+    source.write_text("int answer() {\n    return 42;\n}\n")
+    template = work_dir / "startup.md.j2"
+    template.write_text("{{ code('startup.cpp', function='answer', github=False) }}\n")
+    return {
+        "import": [sys.executable, "-c", "import projected_source.cli"],
+        "render": [
+            sys.executable, "-m", "projected_source", "render", str(template), "-", "--repo-path", str(work_dir)
+        ],
+    }
+
+
+def measure_startup(work_dir: Path, iterations: int = 5) -> Dict[str, Dict]:
+    """
+    Time cold CLI invocations, each in a new Python process.
+
+    Args:
+        work_dir: Directory for the startup template and source
+        iterations: Processes per command
+
+    Returns:
+        Command name -> latency summary, or "error" if the command fails
+    """
+    results = {}
+    for name, command in startup_commands(work_dir).items():
+        samples = []
+        for _ in range(iterations):
+            started = time.perf_counter()
+            completed = subprocess.run(command, cwd=work_dir, capture_output=True)
+            samples.append(time.perf_counter() - started)
+            if completed.returncode != 0:
+                results[name] = {"error": completed.stderr.decode(errors="replace").strip()[-500:]}
+                break
+        else:
+            results[name] = {**summarize(samples), "budget_ms": STARTUP_BUDGET_MS.get(name)}
+    return results
+
+
+def over_budget(startup: Dict[str, Dict]) -> List[Tuple[str, float, float]]:
+    """(command, p50 ms, budget ms) for startup measurements over STARTUP_BUDGET_MS."""
+    return [
+        (name, result["p50_ms"], STARTUP_BUDGET_MS[name])
+        for name, result in startup.items()
+        if name in STARTUP_BUDGET_MS and "p50_ms" in result and result["p50_ms"] > STARTUP_BUDGET_MS[name]
+    ]
+
+
+def time_case(case: BenchCase, root: Path, iterations: int) -> Dict:
+    """
+    Time one case cold (fresh parse cache per run) and warm (shared cache).
+
+    Returns:
+        Dict with "cold" and "warm" summaries, or "error" if the extraction fails
+    """
+    from ..languages import get_extractor
+
+    path = root / case.file
+    extractor = get_extractor(path)
+    operation = OPERATIONS[case.op]
+    cache = get_parse_cache()
+
+    cold, warm = [], []
+    try:
+        for _ in range(iterations):
+            cache.clear()
+            started = time.perf_counter()
+            operation(extractor, path, case)
+            cold.append(time.perf_counter() - started)
+        for _ in range(iterations):
+            started = time.perf_counter()
+            operation(extractor, path, case)
+            warm.append(time.perf_counter() - started)
+    except Exception as e:
+        return {"error": f"{type(e).__name__}: {e}"}
+
+    return {"cold": summarize(cold), "warm": summarize(warm)}
+
+
+def parse_throughput(files: List[Path], iterations: int) -> Dict[str, Dict[str, float]]:
+    """Uncached tree-sitter parses per second and MB/s per file."""
+    from ..languages import get_extractor
+
+    results = {}
+    for path in files:
+        data = path.read_bytes()
+        language = get_extractor(path).language
+        elapsed = 0.0
+        for _ in range(iterations):
+            # A private cache forces a real parse every time
+            started = time.perf_counter()
+            ParseCache().parse(language, data)
+            elapsed += time.perf_counter() - started
+        results[path.name] = {
+            "bytes": len(data),
+            "parses_per_s": round(iterations / elapsed, 2),
+            "mb_per_s": round(len(data) * iterations / elapsed / 1e6, 2),
+        }
+    return results
+
+
+def run_benchmarks(
+    repo_path: Path,
+    work_dir: Path,
+    iterations: int = 20,
+    synthetic_size: int = 2000,
+    name_filter: Optional[str] = None,
+    progress: Optional[Callable[[str], None]] = None,
+    startup: bool = True,
+) -> Dict:
+    """
+    Run all benchmark cases.
+
+    Args:
+        repo_path: Checkout holding examples/ and tests/fixtures/
+        work_dir: Directory for generated sources
+        iterations: Runs per case (cold and warm each)
+        synthetic_size: Number of functions in the generated C++ file
+        name_filter: Only run cases whose name contains this substring
+        progress: Called with each case name before it runs
+        startup: Also time cold CLI startup (see measure_startup)
+
+    Returns:
+        Baseline dict (see BASELINE_VERSION)
+    """
+    cases = [(case, repo_path) for case in REPOSITORY_CASES if (repo_path / case.file).exists()]
+    cases += [(case, work_dir) for case in synthetic_cases(work_dir, synthetic_size)]
+    if name_filter:
+        cases = [(case, root) for case, root in cases if name_filter in case.name]
+
+    # Measure extraction itself, not index lookups
+    symbol_index = get_symbol_index()
+    set_symbol_index(None)
+    try:
+        results = {}
+        for case, root in cases:
+            if progress:
+                progress(case.name)
+            results[case.name] = {"op": case.op, "file": case.file, **time_case(case, root, iterations)}
+
+        parse_files = sorted({root / case.file for case, root in cases})
+        throughput = parse_throughput(parse_files, max(1, iterations // 4))
+
+        startup_results = {}
+        if startup:
+            if progress:
+                progress("startup")
+            startup_results = measure_startup(work_dir, max(3, iterations // 4))
+    finally:
+        set_symbol_index(symbol_index)
+        get_parse_cache().clear()
+
+    return {
+        "version": BASELINE_VERSION,
+        "tool_version": __version__,
+        "commit": _commit(repo_path),
+        "python": platform.python_version(),
+        "platform": platform.platform(),
+        "iterations": iterations,
+        "synthetic_size": synthetic_size,
+        "cases": results,
+        "parse": throughput,
+        "peak_rss_mb": peak_rss_mb(),
+        "startup": startup_results,
+    }
+
+
+def compare_baselines(baseline: Dict, current: Dict, threshold: float = 0.2) -> List[Tuple[str, str, float, float]]:
+    """
+    Compare two baselines case by case, plus cold startup (reported as "startup/<command>").
+
+    Args:
+        baseline: Earlier run
+        current: New run
+        threshold: Relative slowdown that counts as a regression (0.2 = 20%)
+
+    Returns:
+        List of (case name, "cold"/"warm", baseline p50 ms, current p50 ms) for regressions
+    """
+    if baseline.get("version") != current.get("version"):
+        logger.warning(f"Comparing baseline version {baseline.get('version')} with {current.get('version')}")
+
+    regressions = []
+    for name, result in current.get("cases", {}).items():
+        old = baseline.get("cases", {}).get(name)
+        if not old:
+            continue
+        for mode in ("cold", "warm"):
+            if mode not in result or mode not in old:
+                continue
+            before, after = old[mode]["p50_ms"], result[mode]["p50_ms"]
+            if before > 0 and after > before * (1 + threshold):
+                regressions.append((name, mode, before, after))
+
+    for name, result in current.get("startup", {}).items():
+        old = baseline.get("startup", {}).get(name, {})
+        if "p50_ms" not in result or "p50_ms" not in old:
+            continue
+        before, after = old["p50_ms"], result["p50_ms"]
+        if before > 0 and after > before * (1 + threshold):
+            regressions.append((f"startup/{name}", "cold", before, after))
+    return regressions
@@ -4,12 +4,125 @@ ChangesSet - Track and validate documentation coverage of code changes.
 Provides a set-like data structure for managing changed code regions,
 with support for merging overlapping regions and tracking which regions
 have been "claimed" by documentation.
+
+Each file's regions are kept as two parallel sorted arrays (starts, ends) of
+disjoint, non-adjacent intervals. add() and subtract() find the affected regions
+by bisection and splice them in place, so a claim costs O(log n) plus the regions
+it touches rather than a pass over every region of the file. Line totals are
+maintained alongside, so coverage per file never needs a scan.
 """
 
+import bisect
 import subprocess
 from dataclasses import dataclass
 from pathlib import Path
-from typing import Dict, List, Optional, Tuple
+from typing import Dict, Iterable, List, Optional, Tuple
+
+
+class _Intervals:
+    """Sorted, disjoint, non-adjacent inclusive line intervals of one file."""
+
+    __slots__ = ("starts", "ends", "lines")
+
+    def __init__(self):
+        self.starts: List[int] = []
+        self.ends: List[int] = []
+        # Total number of lines in the intervals
+        self.lines = 0
+
+    @classmethod
+    def from_sorted(cls, intervals: Iterable[Tuple[int, int]]) -> "_Intervals":
+        """Build from (start, end) pairs sorted by start, merging overlapping and adjacent ones."""
+        result = cls()
+        starts, ends = result.starts, result.ends
+        for start, end in intervals:
+            if ends and start <= ends[-1] + 1:
+                if end > ends[-1]:
+                    ends[-1] = end
+            else:
+                starts.append(start)
+                ends.append(end)
+        result.lines = sum(end - start + 1 for start, end in zip(starts, ends))
+        return result
+
+    def add(self, start: int, end: int) -> int:
+        """Insert [start, end], merging with what it overlaps or touches. Returns the lines added."""
+        # Regions ending at start - 1 or later and starting at end + 1 or earlier merge with the new one
+        first = bisect.bisect_left(self.ends, start - 1)
+        last = bisect.bisect_right(self.starts, end + 1)
+        merged = 0
+        if first < last:
+            merged = sum(self.ends[i] - self.starts[i] + 1 for i in range(first, last))
+            start = min(start, self.starts[first])
+            end = max(end, self.ends[last - 1])
+        self.starts[first:last] = [start]
+        self.ends[first:last] = [end]
+        added = (end - start + 1) - merged
+        self.lines += added
+        return added
+
+    def remove(self, start: int, end: int) -> int:
+        """Remove [start, end], shrinking or splitting what it overlaps. Returns the lines removed."""
+        # Regions ending at start or later and starting at end or earlier overlap
+        first = bisect.bisect_left(self.ends, start)
+        last = bisect.bisect_right(self.starts, end)
+        if first >= last:
+            return 0
+
+        removed = sum(min(self.ends[i], end) - max(self.starts[i], start) + 1 for i in range(first, last))
+        new_starts, new_ends = [], []
+        if self.starts[first] < start:
+            new_starts.append(self.starts[first])
+            new_ends.append(start - 1)
+        if self.ends[last - 1] > end:
+            new_starts.append(end + 1)
+            new_ends.append(self.ends[last - 1])
+        self.starts[first:last] = new_starts
+        self.ends[first:last] = new_ends
+        self.lines -= removed
+        return removed
+
+    def intersection(self, other: "_Intervals") -> "_Intervals":
+        """Intervals covered by both."""
+        result = _Intervals()
+        i = j = 0
+        while i < len(self.starts) and j < len(other.starts):
+            start = max(self.starts[i], other.starts[j])
+            end = min(self.ends[i], other.ends[j])
+            if start <= end:
+                result.starts.append(start)
+                result.ends.append(end)
+                result.lines += end - start + 1
+            # Advance whichever region ends first
+            if self.ends[i] < other.ends[j]:
+                i += 1
+            else:
+                j += 1
+        return result
+
+    def __iter__(self):
+        return zip(self.starts, self.ends)
+
+    def __len__(self) -> int:
+        return len(self.starts)
+
+
+@dataclass(frozen=True)
+class FileCoverage:
+    """Documentation coverage of one file's changed lines."""
+
+    file_path: Path
+    changed_lines: int
+    uncovered_lines: int
+
+    @property
+    def covered_lines(self) -> int:
+        return self.changed_lines - self.uncovered_lines
+
+    @property
+    def percent(self) -> float:
+        """Share of changed lines covered, 0-100."""
+        return 100.0 * self.covered_lines / self.changed_lines if self.changed_lines else 100.0
 
 
 @dataclass
@@ -34,27 +147,32 @@ class ChangesSet:
     """
 
     def __init__(self):
-        # Dict[Path, List[Tuple[start, end]]] - sorted, non-overlapping regions
-        self._regions: Dict[Path, List[Tuple[int, int]]] = {}
+        # Uncovered regions per file (files with none left are dropped)
+        self._regions: Dict[Path, _Intervals] = {}
+        # Lines ever added per file, for coverage reports
+        self._changed_lines: Dict[Path, int] = {}
 
     @classmethod
-    def from_diff(cls, base: Optional[str] = None, repo_path: Optional[Path] = None) -> "ChangesSet":
+    def from_diff(
+        cls, base: Optional[str] = None, repo_path: Optional[Path] = None, head: str = "HEAD"
+    ) -> "ChangesSet":
         """
         Build a ChangesSet from git diff against a base commit or range.
 
         Args:
             base: Base commit/branch, or a range like "HEAD~5..HEAD~2".
-                  If no ".." present, diffs against HEAD. Auto-detected if None.
+                  If no ".." present, diffs against head. Auto-detected if None.
             repo_path: Path to git repository. Uses cwd if None.
+            head: Commit the documentation is rendered at (default: HEAD)
 
         Returns:
             ChangesSet populated with all changed regions.
         """
         repo_path = repo_path or Path.cwd()
-        base = base or cls.detect_base(repo_path)
+        base = base or cls.detect_base(repo_path, head)
 
         # Support commit ranges (e.g., "HEAD~5..HEAD~2") or simple base (e.g., "HEAD~5")
-        diff_range = base if ".." in base else f"{base}..HEAD"
+        diff_range = base if ".." in base else f"{base}..{head}"
 
         changes = cls()
 
@@ -73,15 +191,15 @@ class ChangesSet:
         return changes
 
     @staticmethod
-    def detect_base(repo_path: Path) -> str:
+    def detect_base(repo_path: Path, head: str = "HEAD") -> str:
         """
         Auto-detect the base commit for diffing.
 
-        Tries merge-base with main, then master, falls back to HEAD~1.
+        Tries merge-base of head with main, then master, falls back to head~1.
         """
         # Try main
         result = subprocess.run(
-            ["git", "merge-base", "HEAD", "main"],
+            ["git", "merge-base", head, "main"],
             capture_output=True,
             cwd=repo_path,
             text=True,
@@ -91,7 +209,7 @@ class ChangesSet:
 
         # Try master
         result = subprocess.run(
-            ["git", "merge-base", "HEAD", "master"],
+            ["git", "merge-base", head, "master"],
             capture_output=True,
             cwd=repo_path,
             text=True,
@@ -100,18 +218,20 @@ class ChangesSet:
             return result.stdout.strip()
 
         # Fall back to parent commit
-        return "HEAD~1"
+        return f"{head}~1"
 
     def _parse_diff(self, diff_output: str, repo_path: Path) -> None:
         """Parse unified diff output and populate regions."""
-        current_file: Optional[Path] = None
+        # Changed lines are collected as runs per file and merged once per file at the end
+        runs: Dict[Path, List[Tuple[int, int]]] = {}
+        file_runs: Optional[List[Tuple[int, int]]] = None
         current_new_line = 0
 
         for line in diff_output.splitlines():
             # New file header: +++ b/path/to/file
             if line.startswith("+++ b/"):
                 file_path = line[6:]  # Strip "+++ b/"
-                current_file = repo_path / file_path
+                file_runs = runs.setdefault(repo_path / file_path, [])
 
             # Hunk header: @@ -old_start,old_count +new_start,new_count @@
             elif line.startswith("@@"):
@@ -126,22 +246,20 @@ class ChangesSet:
                         else:
                             current_new_line = int(new_range)
 
-            # Added or context line - track position
-            elif current_file and not line.startswith("-"):
-                if line.startswith("+") or line.startswith(" "):
-                    # This line exists in the new version
-                    if line.startswith("+"):
-                        # Added line - definitely needs coverage
-                        self.add(current_file, current_new_line, current_new_line)
-                    elif line.startswith(" "):
-                        # Context line around a change - also needs coverage
-                        # (user chose "all changed" which includes context)
-                        self.add(current_file, current_new_line, current_new_line)
-                    current_new_line += 1
-
-            # Deleted line - doesn't increment new line counter
-            elif line.startswith("-") and not line.startswith("---"):
-                pass  # Deletion - surrounding context already captured
+            # Added line (definitely needs coverage) or context line around a change
+            # (also needs coverage: "all changed" includes context) - exists in the new version
+            elif file_runs is not None and (line.startswith("+") or line.startswith(" ")):
+                if file_runs and file_runs[-1][1] == current_new_line - 1:
+                    file_runs[-1] = (file_runs[-1][0], current_new_line)
+                else:
+                    file_runs.append((current_new_line, current_new_line))
+                current_new_line += 1
+
+            # Deleted line - doesn't increment new line counter; surrounding context already captured
+
+        for file_path, file_runs in runs.items():
+            if file_runs:
+                self.add_many(file_path, file_runs)
 
     def add(self, file_path: Path, start: int, end: int) -> None:
         """
@@ -155,26 +273,31 @@ class ChangesSet:
         if start > end:
             start, end = end, start
 
-        regions = self._regions.setdefault(file_path, [])
+        regions = self._regions.get(file_path)
+        if regions is None:
+            regions = self._regions[file_path] = _Intervals()
+        added = regions.add(start, end)
+        self._changed_lines[file_path] = self._changed_lines.get(file_path, 0) + added
 
-        # Add new region and re-merge everything
-        regions.append((start, end))
-        self._regions[file_path] = self._merge_sorted(sorted(regions))
+    def add_many(self, file_path: Path, regions: Iterable[Tuple[int, int]]) -> None:
+        """
+        Add many regions of one file at once (one sort and merge instead of an insert per region).
 
-    def _merge_sorted(self, regions: List[Tuple[int, int]]) -> List[Tuple[int, int]]:
-        """Merge a sorted list of potentially overlapping regions."""
-        if not regions:
-            return []
-
-        result = [regions[0]]
-        for start, end in regions[1:]:
-            last_start, last_end = result[-1]
-            if start <= last_end + 1:
-                # Overlapping or adjacent - merge
-                result[-1] = (last_start, max(last_end, end))
-            else:
-                result.append((start, end))
-        return result
+        Args:
+            file_path: Path to the file
+            regions: (start, end) pairs in any order
+        """
+        normalized = sorted((min(start, end), max(start, end)) for start, end in regions)
+        existing = self._regions.get(file_path)
+        if existing is not None:
+            normalized = sorted(normalized + list(existing))
+        merged = _Intervals.from_sorted(normalized)
+        if not merged:
+            return
+
+        before = existing.lines if existing is not None else 0
+        self._regions[file_path] = merged
+        self._changed_lines[file_path] = self._changed_lines.get(file_path, 0) + merged.lines - before
 
     def subtract(self, file_path: Path, start: int, end: int) -> None:
         """
@@ -187,36 +310,32 @@ class ChangesSet:
             start: Start line (1-based, inclusive)
             end: End line (1-based, inclusive)
         """
-        if file_path not in self._regions:
+        regions = self._regions.get(file_path)
+        if regions is None:
             return
 
         if start > end:
             start, end = end, start
 
-        new_regions: List[Tuple[int, int]] = []
-
-        for reg_start, reg_end in self._regions[file_path]:
-            # No overlap - keep as is
-            if end < reg_start or start > reg_end:
-                new_regions.append((reg_start, reg_end))
+        regions.remove(start, end)
+        if not regions:
+            del self._regions[file_path]
 
-            # Full coverage - remove entirely
-            elif start <= reg_start and end >= reg_end:
-                pass  # Don't add it
+    def intersection_update(self, other: "ChangesSet") -> None:
+        """
+        Keep only regions that are also uncovered in other.
 
-            # Partial overlap - may need to split
+        Used to merge parallel renders: each worker subtracts its own coverage from a
+        copy of the same set, so the intersection of the copies equals subtracting
+        every claim from one set.
+        """
+        for file_path in list(self._regions):
+            other_regions = other._regions.get(file_path)
+            new_regions = self._regions[file_path].intersection(other_regions) if other_regions else None
+            if new_regions:
+                self._regions[file_path] = new_regions
             else:
-                # Left remainder
-                if reg_start < start:
-                    new_regions.append((reg_start, start - 1))
-                # Right remainder
-                if reg_end > end:
-                    new_regions.append((end + 1, reg_end))
-
-        if new_regions:
-            self._regions[file_path] = new_regions
-        else:
-            del self._regions[file_path]
+                del self._regions[file_path]
 
     def uncovered(self) -> List[ChangeRegion]:
         """Return list of regions not yet claimed by documentation."""
@@ -226,6 +345,22 @@ class ChangesSet:
                 result.append(ChangeRegion(file_path, start, end))
         return result
 
+    def is_covered(self, file_path: Path, line: int) -> bool:
+        """Return True if a line is not (or no longer) an uncovered change."""
+        regions = self._regions.get(file_path)
+        if regions is None:
+            return True
+        i = bisect.bisect_right(regions.starts, line) - 1
+        return i < 0 or regions.ends[i] < line
+
+    def coverage(self) -> List[FileCoverage]:
+        """Changed and uncovered line counts per file that had changes, sorted by path."""
+        result = []
+        for file_path, changed in sorted(self._changed_lines.items()):
+            regions = self._regions.get(file_path)
+            result.append(FileCoverage(file_path, changed, regions.lines if regions is not None else 0))
+        return result
+
     def is_complete(self) -> bool:
         """Return True if all regions have been claimed."""
         return len(self._regions) == 0
@@ -3,13 +3,15 @@ Tree-sitter based code extraction with comment directive support.
 """
 
 import logging
-import re
 from pathlib import Path
-from typing import Dict, List, Tuple
+from typing import Dict, List, Optional, Tuple
 
-from tree_sitter import Language, Node, Parser, Query, QueryCursor
+from tree_sitter import Language, Node, QueryCursor
 
+from ..languages.grammars import compile_query
 from ..languages.utils import node_text
+from .markers import marker_table, scan_markers
+from .parse_cache import ParsedSource, get_parse_cache
 
 logger = logging.getLogger(__name__)
 
@@ -19,18 +21,22 @@ class BaseExtractor:
 
     def __init__(self, language):
         self.language = language
-        self.parser = Parser(language)
+
+    def read_source(self, file_path: Path) -> bytes:
+        """Read a file's bytes through the shared parse cache."""
+        return get_parse_cache().read(file_path)
+
+    def parse_source(self, file_path: Path) -> ParsedSource:
+        """Parse a file through the shared parse cache."""
+        return get_parse_cache().parse_file(self.language, file_path)
 
     def parse_file(self, file_path: Path) -> Node:
         """Parse a file and return the root node."""
-        source = file_path.read_bytes()
-        tree = self.parser.parse(source)
-        return tree.root_node
+        return self.parse_source(file_path).root_node
 
     def parse_bytes(self, source: bytes) -> Node:
         """Parse source bytes and return the root node."""
-        tree = self.parser.parse(source)
-        return tree.root_node
+        return get_parse_cache().parse(self.language, source).root_node
 
     def extract_lines(self, file_path: Path, start_line: int, end_line: int) -> Tuple[str, int, int]:
         """
@@ -39,76 +45,41 @@ class BaseExtractor:
         Returns:
             Tuple of (code_text, start_line, end_line)
         """
-        lines = file_path.read_text().splitlines()
-        # Convert to 0-based indexing
-        start = max(0, start_line - 1)
-        end = min(len(lines), end_line)
+        return self.read_lines(file_path, start_line, end_line), start_line, end_line
 
-        code_lines = lines[start:end]
-        return "\n".join(code_lines), start_line, end_line
+    def read_lines(self, file_path: Path, start_line: int, end_line: int) -> str:
+        """Text of lines start_line..end_line (1-based, inclusive), decoding only that range."""
+        cache = get_parse_cache()
+        return cache.lines(cache.read(file_path), start_line, end_line)
 
-    def find_markers_in_node(self, node: Node) -> Dict[str, Tuple[int, int]]:
+    def find_markers_in_node(self, node: Node, parsed: Optional[ParsedSource] = None) -> Dict[str, Tuple[int, int]]:
         """
         Find comment markers within a given node.
 
-        Uses tree-sitter queries with predicates to find //@@start and //@@end markers.
+        With the node's ParsedSource, markers come from the file's marker table (one
+        byte scan per file content, shared by every lookup) by byte-range containment.
+        Without it, the node's own text is scanned.
 
         Args:
             node: The node to search within (e.g., function body or root)
+            parsed: ParsedSource the node belongs to, if known
 
         Returns:
             Dict mapping marker names to (start_line, end_line) tuples
         """
-        # Query for ALL comments first (no predicate)
-        comment_query = Query(self.language, "(comment) @comment")
-        cursor = QueryCursor(comment_query)
-        matches = cursor.matches(node)
-
-        markers = {}
-        active_markers = {}  # Track open markers
-
-        for _, captures in matches:
-            comments = captures.get("comment", [])
-            for comment in comments:
-                if not comment or not comment.text:
-                    continue
-
-                text = node_text(comment)
-                line_num = comment.start_point.row + 1
-
-                # Check for marker patterns in the comment text
-                # Using Python regex since tree-sitter regex can be tricky
-                if "//@@start" in text:
-                    match = re.search(r"//@@start\s+([\w-]+)", text)
-                    if match:
-                        marker_name = match.group(1)
-                        # Store the line AFTER the comment
-                        active_markers[marker_name] = line_num + 1
-                        logger.debug(f"Found start marker '{marker_name}' at line {line_num}")
-
-                elif "//@@end" in text:
-                    match = re.search(r"//@@end\s+([\w-]+)", text)
-                    if match:
-                        marker_name = match.group(1)
-                        if marker_name in active_markers:
-                            start_line = active_markers.pop(marker_name)
-                            # End at line BEFORE the comment
-                            end_line = line_num - 1
-                            markers[marker_name] = (start_line, end_line)
-                            logger.debug(f"Found end marker '{marker_name}' at line {line_num}")
-                        else:
-                            logger.warning(f"Found //@@end {marker_name} without matching //@@start")
-
-        # Warn about unclosed markers
-        for marker_name in active_markers:
-            logger.warning(f"Marker '{marker_name}' was not closed with //@@end")
-
-        return markers
+        if parsed is not None:
+            return self.find_markers_in_range(parsed, node.start_byte, node.end_byte)
+        table = scan_markers(node.text or b"", first_line=node.start_point.row + 1)
+        return table.lines_in_range(0, len(node.text or b""))
+
+    def find_markers_in_range(self, parsed: ParsedSource, start_byte: int, end_byte: int) -> Dict[str, Tuple[int, int]]:
+        """Markers whose directives lie within a byte range of a parsed file."""
+        return marker_table(parsed.data).lines_in_range(start_byte, end_byte)
 
     def find_markers_in_file(self, file_path: Path) -> Dict[str, Tuple[int, int]]:
         """Find all markers in a file."""
-        root = self.parse_file(file_path)
-        return self.find_markers_in_node(root)
+        data = self.read_source(file_path)
+        return marker_table(data).lines_in_range(0, len(data))
 
     def extract_marker(self, file_path: Path, marker_name: str) -> Tuple[str, int, int]:
         """
@@ -151,7 +122,7 @@ class MarkerExtractor:
         """
 
         try:
-            query = Query(language, query_text)
+            query = compile_query(language, query_text)
             cursor = QueryCursor(query)
             matches = cursor.matches(node)
 
@@ -167,7 +138,7 @@ class MarkerExtractor:
             logger.warning(f"Predicate query failed: {e}, falling back to manual filtering")
 
             # Fallback: get all comments and filter manually
-            simple_query = Query(language, "(comment) @comment")
+            simple_query = compile_query(language, "(comment) @comment")
             cursor = QueryCursor(simple_query)
             matches = cursor.matches(node)
 
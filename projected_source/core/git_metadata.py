@@ -0,0 +1,391 @@
+"""
+Per-render git metadata.
+
+Dirty checks, diffs and blame used to spawn one git process per snippet. GitMetadata
+runs `git status` once, `git diff HEAD` once (only if anything is dirty) and splits it
+per path, and blames each file once in full; every later lookup slices cached data.
+Call clear() whenever HEAD or the working tree may have moved (e.g. in watch mode).
+
+Full-file blames come from `git blame --incremental` (one record per run of lines,
+no line contents) into a compact BlameTable. Blame at a commit never changes, so
+with a render cache configured tables are also stored per (commit, path) and shared
+by later renders and CI jobs; files with uncommitted changes are always blamed afresh.
+
+Lookups may come from several threads: status and the combined diff are collected
+under a lock, blames of different files run concurrently.
+"""
+
+import datetime
+import logging
+import re
+import subprocess
+import threading
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import TYPE_CHECKING, Any, Dict, List, Optional, Set, Tuple
+
+from . import profiler
+from .render_cache import get_render_cache
+
+if TYPE_CHECKING:
+    from .github import LineMap
+
+logger = logging.getLogger(__name__)
+
+# Per-line blame info: {"commit": ..., "author": ..., "date": ...}
+BlameInfo = Dict[int, Dict[str, str]]
+
+# Blame record header: "<hash> <orig line> <final line>[ <count>]" - SHA-1 or SHA-256 hashes
+_BLAME_HEADER_RE = re.compile(r"[0-9a-f]{40}(?:[0-9a-f]{24})? \d+ \d+(?: \d+)?")
+
+
+def parse_status_paths(output: str) -> Set[str]:
+    """
+    Paths with staged or unstaged changes from `git status --porcelain -z`.
+
+    Untracked and ignored entries are skipped; for renames and copies only the new
+    path is kept.
+    """
+    paths = set()
+    entries = output.split("\0")
+    i = 0
+    while i < len(entries):
+        entry = entries[i]
+        i += 1
+        if len(entry) < 4:
+            continue
+        code, path = entry[:2], entry[3:]
+        if code[0] in "RC":
+            # The origin path follows as its own entry
+            i += 1
+        if code in ("??", "!!"):
+            continue
+        paths.add(path)
+    return paths
+
+
+def _section_path(header: str, lines: List[str]) -> Optional[str]:
+    """Path of one `diff --git` section, preferring the +++/--- lines over the header."""
+    for line in lines:
+        if line.startswith("@@"):
+            break
+        if line.startswith("+++ b/"):
+            return line[6:].rstrip("\t")
+        if line.startswith("--- a/"):
+            deleted = line[6:].rstrip("\t")
+            if "+++ /dev/null" in lines:
+                return deleted
+    if " b/" in header:
+        return header.rsplit(" b/", 1)[1]
+    return None
+
+
+def split_diff_by_path(diff_output: str) -> Dict[str, str]:
+    """
+    Split a multi-file `git diff` into per-path sections.
+
+    Returns:
+        Dict mapping repository-relative path to that file's diff text
+    """
+    sections: Dict[str, str] = {}
+    current: List[str] = []
+
+    def flush():
+        if current:
+            path = _section_path(current[0], [line.rstrip("\n") for line in current[1:]])
+            if path is not None:
+                sections[path] = "".join(current)
+
+    for line in diff_output.splitlines(keepends=True):
+        if line.startswith("diff --git "):
+            flush()
+            current = [line]
+        elif current:
+            current.append(line)
+    flush()
+
+    return sections
+
+
+def parse_blame_porcelain(output: str) -> BlameInfo:
+    """
+    Parse `git blame --porcelain` output.
+
+    Porcelain output only lists a commit's metadata the first time it appears, so
+    metadata is remembered per commit and reused for its later lines.
+
+    Returns:
+        Dict mapping final line numbers to blame info
+    """
+    commits: Dict[str, Dict[str, str]] = {}
+    blame: BlameInfo = {}
+    lines = output.split("\n")
+    i = 0
+
+    while i < len(lines):
+        parts = lines[i].split(" ")
+        i += 1
+        if not _BLAME_HEADER_RE.fullmatch(lines[i - 1]):
+            continue
+
+        commit_hash = parts[0]
+        final_line = int(parts[2])
+        info = commits.setdefault(commit_hash, {"commit": commit_hash[:8], "author": "", "date": ""})
+
+        while i < len(lines) and not lines[i].startswith("\t"):
+            if lines[i].startswith("author "):
+                info["author"] = lines[i][7:][:20]  # Truncate long names
+            elif lines[i].startswith("author-time "):
+                timestamp = int(lines[i][12:])
+                info["date"] = datetime.datetime.fromtimestamp(timestamp).strftime("%Y-%m-%d")
+            i += 1
+        # Skip the content line
+        i += 1
+
+        blame[final_line] = info
+
+    return blame
+
+
+def _blame_info(commit_hash: str, author: str, author_time: Optional[int]) -> Dict[str, str]:
+    return {
+        "commit": commit_hash[:8],
+        "author": author[:20],  # Truncate long names
+        "date": "" if author_time is None else datetime.datetime.fromtimestamp(author_time).strftime("%Y-%m-%d"),
+    }
+
+
+@dataclass
+class BlameTable:
+    """Full-file blame: each distinct commit once, plus one commit index per line."""
+
+    # (hash, author, author-time or None)
+    commits: List[Tuple[str, str, Optional[int]]] = field(default_factory=list)
+    # Index into commits for line 1, 2, ...; -1 where blame reported nothing
+    lines: List[int] = field(default_factory=list)
+
+    def __post_init__(self):
+        self._infos: Dict[int, Dict[str, str]] = {}
+
+    def slice(self, start_line: int, end_line: int) -> BlameInfo:
+        """Blame info for lines start_line..end_line (1-based, inclusive)."""
+        blame: BlameInfo = {}
+        for line in range(max(start_line, 1), min(end_line, len(self.lines)) + 1):
+            index = self.lines[line - 1]
+            if index < 0:
+                continue
+            info = self._infos.get(index)
+            if info is None:
+                info = self._infos[index] = _blame_info(*self.commits[index])
+            blame[line] = info
+        return blame
+
+    def to_json(self) -> Dict[str, Any]:
+        return {"commits": self.commits, "lines": self.lines}
+
+    @classmethod
+    def from_json(cls, data: Dict[str, Any]) -> "BlameTable":
+        return cls([tuple(commit) for commit in data["commits"]], list(data["lines"]))
+
+
+def parse_blame_incremental(output: str) -> BlameTable:
+    """
+    Parse `git blame --incremental` output.
+
+    Each record is "<hash> <orig line> <final line> <count>" followed by header
+    lines (metadata only the first time a commit appears) and ends with "filename".
+    """
+    indexes: Dict[str, int] = {}
+    commits: List[List[Any]] = []
+    runs: List[Tuple[int, int, int]] = []  # (final line, count, commit index)
+    current: Optional[List[Any]] = None
+
+    for line in output.split("\n"):
+        parts = line.split(" ")
+        if current is None:
+            if len(parts) == 4 and _BLAME_HEADER_RE.fullmatch(line):
+                commit_hash = parts[0]
+                if commit_hash not in indexes:
+                    indexes[commit_hash] = len(commits)
+                    commits.append([commit_hash, "", None])
+                current = commits[indexes[commit_hash]]
+                runs.append((int(parts[2]), int(parts[3]), indexes[commit_hash]))
+        elif line.startswith("author "):
+            current[1] = line[7:]
+        elif line.startswith("author-time "):
+            current[2] = int(line[12:])
+        elif line.startswith("filename "):
+            current = None
+
+    lines = [-1] * max((final + count - 1 for final, count, _ in runs), default=0)
+    for final, count, index in runs:
+        lines[final - 1 : final - 1 + count] = [index] * count
+    return BlameTable([tuple(commit) for commit in commits], lines)
+
+
+class GitMetadata:
+    """Git status, diffs and blame for one repository, each collected once and cached."""
+
+    def __init__(self, repo_path: Path, revision: Optional[str] = None):
+        """
+        Args:
+            repo_path: Directory git commands run in (any directory inside the work tree)
+            revision: Commit being rendered instead of the working tree; nothing is dirty
+                      against it and blame is taken at it
+        """
+        self.repo_path = Path(repo_path)
+        self.revision = revision
+        self.git_calls = 0
+        self._lock = threading.RLock()
+        self.clear()
+
+    def clear(self) -> None:
+        """Forget everything collected so far."""
+        self._toplevel: Optional[Path] = None
+        self._dirty: Optional[Set[Path]] = None
+        self._diffs: Optional[Dict[Path, str]] = None
+        self._line_mappings: Dict[Path, "LineMap"] = {}
+        self._blame: Dict[Path, BlameTable] = {}
+        self._commit: Optional[str] = None
+
+    def _git(self, *args: str) -> str:
+        self.git_calls += 1
+        command = next(arg for arg in args if not arg.startswith("-") and "=" not in arg)
+        with profiler.stage("git", command, args=" ".join(args)):
+            output = subprocess.check_output(["git", *args], cwd=self.repo_path, stderr=subprocess.DEVNULL)
+        return output.decode("utf8", errors="replace")
+
+    def _path(self, file_path: Path) -> Path:
+        """Absolute resolved path; relative paths are taken relative to repo_path."""
+        return (self.repo_path / file_path).resolve()
+
+    @property
+    def toplevel(self) -> Path:
+        """Root of the work tree; status and diff paths are relative to it."""
+        with self._lock:
+            if self._toplevel is None:
+                try:
+                    self._toplevel = Path(self._git("rev-parse", "--show-toplevel").strip()).resolve()
+                except (OSError, subprocess.CalledProcessError) as e:
+                    logger.debug(f"Could not find work tree root for {self.repo_path}: {e}")
+                    self._toplevel = self.repo_path.resolve()
+            return self._toplevel
+
+    def dirty_paths(self) -> Set[Path]:
+        """Tracked files with staged or unstaged changes against HEAD."""
+        with self._lock:
+            if self._dirty is None and self.revision is not None:
+                self._dirty = set()
+            if self._dirty is None:
+                try:
+                    output = self._git("status", "--porcelain", "-z", "--untracked-files=no")
+                    self._dirty = {(self.toplevel / path).resolve() for path in parse_status_paths(output)}
+                except (OSError, subprocess.CalledProcessError) as e:
+                    logger.debug(f"Could not get git status for {self.repo_path}: {e}")
+                    self._dirty = set()
+            return self._dirty
+
+    def is_dirty(self, file_path: Path) -> bool:
+        """Whether a file has uncommitted changes."""
+        return self._path(file_path) in self.dirty_paths()
+
+    def diff(self, file_path: Path) -> str:
+        """`git diff HEAD` output for one file ("" if clean)."""
+        if not self.is_dirty(file_path):
+            return ""
+
+        with self._lock:
+            if self._diffs is None:
+                try:
+                    # --no-renames: a renamed file diffs as an addition, like `git diff HEAD -- path`
+                    output = self._git(
+                        "-c", "core.quotePath=false", "diff", "HEAD", "--no-color", "--no-ext-diff", "--no-renames"
+                    )
+                    sections = split_diff_by_path(output)
+                    self._diffs = {(self.toplevel / path).resolve(): text for path, text in sections.items()}
+                except (OSError, subprocess.CalledProcessError) as e:
+                    logger.debug(f"Could not get diff for {self.repo_path}: {e}")
+                    self._diffs = {}
+
+            return self._diffs.get(self._path(file_path), "")
+
+    def line_mapping(self, file_path: Path) -> "LineMap":
+        """
+        Working copy → committed line translation for a file, built once from its diff.
+
+        Returns:
+            LineMap (see github.py); its hunks are those of parse_diff_hunks()
+        """
+        from .github import LineMap
+
+        path = self._path(file_path)
+        with self._lock:
+            if path not in self._line_mappings:
+                self._line_mappings[path] = LineMap.from_diff(self.diff(path))
+            return self._line_mappings[path]
+
+    @property
+    def commit(self) -> Optional[str]:
+        """Full hash of the commit blame is taken at (the revision, else HEAD), or None."""
+        with self._lock:
+            if self._commit is None:
+                try:
+                    revision = self.revision or "HEAD"
+                    self._commit = self._git("rev-parse", "--verify", "--quiet", f"{revision}^{{commit}}").strip()
+                except (OSError, subprocess.CalledProcessError) as e:
+                    logger.debug(f"Could not resolve commit for {self.repo_path}: {e}")
+                    self._commit = ""
+            return self._commit or None
+
+    def _blame_key(self, path: Path) -> Optional[Tuple[str, str]]:
+        """(commit, repository path) a file's blame is stored under, or None if it can change."""
+        if path in self.dirty_paths():
+            return None
+        try:
+            relative = path.relative_to(self.toplevel).as_posix()
+        except ValueError:
+            return None
+        commit = self.commit
+        return (commit, relative) if commit else None
+
+    def _full_blame(self, file_path: Path, path: Path) -> BlameTable:
+        cache = get_render_cache()
+        key = self._blame_key(path) if cache is not None else None
+        if key is not None:
+            stored = cache.get_blame(*key)
+            if stored is not None:
+                try:
+                    table = BlameTable.from_json(stored)
+                    profiler.count("blame cache hits")
+                    return table
+                except (KeyError, TypeError, ValueError) as e:
+                    logger.warning(f"Ignoring corrupt blame cache entry for {key[1]}: {e}")
+            profiler.count("blame cache misses")
+
+        try:
+            revision = [self.revision] if self.revision else []
+            table = parse_blame_incremental(self._git("blame", "--incremental", *revision, "--", str(path)))
+        except (OSError, subprocess.CalledProcessError) as e:
+            logger.warning(f"Git blame failed for {file_path}: {e}")
+            return BlameTable()
+
+        if key is not None:
+            cache.put_blame(*key, table.to_json())
+        return table
+
+    def blame(self, file_path: Path, start_line: int, end_line: int) -> BlameInfo:
+        """
+        Blame info for a line range, sliced from one full-file blame.
+
+        Args:
+            file_path: Path to the file
+            start_line: Start line number (1-based)
+            end_line: End line number (1-based, inclusive)
+
+        Returns:
+            Dict mapping line numbers to blame info
+        """
+        path = self._path(file_path)
+        if path not in self._blame:
+            self._blame[path] = self._full_blame(file_path, path)
+        return self._blame[path].slice(start_line, end_line)
@@ -0,0 +1,138 @@
+"""
+Read files of a commit straight from the object database.
+
+Rendering against a commit needs no checkout: GitTreeSource answers reads for paths
+under the repository with blob contents served by one long-lived `git cat-file --batch`
+process, so only files templates reference are ever read. Blob ids are git blob hashes,
+the same digests the parse cache and the symbol index key on, so content seen in any
+earlier render is never re-hashed or re-walked.
+"""
+
+import logging
+import subprocess
+import threading
+from pathlib import Path
+from typing import Dict, Optional, Tuple
+
+from . import profiler
+
+logger = logging.getLogger(__name__)
+
+
+class GitTreeSource:
+    """Read-only view of the files of one commit."""
+
+    def __init__(self, repo_path: Path, commit: str):
+        """
+        Args:
+            repo_path: Any directory inside the repository
+            commit: Commit, branch or tag to read files from
+
+        Raises:
+            RuntimeError: If the commit cannot be resolved
+        """
+        self.repo_path = Path(repo_path)
+        result = subprocess.run(
+            ["git", "rev-parse", "--verify", "--quiet", f"{commit}^{{commit}}"],
+            capture_output=True,
+            cwd=self.repo_path,
+            text=True,
+        )
+        if result.returncode != 0:
+            raise RuntimeError(f"Unknown commit: {commit}")
+        self.commit = result.stdout.strip()
+
+        toplevel = subprocess.check_output(
+            ["git", "rev-parse", "--show-toplevel"], cwd=self.repo_path, stderr=subprocess.DEVNULL
+        )
+        self.root = Path(toplevel.decode().strip()).resolve()
+
+        self._lock = threading.Lock()
+        self._process: Optional[subprocess.Popen] = None
+        # repository-relative path -> (data, blob id), or None if absent at the commit
+        self._blobs: Dict[str, Optional[Tuple[bytes, str]]] = {}
+        self.blobs_read = 0
+
+    def _relative(self, file_path: Path) -> str:
+        """Repository-relative POSIX path, or raise FileNotFoundError for paths outside the repository."""
+        try:
+            return (self.repo_path / file_path).resolve().relative_to(self.root).as_posix()
+        except ValueError:
+            raise FileNotFoundError(f"{file_path} is outside the repository at {self.root}") from None
+
+    def _request(self, spec: str) -> Optional[Tuple[bytes, str]]:
+        """Ask the cat-file process for one object; None if it is missing or not a blob."""
+        if self._process is None:
+            logger.debug(f"Reading sources at {self.commit[:12]} through git cat-file")
+            with profiler.stage("git", "cat-file", args="--batch"):
+                self._process = subprocess.Popen(
+                    ["git", "cat-file", "--batch"],
+                    cwd=self.root,
+                    stdin=subprocess.PIPE,
+                    stdout=subprocess.PIPE,
+                    stderr=subprocess.DEVNULL,
+                )
+
+        stdin, stdout = self._process.stdin, self._process.stdout
+        stdin.write(spec.encode("utf8") + b"\n")
+        stdin.flush()
+
+        header = stdout.readline()
+        if not header:
+            raise RuntimeError(f"git cat-file exited while reading {spec}")
+        parts = header.split()
+        if len(parts) != 3:
+            # "<spec> missing" or "<spec> ambiguous"
+            return None
+
+        oid, object_type, size = parts
+        data = stdout.read(int(size))
+        stdout.read(1)  # Trailing newline
+        if object_type != b"blob":
+            return None
+        self.blobs_read += 1
+        return data, oid.decode()
+
+    def read(self, file_path: Path) -> Tuple[bytes, str]:
+        """
+        Read a file's content at the commit.
+
+        The same bytes object is returned on every call for a path.
+
+        Returns:
+            Tuple of (data, git blob id)
+
+        Raises:
+            FileNotFoundError: If the path does not exist at the commit
+        """
+        relative = self._relative(file_path)
+        with self._lock:
+            if relative not in self._blobs:
+                with profiler.stage("read", relative, source="cat-file"):
+                    self._blobs[relative] = self._request(f"{self.commit}:{relative}")
+            blob = self._blobs[relative]
+        if blob is None:
+            raise FileNotFoundError(f"{relative} does not exist at {self.commit[:12]}")
+        return blob
+
+    def exists(self, file_path: Path) -> bool:
+        """Whether a file exists at the commit."""
+        try:
+            self.read(file_path)
+            return True
+        except FileNotFoundError:
+            return False
+
+    def close(self) -> None:
+        """Stop the cat-file process."""
+        with self._lock:
+            if self._process is not None:
+                self._process.stdin.close()
+                self._process.wait()
+                self._process = None
+
+    def __enter__(self) -> "GitTreeSource":
+        return self
+
+    def __exit__(self, *exc) -> None:
+        self.close()
@@ -3,13 +3,16 @@ GitHub integration for permalinks and git blame.
 Adapted from rwdb-online-delete-fix.py
 """
 
-import datetime
+import bisect
 import logging
 import re
 import subprocess
 from pathlib import Path
 from typing import Dict, List, Optional, Tuple
 
+from . import profiler
+from .git_metadata import GitMetadata
+
 logger = logging.getLogger(__name__)
 
 
@@ -146,8 +149,23 @@ def map_line_to_committed_full(new_line: int, diff_output: str) -> int:
     Returns:
         Corresponding line number in HEAD
     """
-    mapping = build_line_mapping(diff_output)
+    return LineMap.from_diff(diff_output).to_committed(new_line)
+
+
+def map_line_with_mapping(
+    new_line: int, mapping: Dict[int, Optional[int]], hunks: List[Tuple[int, int, int, int]]
+) -> int:
+    """
+    Map a line number using a prebuilt line mapping and hunk list.
 
+    Args:
+        new_line: Line number in the working copy (1-based)
+        mapping: Result of build_line_mapping()
+        hunks: Result of parse_diff_hunks()
+
+    Returns:
+        Corresponding line number in HEAD
+    """
     # If we have a direct mapping for this line
     if new_line in mapping:
         old = mapping[new_line]
@@ -163,7 +181,6 @@ def map_line_to_committed_full(new_line: int, diff_output: str) -> int:
         return 1
 
     # Line not in any hunk - calculate offset from hunks before it
-    hunks = parse_diff_hunks(diff_output)
     offset = 0
     for old_start, old_count, new_start, new_count in hunks:
         if new_line < new_start:
@@ -173,15 +190,118 @@ def map_line_to_committed_full(new_line: int, diff_output: str) -> int:
     return new_line + offset
 
 
+class LineMap:
+    """
+    Working copy → committed line translation for one file, built once from its diff.
+
+    Gives the same answers as map_line_with_mapping() over build_line_mapping(), but
+    stores runs instead of one dict entry per line and answers by bisection:
+
+    - lines inside hunks are grouped into runs that map with a constant offset
+      (context lines) or to one fixed committed line (added lines, which take the
+      nearest earlier unchanged line)
+    - lines outside hunks are shifted by the cumulative size change of the hunks
+      that start before them
+    """
+
+    def __init__(self, hunks: List[Tuple[int, int, int, int]]):
+        self.hunks = hunks
+        # Runs inside hunks: first working copy line, last line, and either the offset
+        # to add (added=False) or the committed line every line maps to (added=True)
+        self._run_starts: List[int] = []
+        self._run_ends: List[int] = []
+        self._run_values: List[int] = []
+        self._run_added: List[bool] = []
+        # Hunk start lines and the offset in effect from each of them on
+        self._hunk_starts = [new_start for _, _, new_start, _ in hunks]
+        self._offsets: List[int] = []
+        offset = 0
+        for old_start, old_count, new_start, new_count in hunks:
+            offset += old_count - new_count
+            self._offsets.append(offset)
+
+    @classmethod
+    def from_diff(cls, diff_output: str) -> "LineMap":
+        """Build from `git diff` output of one file (same rules as build_line_mapping())."""
+        line_map = cls(parse_diff_hunks(diff_output))
+        hunk_pattern = re.compile(r"^@@ -(\d+)(?:,(\d+))? \+(\d+)(?:,(\d+))? @@")
+
+        old_line = new_line = 0
+        in_hunk = False
+        last_old: Optional[int] = None  # committed line of the last unchanged line seen
+
+        for line in diff_output.split("\n"):
+            match = hunk_pattern.match(line)
+            if match:
+                old_line = int(match.group(1))
+                new_line = int(match.group(3))
+                in_hunk = True
+                continue
+            if not in_hunk or line.startswith("+++") or line.startswith("---"):
+                continue
+
+            if line.startswith("+"):
+                line_map._extend(new_line, last_old if last_old is not None else 1, True)
+                new_line += 1
+            elif line.startswith("-"):
+                old_line += 1
+            elif line.startswith(" ") or line == "":
+                line_map._extend(new_line, old_line - new_line, False)
+                last_old = old_line
+                old_line += 1
+                new_line += 1
+
+        return line_map
+
+    def _extend(self, new_line: int, value: int, added: bool) -> None:
+        """Map new_line, growing the last run when it continues it."""
+        if (
+            self._run_ends
+            and self._run_ends[-1] == new_line - 1
+            and self._run_added[-1] == added
+            and self._run_values[-1] == value
+        ):
+            self._run_ends[-1] = new_line
+            return
+        self._run_starts.append(new_line)
+        self._run_ends.append(new_line)
+        self._run_values.append(value)
+        self._run_added.append(added)
+
+    def to_committed(self, new_line: int) -> int:
+        """Committed line number for a working copy line."""
+        i = bisect.bisect_right(self._run_starts, new_line) - 1
+        if i >= 0 and new_line <= self._run_ends[i]:
+            value = self._run_values[i]
+            return value if self._run_added[i] else new_line + value
+
+        j = bisect.bisect_right(self._hunk_starts, new_line)
+        return new_line + (self._offsets[j - 1] if j else 0)
+
+
 class GitHubIntegration:
     """Handle GitHub permalinks and git operations."""
 
-    def __init__(self, repo_path: Optional[Path] = None):
+    def __init__(self, repo_path: Optional[Path] = None, commit: Optional[str] = None):
+        """
+        Args:
+            repo_path: Repository root path (default: current dir)
+            commit: Commit being rendered; permalinks and blame use it instead of HEAD and the working tree
+        """
         self.repo_path = repo_path or Path.cwd()
+        self.commit = commit
         self._github_url: Optional[str] = None
         self._commit_hash: Optional[str] = None
         self._initialized = False
-        self._diff_cache: Dict[str, str] = {}  # Cache diff output per file
+        # Status, diffs and blame, collected once per render
+        self.metadata = GitMetadata(self.repo_path, revision=commit)
+
+    def invalidate(self) -> None:
+        """Forget cached repository state (HEAD, status, diffs, blame), e.g. between watch-mode renders."""
+        self._github_url = None
+        self._commit_hash = None
+        self._initialized = False
+        self.metadata.clear()
 
     def _init_repo_info(self):
         """Lazy initialization of repository information."""
@@ -190,20 +310,26 @@ class GitHubIntegration:
 
         try:
             # Get the remote origin URL
-            origin_url = (
-                subprocess.check_output(
-                    ["git", "remote", "get-url", "origin"], cwd=self.repo_path, stderr=subprocess.DEVNULL
+            with profiler.stage("git", "remote", args="get-url origin"):
+                origin_url = (
+                    subprocess.check_output(
+                        ["git", "remote", "get-url", "origin"], cwd=self.repo_path, stderr=subprocess.DEVNULL
+                    )
+                    .decode()
+                    .strip()
                 )
-                .decode()
-                .strip()
-            )
 
-            # Get current commit hash
-            self._commit_hash = (
-                subprocess.check_output(["git", "rev-parse", "HEAD"], cwd=self.repo_path, stderr=subprocess.DEVNULL)
-                .decode()
-                .strip()
-            )
+            # Get the commit hash (HEAD unless rendering a specific commit)
+            with profiler.stage("git", "rev-parse", args=self.commit or "HEAD"):
+                self._commit_hash = (
+                    subprocess.check_output(
+                        ["git", "rev-parse", f"{self.commit or 'HEAD'}^{{commit}}"],
+                        cwd=self.repo_path,
+                        stderr=subprocess.DEVNULL,
+                    )
+                    .decode()
+                    .strip()
+                )
 
             # Convert SSH/HTTPS URL to GitHub web URL
             if origin_url.startswith("git@github.com:"):
@@ -240,22 +366,8 @@ class GitHubIntegration:
         return self._commit_hash
 
     def is_file_dirty(self, file_path: Path) -> bool:
-        """Check if a file has uncommitted changes."""
-        try:
-            # Get path relative to repo
-            if file_path.is_absolute():
-                rel_path = file_path.relative_to(self.repo_path)
-            else:
-                rel_path = file_path
-
-            # Check if file has changes (staged or unstaged)
-            result = subprocess.run(
-                ["git", "diff", "--quiet", "HEAD", "--", str(rel_path)], cwd=self.repo_path, capture_output=True
-            )
-            return result.returncode != 0
-        except Exception as e:
-            logger.debug(f"Could not check dirty status for {file_path}: {e}")
-            return False
+        """Check if a file has uncommitted changes (staged or unstaged)."""
+        return self.metadata.is_dirty(file_path)
 
     def get_diff_output(self, file_path: Path) -> str:
         """
@@ -263,27 +375,7 @@ class GitHubIntegration:
 
         Returns the raw git diff output string.
         """
-        cache_key = str(file_path.resolve()) + "_diff"
-
-        if cache_key in self._diff_cache:
-            return self._diff_cache[cache_key]
-
-        try:
-            if file_path.is_absolute():
-                rel_path = file_path.relative_to(self.repo_path)
-            else:
-                rel_path = file_path
-
-            diff_output = subprocess.check_output(
-                ["git", "diff", "HEAD", "--", str(rel_path)], cwd=self.repo_path, stderr=subprocess.DEVNULL
-            ).decode()
-
-            self._diff_cache[cache_key] = diff_output
-            return diff_output
-
-        except Exception as e:
-            logger.debug(f"Could not get diff for {file_path}: {e}")
-            return ""
+        return self.metadata.diff(file_path)
 
     def get_diff_hunks(self, file_path: Path) -> List[Tuple[int, int, int, int]]:
         """
@@ -291,8 +383,7 @@ class GitHubIntegration:
 
         Returns list of (old_start, old_count, new_start, new_count) tuples.
         """
-        diff_output = self.get_diff_output(file_path)
-        return parse_diff_hunks(diff_output)
+        return self.metadata.line_mapping(file_path).hunks
 
     def map_to_committed_line(self, file_path: Path, line: int) -> int:
         """
@@ -304,11 +395,30 @@ class GitHubIntegration:
         if not self.is_file_dirty(file_path):
             return line
 
-        diff_output = self.get_diff_output(file_path)
-        if not diff_output:
+        line_map = self.metadata.line_mapping(file_path)
+        if not line_map.hunks:
             return line
 
-        return map_line_to_committed_full(line, diff_output)
+        return line_map.to_committed(line)
+
+    def permalink_url(self, file_path: Path, start_line: int, end_line: int) -> Optional[str]:
+        """
+        GitHub URL of a line range at the committed line numbers.
+
+        Returns:
+            URL, or None if the repository has no GitHub remote
+        """
+        if not (self.github_url and self.commit_hash):
+            return None
+        try:
+            rel_path = file_path.relative_to(self.repo_path) if file_path.is_absolute() else file_path
+        except ValueError:
+            rel_path = file_path
+
+        committed_start = self.map_to_committed_line(file_path, start_line)
+        committed_end = self.map_to_committed_line(file_path, end_line)
+        url = f"{self.github_url}/blob/{self.commit_hash}/{rel_path.as_posix()}#L{committed_start}"
+        return url if committed_end == committed_start else f"{url}-L{committed_end}"
 
     def get_permalink(
         self, file_path: Path, start_line: int = None, end_line: int = None, display_committed_lines: bool = True
@@ -391,6 +501,8 @@ class GitHubIntegration:
         """
         Get git blame information for a line range.
 
+        The whole file is blamed once per render and sliced for each range.
+
         Args:
             file_path: Path to the file
             start_line: Start line number (1-based)
@@ -399,54 +511,7 @@ class GitHubIntegration:
         Returns:
             Dict mapping line numbers to blame info
         """
-        try:
-            blame_output = subprocess.check_output(
-                ["git", "blame", "-L", f"{start_line},{end_line}", "--porcelain", str(file_path)],
-                cwd=self.repo_path,
-                stderr=subprocess.DEVNULL,
-            ).decode()
-
-            blame_info = {}
-            lines = blame_output.split("\n")
-            i = 0
-
-            while i < len(lines):
-                line = lines[i]
-                if line and not line.startswith("\t"):
-                    parts = line.split(" ")
-                    if len(parts) >= 3:
-                        commit_hash = parts[0]
-                        int(parts[1])
-                        final_line = int(parts[2])
-
-                        # Extract commit metadata
-                        author = ""
-                        date = ""
-                        i += 1
-
-                        while i < len(lines) and not lines[i].startswith("\t"):
-                            if lines[i].startswith("author "):
-                                author = lines[i][7:]
-                            elif lines[i].startswith("author-time "):
-                                timestamp = int(lines[i][12:])
-                                date = datetime.datetime.fromtimestamp(timestamp).strftime("%Y-%m-%d")
-                            i += 1
-
-                        blame_info[final_line] = {
-                            "commit": commit_hash[:8],
-                            "author": author[:20],  # Truncate long names
-                            "date": date,
-                        }
-                i += 1
-
-            return blame_info
-
-        except subprocess.CalledProcessError as e:
-            logger.warning(f"Git blame failed: {e}")
-            return {}
-        except Exception as e:
-            logger.error(f"Error getting blame info: {e}")
-            return {}
+        return self.metadata.blame(file_path, start_line, end_line)
 
     def format_with_blame(self, code_text: str, start_line: int, file_path: Path) -> str:
         """
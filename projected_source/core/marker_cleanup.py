@@ -0,0 +1,201 @@
+"""
+Find and remove //@@ marker comments across a changeset (find-markers).
+
+When the changeset ends at the working tree (a plain ref, no ".."), one
+`git diff -U0 <ref>` supplies every added line with its current line number, so
+only the added hunks are scanned and no file is read. Explicit ranges (or
+whole_files=True) scan the full working-tree contents of the changed files on a
+thread pool. Both use iter_directives(), the scanner behind the marker table.
+
+Removal rewrites each file at most once, dropping standalone directive lines
+after checking they still hold the directive that was found.
+"""
+
+import logging
+import subprocess
+from concurrent.futures import ThreadPoolExecutor
+from pathlib import Path
+from typing import Dict, Iterator, List, Optional, Tuple
+
+from .markers import Directive, iter_directives
+
+logger = logging.getLogger(__name__)
+
+CPP_SUFFIXES = (".h", ".hpp", ".cpp", ".cc", ".cxx", ".c", ".hxx", ".ipp")
+
+# Restricts git diff to C/C++ files (case-insensitively, like the suffix check it replaces)
+CPP_PATHSPECS = [f":(icase)*{suffix}" for suffix in CPP_SUFFIXES]
+
+# (first new-side line, added lines joined) per -U0 hunk
+Hunk = Tuple[int, bytes]
+
+
+def _git_diff(repo_path: Path, *args: str) -> bytes:
+    result = subprocess.run(
+        ["git", "-c", "core.quotePath=false", "diff", "--no-color", "--no-ext-diff", "--no-renames", *args]
+        + ["--", *CPP_PATHSPECS],
+        capture_output=True,
+        cwd=repo_path,
+    )
+    if result.returncode != 0:
+        raise RuntimeError(f"git diff failed: {result.stderr.decode(errors='replace').strip()}")
+    return result.stdout
+
+
+def _file_sections(diff_output: bytes) -> Iterator[bytes]:
+    """Split multi-file diff output at each "diff --git" header."""
+    start = diff_output.find(b"diff --git ")
+    while start != -1:
+        end = diff_output.find(b"\ndiff --git ", start)
+        yield diff_output[start : None if end == -1 else end + 1]
+        start = -1 if end == -1 else end + 1
+
+
+def parse_added_hunks(diff_output: bytes) -> Dict[str, List[Hunk]]:
+    """
+    Added lines of `git diff -U0` output, per new-side path.
+
+    Files whose section holds no "//@@" are skipped without parsing their hunks.
+
+    Args:
+        diff_output: Raw diff bytes
+
+    Returns:
+        Path (relative to the repository) -> hunks holding at least one added line
+    """
+    hunks: Dict[str, List[Hunk]] = {}
+    for section in _file_sections(diff_output):
+        if b"//@@" not in section:
+            continue
+        lines = section.split(b"\n")
+        path = None
+        i = 0
+        while i < len(lines):
+            line = lines[i]
+            i += 1
+            if line.startswith(b"+++ "):
+                target = line[4:]
+                path = target[2:].decode("utf8", errors="surrogateescape") if target.startswith(b"b/") else None
+            elif line.startswith(b"@@ ") and path is not None:
+                # @@ -old_start[,old_count] +new_start[,new_count] @@
+                old_range, new_range = line.split(b" ")[1:3]
+                removed = int(old_range.split(b",")[1]) if b"," in old_range else 1
+                new_start, _, count = new_range[1:].partition(b",")
+                added = int(count) if count else 1
+                # Counted, so added lines that look like headers are still content
+                body, remaining = [], removed + added
+                while remaining and i < len(lines):
+                    entry = lines[i]
+                    i += 1
+                    if entry.startswith(b"\\"):  # "\ No newline at end of file"
+                        continue
+                    remaining -= 1
+                    if entry.startswith(b"+"):
+                        body.append(entry[1:])
+                text = b"\n".join(body)
+                if added and b"//@@" in text:
+                    hunks.setdefault(path, []).append((int(new_start), text))
+    return hunks
+
+
+def scan_hunks(hunks: List[Hunk]) -> List[Directive]:
+    """Standalone directives among added lines, numbered as in the new file."""
+    return [
+        directive
+        for first_line, text in hunks
+        for directive in iter_directives(text, first_line)
+        if directive.standalone
+    ]
+
+
+def scan_file(path: Path) -> List[Directive]:
+    """Standalone directives of a whole file (empty if it no longer exists)."""
+    if not path.exists():
+        return []
+    # Read directly: a release-branch changeset is too many files to keep in the parse cache
+    try:
+        data = path.read_bytes()
+    except OSError as e:
+        logger.warning(f"Could not read {path}: {e}")
+        return []
+    return [directive for directive in iter_directives(data) if directive.standalone]
+
+
+def find_changed_markers(
+    repo_path: Path, since: str, whole_files: bool = False, jobs: Optional[int] = None
+) -> Dict[Path, List[Directive]]:
+    """
+    Standalone marker directives in C/C++ files changed since a ref.
+
+    Args:
+        repo_path: Repository root
+        since: Ref to diff the working tree against, or an explicit range "a..b"
+        whole_files: Scan the full contents of changed files, not only added lines
+        jobs: Threads for whole-file scans (None: executor default)
+
+    Returns:
+        File path -> directives in line order, for files holding any
+
+    Raises:
+        RuntimeError: If git diff fails
+    """
+    if ".." not in since and not whole_files:
+        hunks = parse_added_hunks(_git_diff(repo_path, "-U0", since))
+        found = {repo_path / path: scan_hunks(file_hunks) for path, file_hunks in hunks.items()}
+        logger.info(f"Scanned added lines of {len(hunks)} file(s) containing //@@")
+    else:
+        diff_range = since if ".." in since else f"{since}..HEAD"
+        names = _git_diff(repo_path, "--name-only", "-z", diff_range).split(b"\0")
+        paths = [repo_path / name.decode("utf8", errors="surrogateescape") for name in names if name]
+        with ThreadPoolExecutor(max_workers=jobs) as pool:
+            found = dict(zip(paths, pool.map(scan_file, paths)))
+        logger.info(f"Scanned {len(paths)} changed file(s)")
+    return {path: directives for path, directives in found.items() if directives}
+
+
+def remove_directive_lines(path: Path, directives: List[Directive]) -> int:
+    """
+    Delete the lines holding standalone directives, reading and writing the file once.
+
+    Lines that no longer hold the expected directive (the file changed since the
+    scan) are kept.
+
+    Returns:
+        Number of lines removed
+    """
+    expected = {directive.line: (directive.kind, directive.name) for directive in directives if directive.standalone}
+    lines = path.read_bytes().splitlines(keepends=True)
+    kept = []
+    for number, line in enumerate(lines, 1):
+        if number in expected:
+            found = [(d.kind, d.name) for d in iter_directives(line) if d.standalone]
+            if found == [expected[number]]:
+                continue
+            logger.warning(f"{path}:{number} no longer holds //@@{' '.join(expected[number])}; kept")
+        kept.append(line)
+
+    removed = len(lines) - len(kept)
+    if removed:
+        path.write_bytes(b"".join(kept))
+    return removed
+
+
+def remove_markers(
+    found: Dict[Path, List[Directive]], jobs: Optional[int] = None
+) -> Dict[Path, Tuple[int, Optional[Exception]]]:
+    """
+    Remove directive lines from many files in parallel.
+
+    Returns:
+        File path -> (lines removed, error or None)
+    """
+
+    def remove(item):
+        path, directives = item
+        try:
+            return path, (remove_directive_lines(path, directives), None)
+        except OSError as e:
+            return path, (0, e)
+
+    with ThreadPoolExecutor(max_workers=jobs) as pool:
+        return dict(pool.map(remove, found.items()))
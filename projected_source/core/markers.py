@@ -0,0 +1,152 @@
+"""
+Per-file table of //@@start / //@@end markers.
+
+Markers are found with a single scan over the raw bytes (bytes.find for the "//@@"
+prefix, no parse tree needed) and memoized per file content in the parse cache.
+Each marker keeps the byte span of its directives, so markers inside a function,
+struct, message or macro invocation are selected by interval containment against
+the node's byte range instead of querying the node's subtree for comments.
+iter_directives() is the underlying scanner, also used by find-markers.
+
+Without a parse tree, a directive is any "//@@start <name>" or "//@@end <name>"
+text except where the rest of its line before it leaves a string literal open
+(`"//@@start x"` is not a marker). A // comment ends at the newline, so the name
+must follow on the same line, after spaces or tabs. `//@@` inside a block comment
+still counts, as the comment-node scan it replaces did; a raw string literal
+spanning lines is not recognised as a string.
+"""
+
+import bisect
+import logging
+import re
+from dataclasses import dataclass
+from typing import Dict, Iterator, List, NamedTuple, Tuple
+
+from .parse_cache import get_parse_cache
+
+logger = logging.getLogger(__name__)
+
+_DIRECTIVE = re.compile(rb"//@@(start|end)[ \t\f\v]+([\w-]+)")
+# Escaped characters and character literals, which never open or close a string literal
+_NOT_QUOTE = re.compile(rb"\\.|'[^'\\]'")
+
+
+def _in_string_literal(line_prefix: bytes) -> bool:
+    """Whether a line's text up to some position leaves a "..." literal open."""
+    if b'"' not in line_prefix:
+        return False
+    return _NOT_QUOTE.sub(b"", line_prefix).count(b'"') % 2 == 1
+
+
+@dataclass(frozen=True)
+class Marker:
+    """One //@@start / //@@end pair."""
+
+    name: str
+    # Lines of the directive comments (1-based)
+    open_line: int
+    close_line: int
+    # Byte span from the start directive to the end of the end directive
+    start_byte: int
+    end_byte: int
+
+    @property
+    def lines(self) -> Tuple[int, int]:
+        """(first, last) line of the marked content, excluding the directives."""
+        return self.open_line + 1, self.close_line - 1
+
+
+class Directive(NamedTuple):
+    """One //@@start or //@@end comment."""
+
+    kind: str  # "start" or "end"
+    name: str
+    line: int
+    start_byte: int
+    end_byte: int
+    # Nothing but whitespace around the directive on its line
+    standalone: bool
+
+
+def iter_directives(data: bytes, first_line: int = 1) -> Iterator[Directive]:
+    """
+    Yield every //@@start / //@@end directive in source bytes, in order (see the module docstring for the rule).
+
+    Args:
+        data: Source bytes
+        first_line: Line number of the first byte (for scanning a slice of a file)
+    """
+    line, counted = first_line, 0
+    pos = data.find(b"//@@")
+    while pos != -1:
+        match = _DIRECTIVE.match(data, pos)
+        line_start = data.rfind(b"\n", 0, pos) + 1
+        if match and not _in_string_literal(data[line_start:pos]):
+            line += data.count(b"\n", counted, pos)
+            counted = pos
+            line_end = data.find(b"\n", match.end())
+            if line_end == -1:
+                line_end = len(data)
+            standalone = not data[line_start:pos].strip() and not data[match.end() : line_end].strip()
+            yield Directive(match.group(1).decode(), match.group(2).decode("utf8"), line, pos, match.end(), standalone)
+        pos = data.find(b"//@@", pos + 4)
+
+
+class MarkerTable:
+    """All markers of one file content, ordered by position."""
+
+    def __init__(self, markers: List[Marker]):
+        self.markers = sorted(markers, key=lambda m: m.start_byte)
+        self._starts = [m.start_byte for m in self.markers]
+
+    def in_range(self, start_byte: int, end_byte: int) -> List[Marker]:
+        """Markers whose directives both lie within [start_byte, end_byte]."""
+        first = bisect.bisect_left(self._starts, start_byte)
+        last = bisect.bisect_right(self._starts, end_byte)
+        return [m for m in self.markers[first:last] if m.end_byte <= end_byte]
+
+    def lines_in_range(self, start_byte: int, end_byte: int) -> Dict[str, Tuple[int, int]]:
+        """Marker name -> content (start_line, end_line) for markers within a byte range."""
+        return {m.name: m.lines for m in self.in_range(start_byte, end_byte)}
+
+    def __len__(self) -> int:
+        return len(self.markers)
+
+
+def scan_markers(data: bytes, first_line: int = 1) -> MarkerTable:
+    """
+    Find all markers in source bytes.
+
+    Args:
+        data: Source bytes
+        first_line: Line number of the first byte (for scanning a slice of a file)
+
+    Returns:
+        MarkerTable of the paired markers
+    """
+    markers = []
+    open_markers: Dict[str, Tuple[int, int]] = {}  # name -> (line, byte)
+
+    for directive in iter_directives(data, first_line):
+        name, line = directive.name, directive.line
+        if directive.kind == "start":
+            open_markers[name] = (line, directive.start_byte)
+            logger.debug(f"Found start marker '{name}' at line {line}")
+        elif name in open_markers:
+            open_line, start_byte = open_markers.pop(name)
+            markers.append(Marker(name, open_line, line, start_byte, directive.end_byte))
+            logger.debug(f"Found end marker '{name}' at line {line}")
+        else:
+            logger.warning(f"Found //@@end {name} without matching //@@start")
+
+    # Warn about unclosed markers
+    for name in open_markers:
+        logger.warning(f"Marker '{name}' was not closed with //@@end")
+
+    return MarkerTable(markers)
+
+
+def marker_table(data: bytes) -> MarkerTable:
+    """Marker table of source bytes, scanned once per file content."""
+    cache = get_parse_cache()
+    return cache.derived(cache.digest(data), "markers", lambda: scan_markers(data))
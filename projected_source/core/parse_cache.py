@@ -0,0 +1,642 @@
+"""
+Process-wide parse cache shared by all extractors.
+
+A template typically pulls many snippets out of the same translation unit. Rather
+than re-reading and re-parsing the file for every code() call, extractors ask this
+cache for the file's bytes and tree. Files are validated by (mtime, size) and trees
+are keyed by (language, content hash), so a given file is parsed once per process.
+
+When a previously parsed file changes on disk, the new content is parsed
+incrementally: the old tree is edited with the byte range that differs and handed
+to the parser, so only the changed region is re-parsed (used by `render --watch`).
+
+The cache is safe to use from several threads. File reads, parses and derived
+artifact builds run outside the cache lock, so one thread's git or disk I/O
+overlaps with another's parsing (see TemplateRenderer's deferred snippets).
+
+With a memory budget set, every content is charged an estimate of what the cache
+holds for it (file bytes, trees, derived tables) and the least recently used
+contents are evicted whole once the total exceeds the budget. Trees of large files
+(see large_file_bytes) are released as soon as their snippets are extracted: the
+symbol and marker tables are all later lookups need.
+"""
+
+import bisect
+import hashlib
+import logging
+import threading
+from collections import OrderedDict
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Any, Callable, Dict, List, Optional, Tuple
+
+from tree_sitter import Language, Node, Parser, Tree
+
+from . import profiler
+
+logger = logging.getLogger(__name__)
+
+# Estimated memory per source byte of a tree-sitter tree, and of one derived table
+TREE_BYTES_PER_SOURCE_BYTE = 10
+DERIVED_BYTES_PER_SOURCE_BYTE = 0.25
+
+# Files at least this large (generated amalgamations etc.) do not keep their trees around
+LARGE_FILE_BYTES = 32 * 1024 * 1024
+
+# Indexes into a content's cost entry
+_FILE, _TREE, _DERIVED = range(3)
+
+
+def blob_hash(data: bytes) -> str:
+    """Git-compatible blob hash (SHA-1 over 'blob <size>\\0' + data)."""
+    digest = hashlib.sha1(b"blob %d\0" % len(data))
+    digest.update(data)
+    return digest.hexdigest()
+
+
+def build_line_offsets(data: bytes) -> List[int]:
+    """
+    Build a table of line start offsets.
+
+    Returns:
+        List where entry i is the byte offset of line i + 1
+    """
+    offsets = [0]
+    find = data.find
+    pos = find(b"\n")
+    while pos != -1:
+        offsets.append(pos + 1)
+        pos = find(b"\n", pos + 1)
+    return offsets
+
+
+def slice_lines(data: bytes, line_offsets: List[int], start_line: int, end_line: int) -> str:
+    """
+    Decode a range of lines without splitting the whole file.
+
+    Equivalent to "\\n".join(data.decode().splitlines()[start_line - 1 : end_line]) for
+    newline-separated text: the byte range is found in the offset table and only that
+    slice is decoded.
+
+    Args:
+        data: Source bytes
+        line_offsets: Table from build_line_offsets(data)
+        start_line: First line (1-based, inclusive)
+        end_line: Last line (inclusive)
+    """
+    count = len(line_offsets)
+    if count > 1 and line_offsets[-1] == len(data):
+        count -= 1
+    start = max(0, start_line - 1)
+    end = min(count, end_line)
+    if start >= end:
+        return ""
+
+    end_byte = line_offsets[end] - 1 if end < len(line_offsets) else len(data)
+    text = str(memoryview(data)[line_offsets[start] : end_byte], "utf8")
+    if "\r" in text:
+        text = text.replace("\r\n", "\n").removesuffix("\r")
+    return text
+
+
+def _common_prefix_length(a: bytes, b: bytes) -> int:
+    """Length of the longest common prefix (binary search over slice comparisons)."""
+    lo, hi = 0, min(len(a), len(b))
+    while lo < hi:
+        mid = (lo + hi + 1) // 2
+        if a[lo:mid] == b[lo:mid]:
+            lo = mid
+        else:
+            hi = mid - 1
+    return lo
+
+
+def _common_suffix_length(a: bytes, b: bytes, limit: int) -> int:
+    """Length of the longest common suffix, at most limit bytes."""
+    lo, hi = 0, min(len(a), len(b), limit)
+    while lo < hi:
+        mid = (lo + hi + 1) // 2
+        if a[len(a) - mid : len(a) - lo] == b[len(b) - mid : len(b) - lo]:
+            lo = mid
+        else:
+            hi = mid - 1
+    return lo
+
+
+def _point(line_offsets: List[int], byte: int) -> Tuple[int, int]:
+    """(row, column) of a byte offset."""
+    row = bisect.bisect_right(line_offsets, byte) - 1
+    return row, byte - line_offsets[row]
+
+
+def compute_edit(old: bytes, new: bytes, old_offsets: List[int], new_offsets: List[int]) -> Dict[str, Any]:
+    """
+    Describe the change from old to new as a single tree-sitter edit.
+
+    The edited region spans from the first differing byte to the last one, found by
+    comparing common prefix and suffix.
+
+    Returns:
+        Keyword arguments for Tree.edit()
+    """
+    start = _common_prefix_length(old, new)
+    suffix = _common_suffix_length(old, new, min(len(old), len(new)) - start)
+    old_end = len(old) - suffix
+    new_end = len(new) - suffix
+    return {
+        "start_byte": start,
+        "old_end_byte": old_end,
+        "new_end_byte": new_end,
+        "start_point": _point(old_offsets, start),
+        "old_end_point": _point(old_offsets, old_end),
+        "new_end_point": _point(new_offsets, new_end),
+    }
+
+
+@dataclass
+class ParsedSource:
+    """A parsed file: raw bytes, tree-sitter tree and line offset table."""
+
+    data: bytes
+    digest: str
+    tree: Tree
+    line_offsets: List[int]
+
+    @property
+    def root_node(self) -> Node:
+        return self.tree.root_node
+
+    @property
+    def line_count(self) -> int:
+        """Number of lines (a trailing newline does not start a new line)."""
+        count = len(self.line_offsets)
+        if count > 1 and self.line_offsets[-1] == len(self.data):
+            count -= 1
+        return count
+
+
+class ParseCache:
+    """Cache of file contents and parse trees."""
+
+    def __init__(self):
+        self._lock = threading.RLock()
+        # Parsers are not thread-safe: one per thread and language
+        self._local = threading.local()
+        self._languages = set()
+        # (language, digest) -> ParsedSource
+        self._parsed: Dict[Tuple[Language, str], ParsedSource] = {}
+        # (language, id(data)) -> ParsedSource, so callers passing cached bytes back in skip hashing
+        self._by_identity: Dict[Tuple[Language, int], ParsedSource] = {}
+        # resolved path -> (mtime_ns, size, data)
+        self._files: Dict[Path, Tuple[int, int, bytes]] = {}
+        # id(data) -> (data, digest) for bytes handed out by read(); ids of those bytes objects
+        self._digests: Dict[int, Tuple[bytes, str]] = {}
+        self._file_data_ids = set()
+        # (digest, key) -> artifact derived from the content (symbol tables etc.)
+        self._derived: Dict[Tuple[str, str], Any] = {}
+        # id(new data) -> previous content of the same file, for incremental re-parsing
+        self._previous: Dict[int, bytes] = {}
+        # Where file contents come from instead of the file system (e.g. a GitTreeSource for a commit)
+        self.source = None
+        # Where derived artifacts are shared with other processes (see SharedAnalysis)
+        self.shared = None
+        # Estimated bytes the cache may hold (None: unbounded), see set_memory_budget()
+        self.memory_budget: Optional[int] = None
+        self.large_file_bytes = LARGE_FILE_BYTES
+        # digest -> estimated [file, tree, derived] bytes, least recently used first
+        self._costs: "OrderedDict[str, List[int]]" = OrderedDict()
+        # digest -> content length, and the derived keys stored for it
+        self._sizes: Dict[str, int] = {}
+        self._derived_keys: Dict[str, set] = {}
+        self.memory_used = 0
+        self.memory_peak = 0
+        self.evictions = 0
+        self.hits = 0
+        self.misses = 0
+        self.incremental = 0
+
+    def read(self, file_path: Path) -> bytes:
+        """
+        Read a file's bytes, reusing the cached copy if the file is unchanged.
+
+        Returning the same bytes object for an unchanged file lets parse() find
+        the tree by identity without re-hashing the content.
+        """
+        if self.source is not None:
+            return self._read_from_source(file_path)
+
+        key = file_path.resolve()
+        stat = key.stat()
+
+        with self._lock:
+            cached = self._files.get(key)
+            if cached and cached[0] == stat.st_mtime_ns and cached[1] == stat.st_size:
+                self._touch(cached[2])
+                return cached[2]
+
+        with profiler.stage("read", str(key)):
+            data = key.read_bytes()
+        with self._lock:
+            # Another thread may have read the same file meanwhile; hand out one bytes object
+            current = self._files.get(key)
+            if current and current[0] == stat.st_mtime_ns and current[1] == stat.st_size:
+                return current[2]
+            cached = current
+            if cached:
+                old = cached[2]
+                old_digest = self._digests.pop(id(old), None)
+                if old_digest is not None:
+                    self._uncharge(old_digest[1], _FILE, len(old))
+                    if not self._held_by_other_file(old_digest[1], old):
+                        # Tables of the old content are not needed again; its tree is kept for re-parsing
+                        self._drop_derived(old_digest[1])
+                self._file_data_ids.discard(id(old))
+                # If the old content was never parsed, keep diffing against the last parsed one
+                base = self._previous.pop(id(old), old)
+                if base != data:
+                    self._previous[id(data)] = base
+            self._files[key] = (stat.st_mtime_ns, stat.st_size, data)
+            self._file_data_ids.add(id(data))
+        self._name_content(data, key)
+        if self.memory_budget is not None:
+            digest = self.digest(data)
+            with self._lock:
+                self._charge(digest, _FILE, len(data))
+        return data
+
+    def _read_from_source(self, file_path: Path) -> bytes:
+        """Read through the configured source, which supplies the blob hash along with the bytes."""
+        data, digest = self.source.read(file_path)
+        with self._lock:
+            if id(data) in self._file_data_ids:
+                return data
+            self._file_data_ids.add(id(data))
+            self._digests[id(data)] = (data, digest)
+            self._sizes[digest] = len(data)
+        self._name_content(data, file_path)
+        return data
+
+    @staticmethod
+    def _name_content(data: bytes, file_path: Path) -> None:
+        """Let the profiler attribute parses of newly read bytes to their file."""
+        active = profiler.get_profiler()
+        if active is not None:
+            active.name_content(data, file_path)
+
+    def set_memory_budget(self, budget: Optional[int]) -> None:
+        """
+        Bound the estimated memory the cache holds, evicting least recently used contents.
+
+        Set it before the cache fills: only contents cached afterwards are accounted.
+
+        Args:
+            budget: Bytes, or None for no limit
+        """
+        with self._lock:
+            self.memory_budget = budget
+            if budget is None:
+                # Accounting restarts from scratch if a budget is set again
+                self._costs.clear()
+                self._sizes.clear()
+                self._derived_keys.clear()
+                self.memory_used = 0
+                self.memory_peak = 0
+            else:
+                self._enforce_budget(None)
+
+    def _touch(self, data: bytes) -> None:
+        """Mark the content of cached bytes as recently used."""
+        cached = self._digests.get(id(data))
+        if cached is not None and cached[0] is data:
+            self._touch_digest(cached[1])
+
+    def _touch_digest(self, digest: str) -> None:
+        if digest in self._costs:
+            self._costs.move_to_end(digest)
+
+    def _charge(self, digest: str, part: int, nbytes: int) -> None:
+        """Account memory now held for a content (lock held) and evict others if over budget."""
+        if self.memory_budget is None:
+            return
+        cost = self._costs.get(digest)
+        if cost is None:
+            cost = self._costs[digest] = [0, 0, 0]
+        else:
+            self._costs.move_to_end(digest)
+        cost[part] += nbytes
+        self.memory_used += nbytes
+        self.memory_peak = max(self.memory_peak, self.memory_used)
+        self._enforce_budget(digest)
+
+    def _uncharge(self, digest: str, part: int, nbytes: int) -> None:
+        """Account memory released for a content (lock held)."""
+        cost = self._costs.get(digest)
+        if cost is not None:
+            released = min(nbytes, cost[part])
+            cost[part] -= released
+            self.memory_used -= released
+
+    def _enforce_budget(self, keep: Optional[str]) -> None:
+        """Evict least recently used contents, except keep, until the budget holds (lock held)."""
+        while self.memory_used > self.memory_budget:
+            victim = next((digest for digest in self._costs if digest != keep), None)
+            if victim is None:
+                break
+            self._evict_content(victim)
+
+    def _evict_content(self, digest: str) -> None:
+        """Forget everything cached for one content: trees, derived artifacts and file bytes (lock held)."""
+        for language in self._languages:
+            entry = self._parsed.pop((language, digest), None)
+            if entry is not None:
+                self._by_identity.pop((language, id(entry.data)), None)
+        self._drop_derived(digest)
+        for path, (_, _, data) in list(self._files.items()):
+            cached = self._digests.get(id(data))
+            if cached is not None and cached[0] is data and cached[1] == digest:
+                del self._files[path]
+                self._previous.pop(id(data), None)
+        for data_id in [data_id for data_id, (_, cached) in self._digests.items() if cached == digest]:
+            del self._digests[data_id]
+            self._file_data_ids.discard(data_id)
+
+        self.memory_used -= sum(self._costs.pop(digest, ()))
+        self._sizes.pop(digest, None)
+        self.evictions += 1
+        profiler.count("parse cache evictions")
+        logger.debug(f"Evicted {digest[:8]} from the parse cache ({self.memory_used} bytes held)")
+
+    def is_cached(self, file_path: Path) -> bool:
+        """Whether a file's bytes are cached (read from the file system)."""
+        with self._lock:
+            return file_path.resolve() in self._files
+
+    def cached_paths(self) -> List[Path]:
+        """Resolved paths of the files read from the file system so far."""
+        with self._lock:
+            return list(self._files)
+
+    def set_source(self, source) -> None:
+        """
+        Read files through another source than the file system.
+
+        Args:
+            source: Object with read(path) -> (bytes, blob hash) such as GitTreeSource, or None for the file system
+        """
+        with self._lock:
+            self.source = source
+
+    def set_shared(self, shared) -> None:
+        """
+        Share derived artifacts with other processes.
+
+        Args:
+            shared: Object with load(digest, key) and publish(digest, key, value) such as
+                    SharedAnalysis, or None to keep artifacts private
+        """
+        with self._lock:
+            self.shared = shared
+
+    def digest(self, data: bytes) -> str:
+        """Content hash of source bytes, memoized for bytes returned by read() or parse()."""
+        with self._lock:
+            cached = self._digests.get(id(data))
+            if cached is not None and cached[0] is data:
+                return cached[1]
+            for language in self._languages:
+                entry = self._by_identity.get((language, id(data)))
+                if entry is not None and entry.data is data:
+                    return entry.digest
+
+            digest = blob_hash(data)
+            self._sizes[digest] = len(data)
+            if id(data) in self._file_data_ids:
+                self._digests[id(data)] = (data, digest)
+            return digest
+
+    def derived(self, digest: str, key: str, build: Callable[[], Any]) -> Any:
+        """
+        Get an artifact computed from content with the given digest, building it once.
+
+        Args:
+            digest: Content hash from digest()
+            key: Artifact kind (e.g. "cpp_symbols")
+            build: Called to compute the artifact on first use
+        """
+        with self._lock:
+            value = self._derived.get((digest, key))
+            if value is not None:
+                self._touch_digest(digest)
+        if value is not None:
+            profiler.count(f"{key} hits")
+            return value
+
+        # Built without the lock; if two threads race, the first stored value wins
+        shared = self.shared
+        value = shared.load(digest, key) if shared is not None else None
+        if value is None:
+            profiler.count(f"{key} builds")
+            with profiler.stage("derive", key, digest=digest[:8]):
+                value = build()
+            if shared is not None:
+                shared.publish(digest, key, value)
+        else:
+            profiler.count(f"{key} shared")
+        with self._lock:
+            stored = self._derived.setdefault((digest, key), value)
+            if stored is value:
+                self._derived_keys.setdefault(digest, set()).add(key)
+                self._charge(digest, _DERIVED, int(self._sizes.get(digest, 0) * DERIVED_BYTES_PER_SOURCE_BYTE))
+            return stored
+
+    def line_offsets(self, data: bytes) -> List[int]:
+        """Line start offsets of source bytes, built once per content."""
+        return self.derived(self.digest(data), "line_offsets", lambda: build_line_offsets(data))
+
+    def lines(self, data: bytes, start_line: int, end_line: int) -> str:
+        """Decode lines start_line..end_line (1-based, inclusive) of source bytes."""
+        return slice_lines(data, self.line_offsets(data), start_line, end_line)
+
+    def parse(self, language: Language, data: bytes) -> ParsedSource:
+        """Parse source bytes, returning the cached tree if this content was seen before."""
+        with self._lock:
+            entry = self._by_identity.get((language, id(data)))
+            if entry is not None and entry.data is data:
+                self.hits += 1
+                profiler.count("parse cache hits")
+                self._touch_digest(entry.digest)
+                return entry
+
+            digest = self.digest(data)
+            entry = self._parsed.get((language, digest))
+            if entry is not None:
+                self.hits += 1
+                profiler.count("parse cache hits")
+                self._touch_digest(digest)
+                return self._map_identity(language, entry)
+
+            self.misses += 1
+            profiler.count("parse cache misses")
+            self._languages.add(language)
+            previous = self._previous_entry(language, data)
+        line_offsets = self.line_offsets(data)
+
+        # Parse outside the lock so other threads can read and parse meanwhile
+        parser = self._parser(language)
+        active = profiler.get_profiler()
+        name = active.content_name(data) if active is not None else ""
+        with profiler.stage("parse", name, bytes=len(data), incremental=previous is not None):
+            if previous is not None:
+                # Edit a copy: the old entry may still be handed out for its own content
+                old_tree = previous.tree.copy()
+                old_tree.edit(**compute_edit(previous.data, data, previous.line_offsets, line_offsets))
+                tree = parser.parse(data, old_tree)
+                logger.debug(f"Re-parsed {len(data)} bytes incrementally ({digest[:8]})")
+            else:
+                tree = parser.parse(data)
+                logger.debug(f"Parsed {len(data)} bytes ({digest[:8]})")
+
+        with self._lock:
+            entry = self._parsed.get((language, digest))
+            if entry is None:
+                entry = ParsedSource(data=data, digest=digest, tree=tree, line_offsets=line_offsets)
+                self._parsed[(language, digest)] = entry
+                if previous is not None:
+                    self.incremental += 1
+                    self._drop_superseded(language, previous)
+                self._charge(digest, _TREE, TREE_BYTES_PER_SOURCE_BYTE * len(data))
+            return self._map_identity(language, entry)
+
+    def _map_identity(self, language: Language, entry: ParsedSource) -> ParsedSource:
+        # The entry holds a reference to its bytes, so the id cannot be reused while it is mapped
+        self._by_identity[(language, id(entry.data))] = entry
+        return entry
+
+    def _parser(self, language: Language) -> Parser:
+        """This thread's parser for a language."""
+        parsers = getattr(self._local, "parsers", None)
+        if parsers is None:
+            parsers = self._local.parsers = {}
+        parser = parsers.get(language)
+        if parser is None:
+            parser = parsers[language] = Parser(language)
+        return parser
+
+    def _previous_entry(self, language: Language, data: bytes) -> Optional[ParsedSource]:
+        """Parsed entry of the content this file had before, if it was parsed with this language."""
+        previous = self._previous.pop(id(data), None)
+        if previous is None:
+            return None
+        return self._parsed.get((language, self.digest(previous)))
+
+    def _drop_superseded(self, language: Language, entry: ParsedSource) -> None:
+        """
+        Forget the tree and derived artifacts of a file's old content, unless another
+        cached file still has that content.
+        """
+        if any(cached_data == entry.data for _, _, cached_data in self._files.values()):
+            return
+        self._parsed.pop((language, entry.digest), None)
+        self._by_identity.pop((language, id(entry.data)), None)
+        self._uncharge(entry.digest, _TREE, TREE_BYTES_PER_SOURCE_BYTE * len(entry.data))
+        self._drop_derived(entry.digest)
+        if not any(parsed_digest == entry.digest for _, parsed_digest in self._parsed):
+            self.memory_used -= sum(self._costs.pop(entry.digest, ()))
+            self._sizes.pop(entry.digest, None)
+
+    def _held_by_other_file(self, digest: str, data: bytes) -> bool:
+        """Whether a cached file other than these bytes has the content with this digest (lock held)."""
+        for _, _, cached_data in self._files.values():
+            if cached_data is not data:
+                cached = self._digests.get(id(cached_data))
+                if cached is not None and cached[1] == digest:
+                    return True
+        return False
+
+    def _drop_derived(self, digest: str) -> None:
+        """Forget the artifacts derived from a content (lock held)."""
+        # Scanned rather than taken from _derived_keys, which is reset along with the memory budget
+        for derived_key in [derived_key for derived_key in self._derived if derived_key[0] == digest]:
+            del self._derived[derived_key]
+        self._derived_keys.pop(digest, None)
+        cost = self._costs.get(digest)
+        if cost is not None:
+            self.memory_used -= cost[_DERIVED]
+            cost[_DERIVED] = 0
+
+    def parse_file(self, language: Language, file_path: Path) -> ParsedSource:
+        """Read and parse a file through the cache."""
+        return self.parse(language, self.read(file_path))
+
+    def evict(self, data: bytes) -> None:
+        """Drop the trees parsed from these bytes (file contents and derived artifacts are kept)."""
+        with self._lock:
+            digest = self.digest(data)
+            for key in [k for k, entry in self._parsed.items() if entry.digest == digest]:
+                entry = self._parsed.pop(key)
+                self._by_identity.pop((key[0], id(entry.data)), None)
+                self._uncharge(digest, _TREE, TREE_BYTES_PER_SOURCE_BYTE * len(entry.data))
+
+    def release(self, data: bytes) -> None:
+        """Drop the trees parsed from these bytes and the cached file bytes themselves (derived artifacts are kept)."""
+        self.evict(data)
+        with self._lock:
+            digest = self.digest(data)
+            for path, (_, _, cached_data) in list(self._files.items()):
+                if cached_data is data:
+                    del self._files[path]
+            self._previous.pop(id(data), None)
+            self._file_data_ids.discard(id(data))
+            cached = self._digests.get(id(data))
+            if cached is not None and cached[0] is data:
+                del self._digests[id(data)]
+                self._uncharge(digest, _FILE, len(data))
+
+    def release_large(self, data: bytes) -> bool:
+        """
+        Drop the trees of a large file's content once its snippets are extracted.
+
+        The file bytes and derived tables (symbols, markers, line offsets) stay cached,
+        so later lookups that only need those do not re-parse. Derived tables hold plain
+        data, never tree-sitter nodes (a node keeps its whole tree alive), so the tree
+        is actually freed.
+
+        Returns:
+            Whether the content counted as large
+        """
+        if len(data) < self.large_file_bytes:
+            return False
+        self.evict(data)
+        return True
+
+    def clear(self) -> None:
+        """Drop all cached files and trees."""
+        with self._lock:
+            self._parsed.clear()
+            self._by_identity.clear()
+            self._files.clear()
+            self._digests.clear()
+            self._file_data_ids.clear()
+            self._derived.clear()
+            self._previous.clear()
+            self._costs.clear()
+            self._sizes.clear()
+            self._derived_keys.clear()
+            self.memory_used = 0
+            self.memory_peak = 0
+            self.evictions = 0
+            self.hits = 0
+            self.misses = 0
+            self.incremental = 0
+
+
+# Process-wide cache instance
+_parse_cache: Optional[ParseCache] = None
+
+
+def get_parse_cache() -> ParseCache:
+    """Get the process-wide parse cache."""
+    global _parse_cache
+    if _parse_cache is None:
+        _parse_cache = ParseCache()
+    return _parse_cache
@@ -0,0 +1,196 @@
+"""
+Per-stage timing of renders (render --profile).
+
+Instrumented code wraps each stage in `with stage(category, name): ...`: templates,
+code() snippets, file reads, tree-sitter parses, derived artifact builds (symbol
+tables - the qualified-name traversal - and macro invocation queries), extraction
+and git subprocesses. Without a profiler configured stage() is a no-op; with one,
+every stage becomes a timed event with its own (exclusive) time, so a template's
+self time is the Jinja evaluation around its snippets.
+
+Events use the system-wide monotonic clock, so events of worker processes can be
+merged into the parent's profile. The profile is reported as a breakdown (see
+Profiler.summary()) or written as Chrome trace-event JSON for chrome://tracing
+and Perfetto.
+"""
+
+import json
+import os
+import threading
+import time
+from collections import Counter, defaultdict
+from contextlib import contextmanager, nullcontext
+from pathlib import Path
+from typing import Any, Dict, Iterator, List, NamedTuple, Optional
+
+
+class Event(NamedTuple):
+    """One timed stage."""
+
+    category: str
+    name: str
+    # perf_counter_ns() at the start, duration and duration minus nested stages
+    start_ns: int
+    duration_ns: int
+    self_ns: int
+    pid: int
+    tid: int
+    args: Dict[str, Any]
+
+
+class Profiler:
+    """Collects stage events and counters; safe to use from several threads."""
+
+    def __init__(self):
+        self._lock = threading.Lock()
+        self._local = threading.local()
+        self.events: List[Event] = []
+        self.counters: Counter = Counter()
+        # id(bytes) -> path the content was read from, to attribute parses to files
+        self._content_names: Dict[int, str] = {}
+
+    @contextmanager
+    def stage(self, category: str, name: str, **args) -> Iterator[None]:
+        """Time the enclosed block as one event."""
+        stack = getattr(self._local, "stack", None)
+        if stack is None:
+            stack = self._local.stack = []
+        # Time spent in nested stages, subtracted for self time
+        stack.append(0)
+        started = time.perf_counter_ns()
+        try:
+            yield
+        finally:
+            duration = time.perf_counter_ns() - started
+            nested = stack.pop()
+            if stack:
+                stack[-1] += duration
+            pid, tid = os.getpid(), threading.get_ident()
+            event = Event(category, name, started, duration, duration - nested, pid, tid, args)
+            with self._lock:
+                self.events.append(event)
+
+    def count(self, name: str, n: int = 1) -> None:
+        """Add to a counter (cache hits, processes started, ...)."""
+        with self._lock:
+            self.counters[name] += n
+
+    def name_content(self, data: bytes, path: Path) -> None:
+        """Remember where source bytes were read from."""
+        with self._lock:
+            self._content_names[id(data)] = str(path)
+
+    def content_name(self, data: bytes) -> str:
+        """Path passed to name_content() for these bytes, or "<memory>"."""
+        with self._lock:
+            return self._content_names.get(id(data), "<memory>")
+
+    def merge(self, events: List[Event], counters: Dict[str, int]) -> None:
+        """Add the events and counters of another profiler (e.g. from a worker process)."""
+        with self._lock:
+            self.events.extend(Event(*event) for event in events)
+            self.counters.update(counters)
+
+    def export(self) -> tuple:
+        """(events, counters) as plain data for merge() in another process."""
+        with self._lock:
+            return [tuple(event) for event in self.events], dict(self.counters)
+
+    def summary(self, top: int = 10) -> Dict[str, Any]:
+        """
+        Aggregate the events.
+
+        Args:
+            top: Number of slowest snippets to list
+
+        Returns:
+            Dict with "stages" ({category: {"count", "total_ms", "self_ms"}}, by self time),
+            "snippets" (slowest code() calls), "parses" ({file: count}), "git"
+            ({"processes", "total_ms", "commands"}) and "counters"
+        """
+        with self._lock:
+            events = list(self.events)
+            counters = dict(self.counters)
+
+        stages: Dict[str, Dict[str, float]] = defaultdict(lambda: {"count": 0, "total_ms": 0.0, "self_ms": 0.0})
+        parses: Counter = Counter()
+        git_commands: Counter = Counter()
+        git_ms = 0.0
+        for event in events:
+            totals = stages[event.category]
+            totals["count"] += 1
+            totals["total_ms"] += event.duration_ns / 1e6
+            totals["self_ms"] += event.self_ns / 1e6
+            if event.category == "parse":
+                parses[event.name] += 1
+            elif event.category == "git":
+                git_commands[event.name] += 1
+                git_ms += event.duration_ns / 1e6
+
+        snippets = sorted((e for e in events if e.category == "snippet"), key=lambda e: e.duration_ns, reverse=True)
+        return {
+            "stages": dict(sorted(stages.items(), key=lambda item: item[1]["self_ms"], reverse=True)),
+            "snippets": [
+                {"name": e.name, "template": e.args.get("template"), "ms": e.duration_ns / 1e6} for e in snippets[:top]
+            ],
+            "parses": dict(parses.most_common()),
+            "git": {"processes": sum(git_commands.values()), "total_ms": git_ms, "commands": dict(git_commands)},
+            "counters": counters,
+        }
+
+    def trace_events(self) -> Dict[str, Any]:
+        """The events in Chrome trace-event format (complete events, microseconds from the first event)."""
+        with self._lock:
+            events = list(self.events)
+        origin = min((e.start_ns for e in events), default=0)
+        return {
+            "traceEvents": [
+                {
+                    "name": e.name,
+                    "cat": e.category,
+                    "ph": "X",
+                    "ts": (e.start_ns - origin) / 1000,
+                    "dur": e.duration_ns / 1000,
+                    "pid": e.pid,
+                    "tid": e.tid,
+                    "args": e.args,
+                }
+                for e in sorted(events, key=lambda e: e.start_ns)
+            ],
+            "displayTimeUnit": "ms",
+        }
+
+    def write_trace(self, path: Path) -> None:
+        """Write trace_events() as JSON."""
+        path.parent.mkdir(parents=True, exist_ok=True)
+        path.write_text(json.dumps(self.trace_events(), default=str))
+
+
+# Process-wide profiler (None when profiling is disabled)
+_profiler: Optional[Profiler] = None
+
+
+def get_profiler() -> Optional[Profiler]:
+    """Get the configured profiler, if any."""
+    return _profiler
+
+
+def set_profiler(profiler: Optional[Profiler]) -> None:
+    """Set (or clear) the process-wide profiler."""
+    global _profiler
+    _profiler = profiler
+
+
+def stage(category: str, name: str, **args):
+    """Context manager timing a stage on the configured profiler; does nothing without one."""
+    profiler = _profiler
+    if profiler is None:
+        return nullcontext()
+    return profiler.stage(category, name, **args)
+
+
+def count(name: str, n: int = 1) -> None:
+    """Add to a counter of the configured profiler, if any."""
+    profiler = _profiler
+    if profiler is not None:
+        profiler.count(name, n)
@@ -0,0 +1,165 @@
+"""
+Content-addressed cache of code() extraction results.
+
+An extraction is a pure function of the file content and the extraction arguments,
+so its result - (code_text, start_line, end_line) - is cached under a key built from
+the file's git blob hash, the arguments and a fingerprint of the installed tool.
+Permalinks, blame and line numbers are formatted from the cached result on every
+render. Entries are small JSON files written atomically, so one cache directory can
+be shared by concurrent renders and restored between CI jobs.
+
+The same directory holds full-file blame tables keyed by (commit, path), which are
+immutable; see GitMetadata.blame().
+"""
+
+import hashlib
+import json
+import logging
+import os
+import tempfile
+import threading
+from pathlib import Path
+from typing import Any, Dict, Optional, Tuple
+
+logger = logging.getLogger(__name__)
+
+# Bump when the entry layout changes
+CACHE_VERSION = 1
+BLAME_CACHE_VERSION = 1
+
+_fingerprint: Optional[str] = None
+
+
+def tool_fingerprint() -> str:
+    """Package version plus a hash of the package sources, so any code change invalidates entries."""
+    global _fingerprint
+    if _fingerprint is None:
+        from .. import __version__
+
+        package_dir = Path(__file__).resolve().parent.parent
+        digest = hashlib.sha1(f"{__version__}:{CACHE_VERSION}".encode("utf8"))
+        for source in sorted(package_dir.rglob("*.py")):
+            digest.update(source.relative_to(package_dir).as_posix().encode("utf8"))
+            digest.update(source.read_bytes())
+        _fingerprint = digest.hexdigest()
+    return _fingerprint
+
+
+def extraction_key(digest: str, extractor: str, arguments: Dict[str, Any]) -> str:
+    """
+    Cache key for one extraction.
+
+    Args:
+        digest: Blob hash of the source file
+        extractor: Extractor class name
+        arguments: Extraction arguments (JSON-serializable)
+    """
+    payload = json.dumps([tool_fingerprint(), digest, extractor, arguments], sort_keys=True, default=str)
+    return hashlib.sha1(payload.encode("utf8")).hexdigest()
+
+
+class RenderCache:
+    """Directory of cached extraction results."""
+
+    def __init__(self, cache_dir: Path):
+        """
+        Args:
+            cache_dir: Cache root; created if needed
+        """
+        self.cache_dir = Path(cache_dir)
+        self.cache_dir.mkdir(parents=True, exist_ok=True)
+        self.hits = 0
+        self.misses = 0
+        # Counters are updated from snippet prefetch threads too
+        self._lock = threading.Lock()
+
+    def _count(self, hit: bool) -> None:
+        with self._lock:
+            if hit:
+                self.hits += 1
+            else:
+                self.misses += 1
+
+    def _entry_path(self, key: str) -> Path:
+        return self.cache_dir / "extract" / key[:2] / f"{key}.json"
+
+    def get(self, key: str) -> Optional[Tuple[str, int, int]]:
+        """Cached (code_text, start_line, end_line), or None."""
+        try:
+            with open(self._entry_path(key), encoding="utf8") as f:
+                code_text, start_line, end_line = json.load(f)
+        except FileNotFoundError:
+            self._count(False)
+            return None
+        except (OSError, ValueError, TypeError) as e:
+            logger.warning(f"Ignoring corrupt render cache entry {key[:8]}: {e}")
+            self._count(False)
+            return None
+
+        self._count(True)
+        return code_text, start_line, end_line
+
+    def put(self, key: str, result: Tuple[str, int, int]) -> None:
+        """Store an extraction result (atomically, so concurrent readers never see partial entries)."""
+        self._write(self._entry_path(key), list(result), f"render cache entry {key[:8]}")
+
+    def _write(self, path: Path, payload: Any, label: str) -> None:
+        try:
+            path.parent.mkdir(parents=True, exist_ok=True)
+            fd, tmp_name = tempfile.mkstemp(dir=path.parent, suffix=".tmp")
+        except OSError as e:
+            logger.warning(f"Could not write {label}: {e}")
+            return
+
+        try:
+            with os.fdopen(fd, "w", encoding="utf8") as f:
+                json.dump(payload, f, separators=(",", ":"))
+            os.replace(tmp_name, path)
+        except OSError as e:
+            logger.warning(f"Could not write {label}: {e}")
+            Path(tmp_name).unlink(missing_ok=True)
+
+    def _blame_path(self, commit: str, path: str) -> Path:
+        key = hashlib.sha1(f"{BLAME_CACHE_VERSION}:{commit}:{path}".encode("utf8")).hexdigest()
+        return self.cache_dir / "blame" / key[:2] / f"{key}.json"
+
+    def get_blame(self, commit: str, path: str) -> Optional[Dict[str, Any]]:
+        """
+        Stored blame table of a file at a commit, or None.
+
+        Args:
+            commit: Full commit hash
+            path: File path relative to the repository root
+        """
+        try:
+            with open(self._blame_path(commit, path), encoding="utf8") as f:
+                entry = json.load(f)
+        except FileNotFoundError:
+            return None
+        except (OSError, ValueError) as e:
+            logger.warning(f"Ignoring corrupt blame cache entry for {path}: {e}")
+            return None
+
+        if not isinstance(entry, dict) or entry.get("commit") != commit or entry.get("path") != path:
+            return None
+        return entry.get("table")
+
+    def put_blame(self, commit: str, path: str, table: Dict[str, Any]) -> None:
+        """Store a file's blame table at a commit."""
+        entry = {"commit": commit, "path": path, "table": table}
+        self._write(self._blame_path(commit, path), entry, f"blame cache entry for {path}")
+
+
+# Process-wide render cache (None when caching is disabled)
+_render_cache: Optional[RenderCache] = None
+
+
+def get_render_cache() -> Optional[RenderCache]:
+    """Get the configured render cache, if any."""
+    return _render_cache
+
+
+def set_render_cache(cache: Optional[RenderCache]) -> None:
+    """Set (or clear) the process-wide render cache."""
+    global _render_cache
+    _render_cache = cache
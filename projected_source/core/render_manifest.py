@@ -0,0 +1,223 @@
+"""
+Manifest of the inputs each output of a directory render was built from.
+
+Every directory render writes `.projected-source-manifest.json` into the output
+directory. For each output it records:
+  - the template files loaded (the template, everything it includes, extends or
+    imports, and the .projected-source.py that was executed) with their blob hashes
+  - the source files code()/ghc()/ignore_changes() read, with their blob hashes
+    (at --commit when rendering a commit)
+  - the arguments of every such call
+  - the remote and commit, when a snippet carries a permalink or blame
+  - the blob hash of the output written
+
+`render --incremental` skips an output when all of these still match, so a change
+to one source file only re-renders the templates that read it. Entries are only
+valid for the tool build and render options that produced them (see settings).
+
+What custom tags or templates read outside of code() calls is not tracked, nor is
+a symbol gaining a better match in another file for code() calls without a path
+(the file they resolved to is).
+"""
+
+import json
+import logging
+import os
+import tempfile
+from dataclasses import dataclass, field
+from pathlib import Path
+from typing import Any, Callable, Dict, Iterable, List, Optional, Set, Tuple
+
+from .parse_cache import blob_hash, get_parse_cache
+from .render_cache import tool_fingerprint
+
+logger = logging.getLogger(__name__)
+
+MANIFEST_NAME = ".projected-source-manifest.json"
+
+# Bump when the entry layout changes
+MANIFEST_VERSION = 1
+
+
+@dataclass
+class TemplateInputs:
+    """What rendering one template read, collected by TemplateRenderer."""
+
+    # Template files loaded (the template itself, includes, extends, imports) and .projected-source.py
+    templates: Set[Path] = field(default_factory=set)
+    # .projected-source.py found for the template, None if there was none
+    custom_tags: Optional[Path] = None
+    # (resolved source path, call arguments) per code()/ghc()/ignore_changes() call
+    snippets: List[Tuple[Path, Dict[str, Any]]] = field(default_factory=list)
+    # Permalinks, blame or remapped lines: the output also depends on the commit rendered
+    commit_sensitive: bool = False
+
+
+def _key(path: Path, base: Path) -> str:
+    """Path as stored in the manifest: relative to base when inside it."""
+    try:
+        return path.relative_to(base.resolve()).as_posix()
+    except ValueError:
+        return path.as_posix()
+
+
+def file_hash(path: Path) -> Optional[str]:
+    """Blob hash of a file on disk, None if it cannot be read."""
+    try:
+        return blob_hash(path.read_bytes())
+    except OSError:
+        return None
+
+
+def source_hash(path: Path) -> Optional[str]:
+    """Blob hash of a source as code() reads it (through the parse cache, so at --commit if set)."""
+    cache = get_parse_cache()
+    try:
+        return cache.digest(cache.read(path))
+    except OSError:
+        return None
+
+
+def build_entry(renderer, template_name: str) -> Dict[str, Any]:
+    """
+    Manifest entry for a template the renderer just rendered.
+
+    The output hash is added by RenderManifest.record() once the output is written.
+
+    Args:
+        renderer: TemplateRenderer that rendered the template
+        template_name: Template name relative to the renderer's template directory
+
+    Returns:
+        JSON-serializable entry
+    """
+    inputs = renderer.inputs.get(template_name) or TemplateInputs()
+    repo_path = renderer.repo_path
+    commit = None
+    if inputs.commit_sensitive:
+        commit = [renderer.github.github_url, renderer.github.commit_hash]
+    return {
+        "template": template_name,
+        "templates": {_key(path, repo_path): file_hash(path) for path in sorted(inputs.templates)},
+        "custom_tags": _key(inputs.custom_tags, repo_path) if inputs.custom_tags else None,
+        "sources": {
+            _key(path, repo_path): source_hash(path) for path in sorted(renderer.dependencies.get(template_name, ()))
+        },
+        "snippets": [
+            [_key(path, repo_path), json.loads(json.dumps(arguments, sort_keys=True, default=str))]
+            for path, arguments in inputs.snippets
+        ],
+        "commit": commit,
+    }
+
+
+class RenderManifest:
+    """Manifest entries of one output directory, keyed by output path relative to it."""
+
+    def __init__(self, output_dir: Path, repo_path: Path, settings: Dict[str, Any] = None):
+        """
+        Args:
+            output_dir: Directory the outputs (and the manifest) are written to
+            repo_path: Repository root that stored paths are relative to
+            settings: Render options that affect every output (e.g. remap_dirty_lines)
+        """
+        self.path = output_dir / MANIFEST_NAME
+        self.repo_path = repo_path
+        self.settings = {"version": MANIFEST_VERSION, "tool": tool_fingerprint(), **(settings or {})}
+        self.outputs: Dict[str, Dict[str, Any]] = {}
+
+    @classmethod
+    def load(cls, output_dir: Path, repo_path: Path, settings: Dict[str, Any] = None) -> "RenderManifest":
+        """
+        Read the manifest of an earlier render.
+
+        Entries written by another tool build or with other settings are dropped, as
+        are unreadable manifests: every output is then out of date.
+        """
+        manifest = cls(output_dir, repo_path, settings)
+        try:
+            payload = json.loads(manifest.path.read_text(encoding="utf8"))
+        except FileNotFoundError:
+            return manifest
+        except (OSError, ValueError) as e:
+            logger.warning(f"Ignoring unreadable manifest {manifest.path}: {e}")
+            return manifest
+
+        if not isinstance(payload, dict) or payload.get("settings") != manifest.settings:
+            logger.info(f"{manifest.path} was written by another build or with other options")
+            return manifest
+        manifest.outputs = payload.get("outputs", {})
+        return manifest
+
+    def _resolve(self, key: str) -> Path:
+        return self.repo_path / key
+
+    def is_current(
+        self,
+        output_name: str,
+        template_name: str,
+        output_path: Path,
+        custom_tags: Optional[Path],
+        commit: Callable[[], List[Optional[str]]],
+    ) -> bool:
+        """
+        Whether an output is up to date with everything it was rendered from.
+
+        Args:
+            output_name: Output path relative to the output directory
+            template_name: Template the output is rendered from
+            output_path: The output file
+            custom_tags: .projected-source.py the template would load now, or None
+            commit: Returns the current [remote URL, commit hash]; only called for
+                    outputs holding permalinks or blame
+
+        Returns:
+            True if no input changed since the output was rendered
+        """
+        entry = self.outputs.get(output_name)
+        if entry is None or entry.get("template") != template_name:
+            return False
+        if file_hash(output_path) != entry.get("output"):
+            return False
+        if (_key(custom_tags, self.repo_path) if custom_tags else None) != entry.get("custom_tags"):
+            return False
+        for key, digest in entry["templates"].items():
+            if file_hash(self._resolve(key)) != digest:
+                return False
+        for key, digest in entry["sources"].items():
+            if source_hash(self._resolve(key)) != digest:
+                return False
+        return entry["commit"] is None or entry["commit"] == commit()
+
+    def record(self, output_name: str, entry: Dict[str, Any], output_path: Path) -> None:
+        """Store the entry of a freshly written output."""
+        self.outputs[output_name] = {**entry, "output": file_hash(output_path)}
+
+    def forget(self, output_name: str) -> None:
+        """Drop an output whose render failed, so the next render retries it."""
+        self.outputs.pop(output_name, None)
+
+    def save(self, keep: Iterable[str]) -> None:
+        """
+        Write the manifest atomically.
+
+        Args:
+            keep: Outputs whose templates still exist; entries of other outputs are dropped
+        """
+        keep = set(keep)
+        outputs = {name: entry for name, entry in sorted(self.outputs.items()) if name in keep}
+        payload = {"settings": self.settings, "outputs": outputs}
+        try:
+            self.path.parent.mkdir(parents=True, exist_ok=True)
+            fd, tmp_name = tempfile.mkstemp(dir=self.path.parent, suffix=".tmp")
+        except OSError as e:
+            logger.warning(f"Could not write {self.path}: {e}")
+            return
+
+        try:
+            with os.fdopen(fd, "w", encoding="utf8") as f:
+                json.dump(payload, f, indent=1, sort_keys=True)
+            os.replace(tmp_name, self.path)
+        except OSError as e:
+            logger.warning(f"Could not write {self.path}: {e}")
+            Path(tmp_name).unlink(missing_ok=True)
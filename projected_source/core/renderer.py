@@ -4,20 +4,67 @@ Jinja2 template rendering with code extraction functions.
 
 from __future__ import annotations
 
+import inspect
+import json
 import logging
+import re
+from concurrent.futures import ThreadPoolExecutor
 from pathlib import Path
-from typing import TYPE_CHECKING, Dict, Optional, Tuple, Union
+from typing import TYPE_CHECKING, Any, Dict, Iterator, List, Optional, Set, Tuple, Union
 
 import jinja2
 
 from ..languages import get_extractor
+from . import profiler
 from .github import GitHubIntegration
+from .parse_cache import get_parse_cache
+from .render_cache import extraction_key, get_render_cache
+from .render_manifest import TemplateInputs
 
 if TYPE_CHECKING:
     from .changes_set import ChangesSet
 
 logger = logging.getLogger(__name__)
 
+# Stand-in for a deferred code() call in the Jinja output; NUL never occurs in template text
+_PLACEHOLDER = "\x00snippet:{}\x00"
+_PLACEHOLDER_RE = re.compile(r"\x00snippet:(\d+)\x00")
+
+# code() arguments that select what is extracted (the rest only affect formatting)
+_CODE_SPEC_KEYS = (
+    "function",
+    "struct",
+    "var",
+    "function_macro",
+    "macro_definition",
+    "lines",
+    "marker",
+    "signature",
+    "message",
+    "enum",
+    "service",
+    "rpc",
+)
+
+# Markdown code fence language by file suffix
+LANGUAGE_BY_SUFFIX = {
+    ".cpp": "cpp",
+    ".cc": "cpp",
+    ".cxx": "cpp",
+    ".hpp": "cpp",
+    ".h": "cpp",
+    ".hxx": "cpp",
+    ".ipp": "cpp",  # Inline implementation files
+    ".c": "c",
+    ".py": "python",
+    ".js": "javascript",
+    ".ts": "typescript",
+    ".java": "java",
+    ".rs": "rust",
+    ".go": "go",
+    ".proto": "protobuf",
+}
+
 
 def _collect_error_fixture(file_path: Path, error: str, template_context: str = None):
     """Collect a file as a fixture if fixture collection is enabled."""
@@ -29,6 +76,65 @@ def _collect_error_fixture(file_path: Path, error: str, template_context: str =
         collector.collect(file_path, error, template_context)
 
 
+def _spec_key(code_spec: Dict[str, Any]) -> str:
+    return json.dumps(code_spec, sort_keys=True, default=str)
+
+
+def _snippet_label(args: tuple, kwargs: Dict[str, Any]) -> str:
+    """Short description of a code() call for profiles, e.g. "src/a.cpp function=main"."""
+    file_path = args[0] if args else kwargs.get("file_path")
+    selection = " ".join(f"{key}={kwargs[key]}" for key in _CODE_SPEC_KEYS if kwargs.get(key))
+    return f"{file_path or '<index>'} {selection}".strip()
+
+
+def find_custom_tags_file(start_path: Path, repo_path: Path) -> Optional[Path]:
+    """
+    Find .projected-source.py by walking up from start_path.
+    Stops at the repository root to avoid escaping the repository.
+
+    Args:
+        start_path: Path to start searching from (usually the template's directory)
+        repo_path: Repository root (the git root)
+
+    Returns:
+        Path to .projected-source.py if found, None otherwise
+    """
+    current = start_path.resolve()
+
+    while current >= repo_path:
+        custom_file = current / ".projected-source.py"
+        if custom_file.exists():
+            return custom_file
+
+        # Move up one directory
+        parent = current.parent
+        if parent == current:  # Reached filesystem root
+            break
+        current = parent
+
+    return None
+
+
+class _TrackingEnvironment(jinja2.Environment):
+    """Environment that reports every template it hands out, so includes, extends and imports are known."""
+
+    def __init__(self, *args, on_load=None, **kwargs):
+        super().__init__(*args, **kwargs)
+        self.on_load = on_load
+
+    def get_template(self, name, parent=None, globals=None):
+        template = super().get_template(name, parent, globals)
+        if self.on_load is not None:
+            self.on_load(template)
+        return template
+
+    def select_template(self, names, parent=None, globals=None):
+        template = super().select_template(names, parent, globals)
+        if self.on_load is not None:
+            self.on_load(template)
+        return template
+
+
 class TemplateRenderer:
     """Render Jinja2 templates with code extraction functions."""
 
@@ -38,6 +144,8 @@ class TemplateRenderer:
         repo_path: Path = None,
         remap_dirty_lines: bool = False,
         changes_set: "ChangesSet" = None,
+        commit: str = None,
+        resolve_workers: int = 1,
     ):
         """
         Initialize the renderer.
@@ -51,29 +159,65 @@ class TemplateRenderer:
             changes_set: Optional ChangesSet for tracking documentation coverage.
                          When provided, each code() call will mark its region as
                          covered. Check changes_set.uncovered() after rendering.
+            commit: Commit the sources are read at (see GitTreeSource); permalinks
+                    and blame use it instead of HEAD and the working tree.
+            resolve_workers: Above 1, code() calls only leave a placeholder during the
+                             Jinja pass. Their files are then read, parsed and extracted,
+                             and blame and diffs are collected, on this many threads
+                             before the placeholders are replaced. Filters applied to
+                             code() output see the placeholder, not the snippet.
         """
         self.template_dir = template_dir or Path.cwd()
         self.repo_path = repo_path or Path.cwd()
         self.remap_dirty_lines = remap_dirty_lines
         self.changes_set = changes_set
-        self.github = GitHubIntegration(self.repo_path)
+        self.github = GitHubIntegration(self.repo_path, commit=commit)
+        self.resolve_workers = resolve_workers
+
+        # Deferred code() calls of the template pass in progress ((args, kwargs) per placeholder)
+        self._pending: Optional[List[Tuple[tuple, Dict[str, Any]]]] = None
+        # Extractions done ahead of substitution, keyed by (path, code spec)
+        self._prefetched: Dict[Tuple[Path, str], Union[Tuple[str, int, int], str]] = {}
+
+        # Source files read by each rendered template (template name -> paths), for watch mode
+        self.dependencies: Dict[str, Set[Path]] = {}
+        # Templates, custom tags and code() calls of each rendered template, for the render manifest
+        self.inputs: Dict[str, TemplateInputs] = {}
+        self._current_template: Optional[str] = None
 
         # Create Jinja2 environment
-        self.env = jinja2.Environment(
-            loader=jinja2.FileSystemLoader(str(self.template_dir)), trim_blocks=True, lstrip_blocks=True
+        self.env = _TrackingEnvironment(
+            loader=jinja2.FileSystemLoader(str(self.template_dir)),
+            trim_blocks=True,
+            lstrip_blocks=True,
+            on_load=self._record_template,
         )
 
         # Register custom functions
-        self.env.globals["code"] = self._code_function
-        self.env.globals["ghc"] = self._code_function  # Alias for compatibility
+        self.env.globals["code"] = self._code_call
+        self.env.globals["ghc"] = self._code_call  # Alias for compatibility
         self.env.globals["ignore_changes"] = self._ignore_changes_function
 
         # Load project-specific custom tags if available
         # (loaded on-demand when rendering templates)
 
+    def _code_call(self, *args, **kwargs) -> str:
+        """code() as seen by templates: extract now, or record the call while snippets are deferred."""
+        if self._pending is None:
+            return self._snippet(args, kwargs)
+        self._pending.append((args, kwargs))
+        return _PLACEHOLDER.format(len(self._pending) - 1)
+
+    def _snippet(self, args: tuple, kwargs: Dict[str, Any]) -> str:
+        """Run one code() call, timed as a snippet when profiling."""
+        if profiler.get_profiler() is None:
+            return self._code_function(*args, **kwargs)
+        with profiler.stage("snippet", _snippet_label(args, kwargs), template=self._current_template):
+            return self._code_function(*args, **kwargs)
+
     def _code_function(
         self,
-        file_path: str,
+        file_path: str = None,
         function: str = None,
         struct: str = None,
         var: str = None,
@@ -85,6 +229,7 @@ class TemplateRenderer:
         message: str = None,
         enum: str = None,
         service: str = None,
+        rpc: str = None,
         github: bool = True,
         blame: bool = False,
         line_numbers: bool = True,
@@ -94,7 +239,9 @@ class TemplateRenderer:
         Universal code extraction function for templates.
 
         Args:
-            file_path: Path to the source file
+            file_path: Path to the source file. May be omitted for function, struct, var,
+                       macro_definition and function_macro: the file is then looked up in
+                       the symbol index (see symbol_resolver.py)
             function: Function name to extract
             struct: Struct/class/enum name to extract (C/C++)
             var: Variable/constant declaration to extract (C/C++)
@@ -107,6 +254,8 @@ class TemplateRenderer:
             message: Message name to extract (protobuf)
             enum: Enum name to extract (protobuf)
             service: Service name to extract (protobuf)
+            rpc: Rpc name to extract, optionally with its service like "PeerService.Ping" (protobuf).
+                 Proto names may be nested: message='Outer.Inner'
             github: Include GitHub permalink (default: True)
             blame: Include git blame info (default: False)
             line_numbers: Show line numbers (default: True)
@@ -124,108 +273,38 @@ class TemplateRenderer:
             {{ code('src/file.cpp', marker='example1') }}
             {{ code('src/proto/file.proto', message='MyMessage') }}
             {{ code('src/proto/file.proto', enum='MyEnum') }}
+            {{ code('src/proto/file.proto', rpc='MyService.Method') }}
+            {{ code(function='ns::MyClass::method') }}
         """
+        resolved_path = None
         try:
-            # Resolve file path relative to repo
-            resolved_path = Path(file_path)
-            if not resolved_path.is_absolute():
-                resolved_path = self.repo_path / resolved_path
+            symbol = (function, struct, var, function_macro, macro_definition)
+            resolved_path, file_path = self._snippet_path(file_path, *symbol, signature)
+            self._record_dependency(resolved_path)
+
+            code_spec = {
+                "function": function,
+                "struct": struct,
+                "var": var,
+                "function_macro": function_macro,
+                "macro_definition": macro_definition,
+                "lines": lines,
+                "marker": marker,
+                "signature": signature,
+                "message": message,
+                "enum": enum,
+                "service": service,
+                "rpc": rpc,
+            }
+            formatting = {"github": github, "blame": blame, "line_numbers": line_numbers, "language": language}
+            self._record_snippet(resolved_path, {**code_spec, **formatting}, commit_sensitive=github or blame)
 
             # Get the appropriate extractor
             extractor = get_extractor(resolved_path)
-
-            # Extract code based on parameters
-            if function:
-                # Check if we also have a marker - extract marker within function
-                if marker:
-                    if hasattr(extractor, "extract_function_marker"):
-                        code_text, start_line, end_line = extractor.extract_function_marker(
-                            resolved_path, function, marker
-                        )
-                        logger.info(f"Extracted marker '{marker}' from function '{function}' in {file_path}")
-                    else:
-                        return "❌ **ERROR**: Function marker extraction not supported for this file type"
-                else:
-                    code_text, start_line, end_line = extractor.extract_function(resolved_path, function, signature)
-                    logger.info(f"Extracted function '{function}' from {file_path}")
-            elif function_macro:
-                # Handle function_macro parameter
-                if isinstance(function_macro, str):
-                    # Simple string -> convert to dict
-                    macro_spec = {"name": function_macro}
-                else:
-                    macro_spec = function_macro
-
-                # Check if we also have a marker - extract marker within macro
-                if marker:
-                    code_text, start_line, end_line = extractor.extract_function_macro_marker(
-                        resolved_path, macro_spec, marker
-                    )
-                    logger.info(f"Extracted marker '{marker}' from function_macro '{macro_spec}' in {file_path}")
-                else:
-                    code_text, start_line, end_line = extractor.extract_function_macro(resolved_path, macro_spec)
-                    logger.info(f"Extracted function_macro '{macro_spec}' from {file_path}")
-            elif macro_definition:
-                code_text, start_line, end_line = extractor.extract_macro_definition(resolved_path, macro_definition)
-                logger.info(f"Extracted macro_definition '{macro_definition}' from {file_path}")
-            elif struct or var:
-                # Extract struct/class/enum/variable (for C/C++)
-                name = struct or var
-                kind = "struct/class/enum" if struct else "variable"
-                if hasattr(extractor, "extract_struct"):
-                    if marker:
-                        # Extract marker within struct/var
-                        if hasattr(extractor, "extract_struct_marker"):
-                            code_text, start_line, end_line = extractor.extract_struct_marker(
-                                resolved_path, name, marker
-                            )
-                            logger.info(f"Extracted marker '{marker}' from {kind} '{name}' in {file_path}")
-                        else:
-                            return f"❌ **ERROR**: Marker extraction in {kind} not supported"
-                    else:
-                        code_text, start_line, end_line = extractor.extract_struct(resolved_path, name)
-                        logger.info(f"Extracted {kind} '{name}' from {file_path}")
-                else:
-                    return f"❌ **ERROR**: {kind.capitalize()} extraction not supported for this file type"
-            elif message:
-                # Extract protobuf message
-                if hasattr(extractor, "extract_message"):
-                    if marker:
-                        code_text, start_line, end_line = extractor.extract_message_marker(
-                            resolved_path, message, marker
-                        )
-                        logger.info(f"Extracted marker '{marker}' from message '{message}' in {file_path}")
-                    else:
-                        code_text, start_line, end_line = extractor.extract_message(resolved_path, message)
-                        logger.info(f"Extracted message '{message}' from {file_path}")
-                else:
-                    return "❌ **ERROR**: Message extraction not supported for this file type"
-            elif enum:
-                # Extract protobuf enum
-                if hasattr(extractor, "extract_enum"):
-                    code_text, start_line, end_line = extractor.extract_enum(resolved_path, enum)
-                    logger.info(f"Extracted enum '{enum}' from {file_path}")
-                else:
-                    return "❌ **ERROR**: Enum extraction not supported for this file type"
-            elif service:
-                # Extract protobuf service
-                if hasattr(extractor, "extract_service"):
-                    code_text, start_line, end_line = extractor.extract_service(resolved_path, service)
-                    logger.info(f"Extracted service '{service}' from {file_path}")
-                else:
-                    return "❌ **ERROR**: Service extraction not supported for this file type"
-            elif marker:
-                code_text, start_line, end_line = extractor.extract_marker(resolved_path, marker)
-                logger.info(f"Extracted marker '{marker}' from {file_path}")
-            elif lines:
-                start_line, end_line = lines
-                code_text, start_line, end_line = extractor.extract_lines(resolved_path, start_line, end_line)
-                logger.info(f"Extracted lines {start_line}-{end_line} from {file_path}")
-            else:
-                return (
-                    f"❌ **ERROR**: Must specify function, struct, var, function_macro, "
-                    f"macro_definition, lines, or marker for {file_path}"
-                )
+            extracted = self._extract_cached(extractor, resolved_path, file_path, code_spec)
+            if isinstance(extracted, str):
+                return extracted
+            code_text, start_line, end_line = extracted
 
             # Track this region as covered if we have a ChangesSet
             if self.changes_set is not None:
@@ -260,25 +339,7 @@ class TemplateRenderer:
 
             # Auto-detect language if not specified
             if not language:
-                suffix = resolved_path.suffix.lower()
-                language_map = {
-                    ".cpp": "cpp",
-                    ".cc": "cpp",
-                    ".cxx": "cpp",
-                    ".hpp": "cpp",
-                    ".h": "cpp",
-                    ".hxx": "cpp",
-                    ".ipp": "cpp",  # Inline implementation files
-                    ".c": "c",
-                    ".py": "python",
-                    ".js": "javascript",
-                    ".ts": "typescript",
-                    ".java": "java",
-                    ".rs": "rust",
-                    ".go": "go",
-                    ".proto": "protobuf",
-                }
-                language = language_map.get(suffix, "text")
+                language = LANGUAGE_BY_SUFFIX.get(resolved_path.suffix.lower(), "text")
 
             # Build final output
             return f"{header}\n```{language}\n{code_text}\n```"
@@ -287,9 +348,288 @@ class TemplateRenderer:
             error_msg = f"❌ **ERROR**: {e}"
             logger.error(f"Code extraction failed: {e}")
             # Collect file as fixture if collection is enabled
-            _collect_error_fixture(resolved_path, str(e))
+            if resolved_path is not None:
+                _collect_error_fixture(resolved_path, str(e))
             return error_msg
 
+    def extract_snippet(self, file_path: str = None, **selection) -> Dict[str, Any]:
+        """
+        Extract one snippet as data rather than markdown (see the `extract` command).
+
+        Args:
+            file_path: Path to the source file, or None to look the symbol up (as in code())
+            **selection: code() selection arguments (function, struct, marker, lines, signature, ...)
+
+        Returns:
+            Dict with "file" (repository-relative), "start_line", "end_line", "code",
+            "language" and "permalink" (GitHub URL at committed line numbers, or None)
+
+        Raises:
+            ValueError: For unknown arguments or selections the file type does not support
+            FileNotFoundError: If the file does not exist
+        """
+        unknown = set(selection) - set(_CODE_SPEC_KEYS)
+        if unknown:
+            raise ValueError(f"Unknown argument(s): {', '.join(sorted(unknown))}")
+        code_spec = {key: selection.get(key) for key in _CODE_SPEC_KEYS}
+        symbol = [code_spec[key] for key in ("function", "struct", "var", "function_macro", "macro_definition")]
+        resolved_path, file_path = self._snippet_path(file_path, *symbol, code_spec["signature"])
+        self._record_dependency(resolved_path)
+        self._record_snippet(resolved_path, code_spec, commit_sensitive=True)
+
+        extracted = self._extract_cached(get_extractor(resolved_path), resolved_path, file_path, code_spec)
+        if isinstance(extracted, str):
+            raise ValueError(extracted.replace("❌ **ERROR**: ", ""))
+        code_text, start_line, end_line = extracted
+        if self.changes_set is not None:
+            self.changes_set.subtract(resolved_path, start_line, end_line)
+
+        try:
+            rel_path = resolved_path.relative_to(self.repo_path)
+        except ValueError:
+            rel_path = resolved_path
+        return {
+            "file": rel_path.as_posix(),
+            "start_line": start_line,
+            "end_line": end_line,
+            "code": code_text,
+            "language": LANGUAGE_BY_SUFFIX.get(resolved_path.suffix.lower(), "text"),
+            "permalink": self.github.permalink_url(resolved_path, start_line, end_line),
+        }
+
+    def _snippet_path(
+        self,
+        file_path: Optional[str],
+        function: Optional[str],
+        struct: Optional[str],
+        var: Optional[str],
+        function_macro: Union[str, Dict, None],
+        macro_definition: Optional[str],
+        signature: Optional[str],
+    ) -> Tuple[Path, str]:
+        """
+        File a code() call reads.
+
+        Returns:
+            (path under repo_path, path as shown in logs)
+        """
+        if file_path is None:
+            found = self._resolve_symbol_file(function, struct, var, function_macro, macro_definition, signature)
+            # Index paths are fully resolved; keep them under repo_path as spelled for permalinks
+            try:
+                file_path = str(found.relative_to(self.repo_path.resolve()))
+            except ValueError:
+                file_path = str(found)
+
+        # Resolve file path relative to repo
+        resolved_path = Path(file_path)
+        if not resolved_path.is_absolute():
+            resolved_path = self.repo_path / resolved_path
+        return resolved_path, file_path
+
+    @staticmethod
+    def _resolve_symbol_file(
+        function: Optional[str],
+        struct: Optional[str],
+        var: Optional[str],
+        function_macro: Union[str, Dict, None],
+        macro_definition: Optional[str],
+        signature: Optional[str],
+    ) -> Path:
+        """Find the file defining the requested symbol for a code() call without a path."""
+        from .symbol_resolver import get_symbol_resolver
+
+        if isinstance(function_macro, dict):
+            function_macro = function_macro.get("name")
+        requested = {
+            "function": function,
+            "struct": struct,
+            "var": var,
+            "function_macro": function_macro,
+            "macro_definition": macro_definition,
+        }
+        kind, name = next(((kind, name) for kind, name in requested.items() if name), (None, None))
+        if kind is None:
+            raise ValueError(
+                "code() needs a file path unless function, struct, var, macro_definition or function_macro is given"
+            )
+
+        resolver = get_symbol_resolver()
+        if resolver is None:
+            raise ValueError(f"code() needs a file path for {kind}='{name}': symbol lookup is not enabled")
+        return resolver.resolve(kind, name, signature if kind == "function" else None)
+
+    def _extract_cached(
+        self, extractor, resolved_path: Path, file_path: str, code_spec: Dict, release: bool = True
+    ) -> Union[Tuple[str, int, int], str]:
+        """
+        Run _extract(), going through the render cache when one is configured.
+
+        Results are keyed by the file's blob hash, so an unchanged file is never
+        parsed again once its extractions are cached. A large file's tree is released
+        after extracting unless release is False (the caller extracts more from it).
+        """
+        prefetched = self._prefetched.pop((resolved_path, _spec_key(code_spec)), None)
+        if prefetched is not None:
+            return prefetched
+
+        render_cache = get_render_cache()
+        if render_cache is None:
+            with profiler.stage("extract", file_path):
+                extracted = self._extract(extractor, resolved_path, file_path, **code_spec)
+            if release:
+                self._release_large(resolved_path)
+            return extracted
+
+        parse_cache = get_parse_cache()
+        digest = parse_cache.digest(parse_cache.read(resolved_path))
+        key = extraction_key(digest, type(extractor).__name__, code_spec)
+        cached = render_cache.get(key)
+        if cached is not None:
+            logger.debug(f"Render cache hit for {file_path} {key[:8]}")
+            profiler.count("render cache hits")
+            return cached
+
+        profiler.count("render cache misses")
+        with profiler.stage("extract", file_path):
+            extracted = self._extract(extractor, resolved_path, file_path, **code_spec)
+        if not isinstance(extracted, str):
+            render_cache.put(key, extracted)
+        if release:
+            self._release_large(resolved_path)
+        return extracted
+
+    @staticmethod
+    def _release_large(resolved_path: Path) -> None:
+        """Drop a large file's tree now that its snippets are extracted (its tables stay cached)."""
+        parse_cache = get_parse_cache()
+        try:
+            if parse_cache.release_large(parse_cache.read(resolved_path)):
+                logger.debug(f"Released the tree of large file {resolved_path}")
+        except (OSError, ValueError) as e:
+            logger.debug(f"Could not release {resolved_path}: {e}")
+
+    def _extract(
+        self,
+        extractor,
+        resolved_path: Path,
+        file_path: str,
+        function: str = None,
+        struct: str = None,
+        var: str = None,
+        function_macro: Union[str, Dict] = None,
+        macro_definition: str = None,
+        lines: Tuple[int, int] = None,
+        marker: str = None,
+        signature: str = None,
+        message: str = None,
+        enum: str = None,
+        service: str = None,
+        rpc: str = None,
+    ) -> Union[Tuple[str, int, int], str]:
+        """
+        Extract the code selected by code() arguments.
+
+        Returns:
+            Tuple of (code_text, start_line, end_line), or an error message for
+            selections the file type does not support
+        """
+        # Extract code based on parameters
+        if function:
+            # Check if we also have a marker - extract marker within function
+            if marker:
+                if hasattr(extractor, "extract_function_marker"):
+                    code_text, start_line, end_line = extractor.extract_function_marker(resolved_path, function, marker)
+                    logger.info(f"Extracted marker '{marker}' from function '{function}' in {file_path}")
+                else:
+                    return "❌ **ERROR**: Function marker extraction not supported for this file type"
+            else:
+                code_text, start_line, end_line = extractor.extract_function(resolved_path, function, signature)
+                logger.info(f"Extracted function '{function}' from {file_path}")
+        elif function_macro:
+            # Handle function_macro parameter
+            if isinstance(function_macro, str):
+                # Simple string -> convert to dict
+                macro_spec = {"name": function_macro}
+            else:
+                macro_spec = function_macro
+
+            # Check if we also have a marker - extract marker within macro
+            if marker:
+                code_text, start_line, end_line = extractor.extract_function_macro_marker(
+                    resolved_path, macro_spec, marker
+                )
+                logger.info(f"Extracted marker '{marker}' from function_macro '{macro_spec}' in {file_path}")
+            else:
+                code_text, start_line, end_line = extractor.extract_function_macro(resolved_path, macro_spec)
+                logger.info(f"Extracted function_macro '{macro_spec}' from {file_path}")
+        elif macro_definition:
+            code_text, start_line, end_line = extractor.extract_macro_definition(resolved_path, macro_definition)
+            logger.info(f"Extracted macro_definition '{macro_definition}' from {file_path}")
+        elif struct or var:
+            # Extract struct/class/enum/variable (for C/C++)
+            name = struct or var
+            kind = "struct/class/enum" if struct else "variable"
+            if hasattr(extractor, "extract_struct"):
+                if marker:
+                    # Extract marker within struct/var
+                    if hasattr(extractor, "extract_struct_marker"):
+                        code_text, start_line, end_line = extractor.extract_struct_marker(resolved_path, name, marker)
+                        logger.info(f"Extracted marker '{marker}' from {kind} '{name}' in {file_path}")
+                    else:
+                        return f"❌ **ERROR**: Marker extraction in {kind} not supported"
+                else:
+                    code_text, start_line, end_line = extractor.extract_struct(resolved_path, name)
+                    logger.info(f"Extracted {kind} '{name}' from {file_path}")
+            else:
+                return f"❌ **ERROR**: {kind.capitalize()} extraction not supported for this file type"
+        elif message:
+            # Extract protobuf message
+            if hasattr(extractor, "extract_message"):
+                if marker:
+                    code_text, start_line, end_line = extractor.extract_message_marker(resolved_path, message, marker)
+                    logger.info(f"Extracted marker '{marker}' from message '{message}' in {file_path}")
+                else:
+                    code_text, start_line, end_line = extractor.extract_message(resolved_path, message)
+                    logger.info(f"Extracted message '{message}' from {file_path}")
+            else:
+                return "❌ **ERROR**: Message extraction not supported for this file type"
+        elif enum:
+            # Extract protobuf enum
+            if hasattr(extractor, "extract_enum"):
+                code_text, start_line, end_line = extractor.extract_enum(resolved_path, enum)
+                logger.info(f"Extracted enum '{enum}' from {file_path}")
+            else:
+                return "❌ **ERROR**: Enum extraction not supported for this file type"
+        elif service:
+            # Extract protobuf service
+            if hasattr(extractor, "extract_service"):
+                code_text, start_line, end_line = extractor.extract_service(resolved_path, service)
+                logger.info(f"Extracted service '{service}' from {file_path}")
+            else:
+                return "❌ **ERROR**: Service extraction not supported for this file type"
+        elif rpc:
+            # Extract protobuf rpc
+            if hasattr(extractor, "extract_rpc"):
+                code_text, start_line, end_line = extractor.extract_rpc(resolved_path, rpc)
+                logger.info(f"Extracted rpc '{rpc}' from {file_path}")
+            else:
+                return "❌ **ERROR**: Rpc extraction not supported for this file type"
+        elif marker:
+            code_text, start_line, end_line = extractor.extract_marker(resolved_path, marker)
+            logger.info(f"Extracted marker '{marker}' from {file_path}")
+        elif lines:
+            start_line, end_line = lines
+            code_text, start_line, end_line = extractor.extract_lines(resolved_path, start_line, end_line)
+            logger.info(f"Extracted lines {start_line}-{end_line} from {file_path}")
+        else:
+            return (
+                f"❌ **ERROR**: Must specify function, struct, var, function_macro, "
+                f"macro_definition, lines, or marker for {file_path}"
+            )
+
+        return code_text, start_line, end_line
+
     def _ignore_changes_function(
         self,
         file_path: str,
@@ -317,9 +657,20 @@ class TemplateRenderer:
         resolved_path = Path(file_path)
         if not resolved_path.is_absolute():
             resolved_path = self.repo_path / resolved_path
+        self._record_dependency(resolved_path)
+        spec = {
+            "function": function,
+            "struct": struct,
+            "var": var,
+            "function_macro": function_macro,
+            "macro_definition": macro_definition,
+            "lines": lines,
+            "marker": marker,
+        }
+        self._record_snippet(resolved_path, {"ignore_changes": True, **spec})
 
         # If no extraction spec, ignore entire file
-        has_spec = any([function, struct, var, function_macro, macro_definition, lines, marker])
+        has_spec = any(spec.values())
         if not has_spec:
             # Ignore all lines (use a large range)
             self.changes_set.subtract(resolved_path, 1, 999999)
@@ -353,49 +704,51 @@ class TemplateRenderer:
 
         return ""
 
-    def _find_custom_tags_file(self, start_path: Path) -> Optional[Path]:
-        """
-        Find .projected-source.py file by walking up from start_path.
-        Stops at git root to avoid escaping the repository.
+    def _record_dependency(self, file_path: Path) -> None:
+        """Remember that the template being rendered reads this file."""
+        if self._current_template is not None:
+            self.dependencies.setdefault(self._current_template, set()).add(file_path.resolve())
 
-        Args:
-            start_path: Path to start searching from (usually template dir)
-
-        Returns:
-            Path to .projected-source.py if found, None otherwise
-        """
-        current = start_path.resolve()
-
-        # Use repo_path as the boundary (it's already the git root)
-        git_root = self.repo_path
-
-        while current >= git_root:
-            custom_file = current / ".projected-source.py"
-            if custom_file.exists():
-                logger.info(f"Found custom tags file at {custom_file}")
-                return custom_file
-
-            # Move up one directory
-            parent = current.parent
-            if parent == current:  # Reached filesystem root
-                break
-            current = parent
+    def _record_snippet(self, file_path: Path, arguments: Dict[str, Any], commit_sensitive: bool = False) -> None:
+        """Remember a code()/ignore_changes() call of the template being rendered."""
+        if self._current_template is None:
+            return
+        inputs = self.inputs.setdefault(self._current_template, TemplateInputs())
+        given = {key: value for key, value in arguments.items() if value is not None}
+        inputs.snippets.append((file_path.resolve(), given))
+        # Remapped line numbers depend on the committed version of the file too
+        inputs.commit_sensitive |= bool(commit_sensitive) or self.remap_dirty_lines
+
+    def _record_template(self, template: jinja2.Template) -> None:
+        """Remember a template file loaded while rendering the current template (includes, extends, imports)."""
+        if self._current_template is not None and template.filename:
+            self.inputs.setdefault(self._current_template, TemplateInputs()).templates.add(
+                Path(template.filename).resolve()
+            )
 
-        return None
+    def _find_custom_tags_file(self, start_path: Path) -> Optional[Path]:
+        """Find .projected-source.py for templates under start_path (see find_custom_tags_file())."""
+        custom_file = find_custom_tags_file(start_path, self.repo_path)
+        if custom_file:
+            logger.info(f"Found custom tags file at {custom_file}")
+        return custom_file
 
-    def _load_custom_tags(self, template_path: Path) -> None:
+    def _load_custom_tags(self, template_path: Path) -> Optional[Path]:
         """
         Load and execute custom tags from .projected-source.py if found.
 
         Args:
             template_path: Path to the template being rendered
+
+        Returns:
+            The .projected-source.py found (even if loading it failed), or None
         """
         # Start searching from template's directory
         start_dir = template_path.parent if template_path.is_file() else template_path
 
         custom_file = self._find_custom_tags_file(start_dir)
         if not custom_file:
-            return
+            return None
 
         try:
             # Import the module dynamically
@@ -404,7 +757,7 @@ class TemplateRenderer:
             spec = importlib.util.spec_from_file_location("custom_tags", custom_file)
             if not spec or not spec.loader:
                 logger.warning(f"Could not load {custom_file}")
-                return
+                return custom_file
 
             module = importlib.util.module_from_spec(spec)
             spec.loader.exec_module(module)
@@ -420,16 +773,11 @@ class TemplateRenderer:
             logger.error(f"Error loading custom tags from {custom_file}: {e}")
             # Don't crash - just continue without custom tags
 
+        return custom_file
+
     def _add_line_numbers(self, code_text: str, start_line: int) -> str:
         """Add line numbers to code text."""
-        lines = code_text.splitlines()
-        numbered_lines = []
-
-        for i, line in enumerate(lines):
-            line_num = start_line + i
-            numbered_lines.append(f"{line_num:4} {line}")
-
-        return "\n".join(numbered_lines)
+        return "\n".join(f"{line_num:4} {line}" for line_num, line in enumerate(code_text.splitlines(), start_line))
 
     def render_template(self, template_name: str, **context) -> str:
         """
@@ -442,13 +790,39 @@ class TemplateRenderer:
         Returns:
             Rendered template as string
         """
+        return "".join(self.stream_template(template_name, **context))
+
+    def stream_template(self, template_name: str, **context) -> Iterator[str]:
+        """
+        Render a template chunk by chunk.
+
+        Chunks are produced as Jinja evaluates the template, so each code() snippet can
+        be written out and dropped before the next one is extracted; memory does not
+        grow with the size of the output.
+
+        Args:
+            template_name: Name of the template file
+            **context: Additional context variables
+
+        Yields:
+            Rendered text chunks, in order
+        """
         try:
             # Load custom tags from .projected-source.py if available
             template_path = self.template_dir / template_name
-            self._load_custom_tags(template_path)
-
-            template = self.env.get_template(template_name)
-            return template.render(**context)
+            custom_file = self._load_custom_tags(template_path)
+
+            self.dependencies[template_name] = set()
+            inputs = self.inputs[template_name] = TemplateInputs(custom_tags=custom_file)
+            if custom_file:
+                inputs.templates.add(custom_file.resolve())
+            self._current_template = template_name
+            try:
+                template = self.env.get_template(template_name)
+                with profiler.stage("template", template_name):
+                    yield from self._generate(template, context)
+            finally:
+                self._current_template = None
         except jinja2.TemplateNotFound:
             logger.error(f"Template not found: {template_name}")
             raise
@@ -456,6 +830,112 @@ class TemplateRenderer:
             logger.error(f"Template rendering failed: {e}")
             raise
 
+    def stream_string(self, source: str, **context) -> Iterator[str]:
+        """Render template source text chunk by chunk (see stream_template())."""
+        yield from self._generate(self.env.from_string(source), context)
+
+    def render_string(self, source: str, **context) -> str:
+        """Render template source text."""
+        return "".join(self.stream_string(source, **context))
+
+    def _generate(self, template: jinja2.Template, context: Dict[str, Any]) -> Iterator[str]:
+        """Run a template, resolving deferred code() calls concurrently when resolve_workers > 1."""
+        if self.resolve_workers <= 1:
+            yield from template.generate(**context)
+            return
+
+        self._pending = []
+        try:
+            # Only placeholders and template text: small even for huge outputs
+            chunks = list(template.generate(**context))
+            calls = self._pending
+        finally:
+            self._pending = None
+
+        def substitute(match: re.Match) -> str:
+            args, kwargs = calls[int(match.group(1))]
+            return self._snippet(args, kwargs)
+
+        with profiler.stage("resolve", f"{len(calls)} snippets"):
+            self._prefetch(calls)
+        try:
+            for chunk in chunks:
+                yield _PLACEHOLDER_RE.sub(substitute, chunk) if "\x00" in chunk else chunk
+        finally:
+            self._prefetched.clear()
+
+    def _prefetch(self, calls: List[Tuple[tuple, Dict[str, Any]]]) -> None:
+        """
+        Do the slow parts of deferred code() calls on a thread pool.
+
+        Paths are resolved first (symbol lookups may wait for the index), then each
+        file is handled by one task: read (a `git cat-file` round trip under --commit),
+        parse and extract every snippet of it, then blame it and map its diff if any
+        snippet needs that. Substitution afterwards only formats cached results, in
+        template order, so output and coverage match an immediate render.
+
+        Failures are left for substitution to report in place.
+        """
+        signature = inspect.signature(self._code_function)
+        requests = []
+        for args, kwargs in calls:
+            try:
+                bound = signature.bind(*args, **kwargs)
+            except TypeError:
+                continue
+            bound.apply_defaults()
+            requests.append(bound.arguments)
+        if not requests:
+            return
+
+        def resolve(arguments):
+            try:
+                symbol = [arguments[key] for key in ("function", "struct", "var", "function_macro", "macro_definition")]
+                return self._snippet_path(arguments["file_path"], *symbol, arguments["signature"])
+            except Exception as e:
+                logger.debug(f"Deferred code() path lookup failed: {e}")
+                return None
+
+        with ThreadPoolExecutor(max_workers=self.resolve_workers, thread_name_prefix="snippet") as pool:
+            # Remote and HEAD lookups for permalinks, once
+            pool.submit(self.github._init_repo_info)
+            by_file: Dict[Path, List[Tuple[str, Dict[str, Any]]]] = {}
+            for arguments, found in zip(requests, pool.map(resolve, requests)):
+                if found is not None:
+                    by_file.setdefault(found[0], []).append((found[1], arguments))
+            for future in [pool.submit(self._prefetch_file, path, snippets) for path, snippets in by_file.items()]:
+                future.result()
+        logger.debug(f"Prefetched {len(requests)} snippet(s) from {len(by_file)} file(s)")
+
+    def _prefetch_file(self, resolved_path: Path, snippets: List[Tuple[str, Dict[str, Any]]]) -> None:
+        """Extract the deferred snippets of one file and warm its git metadata."""
+        with profiler.stage("prefetch", snippets[0][0], snippets=len(snippets)):
+            self._prefetch_snippets(resolved_path, snippets)
+
+    def _prefetch_snippets(self, resolved_path: Path, snippets: List[Tuple[str, Dict[str, Any]]]) -> None:
+        try:
+            extractor = get_extractor(resolved_path)
+        except ValueError:
+            return
+
+        for file_path, arguments in snippets:
+            code_spec = {key: arguments[key] for key in _CODE_SPEC_KEYS}
+            try:
+                extracted = self._extract_cached(extractor, resolved_path, file_path, code_spec, release=False)
+            except Exception as e:
+                logger.debug(f"Prefetching {file_path} failed: {e}")
+                continue
+            self._prefetched[(resolved_path, _spec_key(code_spec))] = extracted
+        self._release_large(resolved_path)
+
+        try:
+            if any(arguments["blame"] for _, arguments in snippets):
+                self.github.metadata.blame(resolved_path, 1, 0)
+            if self.remap_dirty_lines or any(arguments["github"] for _, arguments in snippets):
+                self.github.metadata.line_mapping(resolved_path)
+        except Exception as e:
+            logger.debug(f"Collecting git metadata for {resolved_path} failed: {e}")
+
     def render_template_file(self, template_path: Path, output_path: Path = None, **context):
         """
         Render a template file and optionally save the output.
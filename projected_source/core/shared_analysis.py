@@ -0,0 +1,137 @@
+"""
+Analysis artifacts shared by the worker processes of one render.
+
+Every worker of `render --jobs N` has its own parse cache, so a header included by
+many templates would be analysed once per worker. With a SharedAnalysis attached to
+the parse cache, the first worker to build a shareable artifact of some content -
+its symbol table (functions, types, #defines, macro invocations), .proto definition
+table, marker table or line offsets - publishes it to a per-render directory under
+the content's blob hash; other workers map the file read-only and decode it instead
+of parsing.
+
+Only artifacts made of plain data are shared. Tree-sitter trees and anything
+holding nodes stay per process, and are only built when an extraction needs a node.
+"""
+
+import logging
+import mmap
+import os
+import pickle
+import tempfile
+from array import array
+from pathlib import Path
+from typing import Any, Callable, Dict, Optional, Tuple
+
+logger = logging.getLogger(__name__)
+
+
+def _encode_symbols(table) -> Any:
+    return table.to_dict()
+
+
+def _decode_symbols(data: Any):
+    from ..languages.cpp_symbols import CppSymbolTable
+
+    return CppSymbolTable.from_dict(data)
+
+
+def _decode_proto_symbols(data: Any):
+    from ..languages.proto_symbols import ProtoSymbolTable
+
+    return ProtoSymbolTable.from_dict(data)
+
+
+def _encode_markers(table) -> Any:
+    return [(m.name, m.open_line, m.close_line, m.start_byte, m.end_byte) for m in table.markers]
+
+
+def _decode_markers(data: Any):
+    from .markers import Marker, MarkerTable
+
+    return MarkerTable([Marker(*row) for row in data])
+
+
+def _encode_offsets(offsets) -> Any:
+    return array("q", offsets)
+
+
+def _decode_offsets(data: Any):
+    return data.tolist()
+
+
+# parse cache derived() key -> (encode to picklable plain data, decode)
+CODECS: Dict[str, Tuple[Callable[[Any], Any], Callable[[Any], Any]]] = {
+    "cpp_symbols": (_encode_symbols, _decode_symbols),
+    "proto_symbols": (_encode_symbols, _decode_proto_symbols),
+    "markers": (_encode_markers, _decode_markers),
+    "line_offsets": (_encode_offsets, _decode_offsets),
+}
+
+
+class SharedAnalysis:
+    """Directory of per-content artifacts written by one worker and read by the others."""
+
+    def __init__(self, directory: Path):
+        """
+        Args:
+            directory: Per-render directory (created if needed); every worker of the render gets the same one
+        """
+        self.directory = Path(directory)
+        self.directory.mkdir(parents=True, exist_ok=True)
+        self.loaded = 0
+        self.published = 0
+
+    def _path(self, digest: str, key: str) -> Path:
+        return self.directory / key / f"{digest}.bin"
+
+    def load(self, digest: str, key: str) -> Optional[Any]:
+        """
+        Artifact another process published for this content, or None.
+
+        Args:
+            digest: Blob hash of the content
+            key: derived() key ("cpp_symbols", "markers", ...); other keys are never shared
+        """
+        codec = CODECS.get(key)
+        if codec is None:
+            return None
+
+        try:
+            with open(self._path(digest, key), "rb") as f:
+                with mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ) as mapped:
+                    data = pickle.loads(mapped)
+        except FileNotFoundError:
+            return None
+        except (OSError, ValueError, EOFError, pickle.UnpicklingError) as e:
+            logger.warning(f"Ignoring unreadable shared {key} for {digest[:8]}: {e}")
+            return None
+
+        value = codec[1](data)
+        if value is not None:
+            self.loaded += 1
+        return value
+
+    def publish(self, digest: str, key: str, value: Any) -> None:
+        """Make an artifact available to the other workers (first writer wins; writes are atomic)."""
+        codec = CODECS.get(key)
+        if codec is None or value is None:
+            return
+
+        path = self._path(digest, key)
+        if path.exists():
+            return
+        try:
+            path.parent.mkdir(parents=True, exist_ok=True)
+            fd, tmp_name = tempfile.mkstemp(dir=path.parent, suffix=".tmp")
+        except OSError as e:
+            logger.warning(f"Could not share {key} for {digest[:8]}: {e}")
+            return
+
+        try:
+            with os.fdopen(fd, "wb") as f:
+                pickle.dump(codec[0](value), f, protocol=pickle.HIGHEST_PROTOCOL)
+            os.replace(tmp_name, path)
+            self.published += 1
+        except OSError as e:
+            logger.warning(f"Could not share {key} for {digest[:8]}: {e}")
+            Path(tmp_name).unlink(missing_ok=True)
@@ -0,0 +1,275 @@
+"""
+Persistent on-disk symbol index.
+
+Symbol tables (see languages/cpp_symbols.py) are stored in a SQLite database keyed by
+git blob hash, so a file whose content was indexed before - in this checkout, another
+branch or a worktree at some commit - is never walked again. A files table remembers
+(mtime, size, digest) per path so `projected-source index` can skip unchanged files
+without reading them, and a symbols table maps names to files for cross-file lookups.
+
+The default location is <repo>/.projected-source/index.db.
+"""
+
+import json
+import logging
+import sqlite3
+import threading
+import zlib
+from dataclasses import dataclass
+from pathlib import Path
+from typing import Iterable, Iterator, List, Optional, Tuple
+
+from .parse_cache import get_parse_cache
+
+logger = logging.getLogger(__name__)
+
+INDEX_DIRNAME = ".projected-source"
+INDEX_FILENAME = "index.db"
+
+# Bump when the database layout changes
+SCHEMA_VERSION = 1
+
+SCHEMA = """
+CREATE TABLE IF NOT EXISTS meta (key TEXT PRIMARY KEY, value TEXT NOT NULL);
+CREATE TABLE IF NOT EXISTS tables (digest TEXT PRIMARY KEY, data BLOB NOT NULL);
+CREATE TABLE IF NOT EXISTS symbols (
+    digest TEXT NOT NULL, kind TEXT NOT NULL, name TEXT NOT NULL, qualified TEXT NOT NULL
+);
+CREATE INDEX IF NOT EXISTS symbols_by_name ON symbols (name);
+CREATE INDEX IF NOT EXISTS symbols_by_digest ON symbols (digest);
+CREATE TABLE IF NOT EXISTS files (
+    path TEXT PRIMARY KEY, digest TEXT NOT NULL, mtime_ns INTEGER NOT NULL, size INTEGER NOT NULL
+);
+"""
+
+
+# Extensions handled by the C++ extractor
+CPP_EXTENSIONS = {".cpp", ".cc", ".cxx", ".c++", ".hpp", ".h", ".hxx", ".h++", ".c", ".ipp"}
+
+
+def default_index_path(repo_path: Path) -> Path:
+    """Default index location for a repository."""
+    return Path(repo_path) / INDEX_DIRNAME / INDEX_FILENAME
+
+
+@dataclass
+class IndexStats:
+    """Outcome of an index_files() run."""
+
+    files: int = 0
+    built: int = 0  # tables built by walking the tree
+    reused: int = 0  # content already in the index
+    unchanged: int = 0  # (mtime, size) matched, file not read
+    failed: int = 0
+
+
+class SymbolIndex:
+    """SQLite-backed store of per-file symbol tables."""
+
+    def __init__(self, path: Path):
+        """
+        Open (or create) an index database.
+
+        Args:
+            path: Database file; its directory is created if needed
+        """
+        self.path = Path(path)
+        self.path.parent.mkdir(parents=True, exist_ok=True)
+        gitignore = self.path.parent / ".gitignore"
+        if self.path.parent.name == INDEX_DIRNAME and not gitignore.exists():
+            gitignore.write_text("*\n")
+
+        self._lock = threading.Lock()
+        self._conn = sqlite3.connect(str(self.path), check_same_thread=False)
+        self._conn.execute("PRAGMA journal_mode=WAL")
+        self._conn.execute("PRAGMA synchronous=NORMAL")
+        self._conn.executescript(SCHEMA)
+        self._check_version()
+
+    def _check_version(self) -> None:
+        """Drop all content written by a different schema or symbol table version."""
+        from ..languages.cpp_symbols import SYMBOL_TABLE_VERSION
+
+        version = f"{SCHEMA_VERSION}.{SYMBOL_TABLE_VERSION}"
+        with self._lock, self._conn:
+            row = self._conn.execute("SELECT value FROM meta WHERE key = 'version'").fetchone()
+            if row and row[0] == version:
+                return
+            if row:
+                logger.info(f"Symbol index {self.path} has version {row[0]}, rebuilding for {version}")
+            self._conn.execute("DELETE FROM tables")
+            self._conn.execute("DELETE FROM symbols")
+            self._conn.execute("DELETE FROM files")
+            self._conn.execute("INSERT OR REPLACE INTO meta (key, value) VALUES ('version', ?)", (version,))
+
+    # ==================== Tables by content ====================
+
+    def load(self, digest: str):
+        """
+        Load the symbol table for a blob hash.
+
+        Returns:
+            CppSymbolTable, or None if the content is not indexed
+        """
+        from ..languages.cpp_symbols import CppSymbolTable
+
+        with self._lock:
+            row = self._conn.execute("SELECT data FROM tables WHERE digest = ?", (digest,)).fetchone()
+        if row is None:
+            return None
+        try:
+            return CppSymbolTable.from_dict(json.loads(zlib.decompress(row[0])))
+        except (zlib.error, ValueError, KeyError, TypeError) as e:
+            logger.warning(f"Ignoring corrupt index entry {digest[:8]}: {e}")
+            return None
+
+    def store(self, digest: str, table) -> None:
+        """Store the symbol table for a blob hash (replacing any previous entry)."""
+        data = zlib.compress(json.dumps(table.to_dict(), separators=(",", ":")).encode("utf8"))
+        names = [(digest, kind, name, qualified) for kind, name, qualified in table.names()]
+        with self._lock, self._conn:
+            self._conn.execute("INSERT OR REPLACE INTO tables (digest, data) VALUES (?, ?)", (digest, data))
+            self._conn.execute("DELETE FROM symbols WHERE digest = ?", (digest,))
+            self._conn.executemany("INSERT INTO symbols (digest, kind, name, qualified) VALUES (?, ?, ?, ?)", names)
+
+    def contains(self, digest: str) -> bool:
+        """Whether a table for this blob hash is stored."""
+        with self._lock:
+            return self._conn.execute("SELECT 1 FROM tables WHERE digest = ?", (digest,)).fetchone() is not None
+
+    # ==================== Files ====================
+
+    def file_digest(self, file_path: Path, mtime_ns: int, size: int) -> Optional[str]:
+        """Recorded digest for a path, if its (mtime, size) still match."""
+        with self._lock:
+            row = self._conn.execute(
+                "SELECT digest FROM files WHERE path = ? AND mtime_ns = ? AND size = ?",
+                (str(Path(file_path).resolve()), mtime_ns, size),
+            ).fetchone()
+        return row[0] if row else None
+
+    def record_file(self, file_path: Path, digest: str, mtime_ns: int, size: int) -> None:
+        """Remember which content a path had at (mtime, size)."""
+        with self._lock, self._conn:
+            self._conn.execute(
+                "INSERT OR REPLACE INTO files (path, digest, mtime_ns, size) VALUES (?, ?, ?, ?)",
+                (str(Path(file_path).resolve()), digest, mtime_ns, size),
+            )
+
+    def forget_missing_files(self) -> int:
+        """Drop the records of paths no longer on disk. Returns the number removed."""
+        with self._lock:
+            paths = [row[0] for row in self._conn.execute("SELECT path FROM files").fetchall()]
+        missing = [(path,) for path in paths if not Path(path).is_file()]
+        if missing:
+            with self._lock, self._conn:
+                self._conn.executemany("DELETE FROM files WHERE path = ?", missing)
+        return len(missing)
+
+    def find_files(self, name: str) -> List[Tuple[Path, str, str]]:
+        """
+        Indexed files defining a symbol.
+
+        Args:
+            name: Leaf name ("method") or qualified name ("ns::Class::method")
+
+        Returns:
+            List of (path, kind, qualified name), sorted by path
+        """
+        leaf = name.split("::")[-1]
+        with self._lock:
+            rows = self._conn.execute(
+                "SELECT DISTINCT f.path, s.kind, s.qualified FROM symbols s JOIN files f ON f.digest = s.digest "
+                "WHERE s.name = ? ORDER BY f.path",
+                (leaf,),
+            ).fetchall()
+        return [
+            (Path(path), kind, qualified)
+            for path, kind, qualified in rows
+            if qualified == name or qualified.endswith("::" + name)
+        ]
+
+    def prune(self) -> int:
+        """Remove tables no recorded file refers to. Returns the number removed."""
+        with self._lock, self._conn:
+            cursor = self._conn.execute("DELETE FROM tables WHERE digest NOT IN (SELECT digest FROM files)")
+            self._conn.execute("DELETE FROM symbols WHERE digest NOT IN (SELECT digest FROM tables)")
+            return cursor.rowcount
+
+    def close(self) -> None:
+        """Close the database connection."""
+        with self._lock:
+            self._conn.close()
+
+
+def iter_source_files(paths: List[Path]) -> Iterator[Path]:
+    """C/C++ files under the given paths, skipping hidden directories (.git, .projected-source)."""
+    for path in paths:
+        if path.is_file():
+            if path.suffix.lower() in CPP_EXTENSIONS:
+                yield path
+            continue
+        for file_path in sorted(path.rglob("*")):
+            relative = file_path.relative_to(path)
+            if any(part.startswith(".") for part in relative.parts[:-1]):
+                continue
+            if file_path.suffix.lower() in CPP_EXTENSIONS and file_path.is_file():
+                yield file_path
+
+
+def index_files(files: Iterable[Path], index: SymbolIndex) -> IndexStats:
+    """
+    Bring the index up to date for a set of C/C++ files.
+
+    Files whose (mtime, size) match the index are skipped without reading; others are
+    hashed and only walked if their content has not been indexed before. Records of
+    files deleted since an earlier build are dropped, so lookups no longer return them.
+    """
+    from ..languages.cpp_symbols import build_symbol_table
+
+    cache = get_parse_cache()
+    stats = IndexStats()
+
+    for file_path in files:
+        stats.files += 1
+        try:
+            stat = file_path.stat()
+            if index.file_digest(file_path, stat.st_mtime_ns, stat.st_size):
+                stats.unchanged += 1
+                continue
+
+            was_cached = cache.is_cached(file_path)
+            data = cache.read(file_path)
+            digest = cache.digest(data)
+            if index.contains(digest):
+                stats.reused += 1
+            else:
+                index.store(digest, build_symbol_table(data))
+                stats.built += 1
+            index.record_file(file_path, digest, stat.st_mtime_ns, stat.st_size)
+            if not was_cached:
+                # Neither bytes nor trees are needed once the table is stored; don't keep a whole repository in memory
+                cache.release(data)
+        except (OSError, UnicodeDecodeError, ValueError) as e:
+            logger.warning(f"Could not index {file_path}: {e}")
+            stats.failed += 1
+
+    removed = index.forget_missing_files()
+    if removed:
+        logger.info(f"Dropped {removed} deleted file(s) from the symbol index")
+    return stats
+
+
+# Process-wide index used by extractors (None when no index is configured)
+_symbol_index: Optional[SymbolIndex] = None
+
+
+def get_symbol_index() -> Optional[SymbolIndex]:
+    """Get the configured symbol index, if any."""
+    return _symbol_index
+
+
+def set_symbol_index(index: Optional[SymbolIndex]) -> None:
+    """Set (or clear) the process-wide symbol index."""
+    global _symbol_index
+    _symbol_index = index
@@ -0,0 +1,175 @@
+"""
+Project-wide symbol lookup for code() calls without a file path.
+
+`code(function='ns::Cls::method')` asks the resolver which file defines the symbol.
+The answer comes from the symbol index (see symbol_index.py): its symbols table maps
+names to files, so a lookup is one indexed SQLite query however large the tree is.
+
+The index is brought up to date for the configured include roots in a background
+thread, started either up front (render --include-root) or by the first lookup;
+lookups wait for it. Refreshing an existing index only stats files, so later runs
+pay almost nothing.
+"""
+
+import logging
+import threading
+from pathlib import Path
+from typing import Dict, List, Optional, Sequence, Tuple
+
+from .symbol_index import IndexStats, SymbolIndex, get_symbol_index, index_files, iter_source_files, set_symbol_index
+
+logger = logging.getLogger(__name__)
+
+# code() argument -> {symbol kind (see cpp_symbols.py): preference}; lower wins, equal ranks are ambiguous
+LOOKUP_KINDS: Dict[str, Dict[str, int]] = {
+    "function": {"function": 0, "template_function": 0, "method_declaration": 1},
+    "struct": {"type": 0},
+    "var": {"variable": 0},
+    "macro_definition": {"macro_definition": 0},
+    "function_macro": {"macro_invocation": 0},
+}
+
+
+class SymbolResolver:
+    """Find the file defining a symbol across a set of include roots."""
+
+    def __init__(self, roots: Sequence[Path], index_path: Path):
+        """
+        Args:
+            roots: Directories (or files) whose C/C++ sources are searched
+            index_path: Database to open when no symbol index is configured yet; nothing
+                        is created until the first lookup or start()
+        """
+        self.roots = [Path(root).resolve() for root in roots]
+        self.index_path = Path(index_path)
+        self.index: Optional[SymbolIndex] = None
+        self.stats: Optional[IndexStats] = None
+        self._lock = threading.Lock()
+        self._thread: Optional[threading.Thread] = None
+        self._error: Optional[BaseException] = None
+
+    def start(self) -> None:
+        """Start refreshing the index in the background (no-op if already started)."""
+        with self._lock:
+            if self._thread is not None:
+                return
+            # Shared with extractors, which then load tables from the index too
+            self.index = get_symbol_index()
+            if self.index is None:
+                self.index = SymbolIndex(self.index_path)
+                set_symbol_index(self.index)
+            self._thread = threading.Thread(target=self._build, name="symbol-index", daemon=True)
+            self._thread.start()
+
+    def _build(self) -> None:
+        try:
+            self.stats = index_files(iter_source_files(self.roots), self.index)
+            logger.info(
+                f"Symbol index ready: {self.stats.files} file(s), {self.stats.built} built, "
+                f"{self.stats.reused} reused, {self.stats.unchanged} unchanged"
+            )
+        except BaseException as e:  # Surfaced to the lookup that waits for the build
+            self._error = e
+
+    def refresh(self) -> None:
+        """Bring the index up to date again on the next lookup (after files changed)."""
+        with self._lock:
+            if self._thread is not None and not self._thread.is_alive():
+                self._thread = None
+                self._error = None
+
+    @property
+    def started(self) -> bool:
+        """Whether the index refresh has been started."""
+        return self._thread is not None
+
+    def wait(self) -> None:
+        """Start the index refresh if needed and wait for it to finish."""
+        self.start()
+        self._thread.join()
+        if self._error is not None:
+            raise RuntimeError(f"Building the symbol index failed: {self._error}") from self._error
+
+    def _in_roots(self, path: Path) -> bool:
+        return any(path == root or root in path.parents for root in self.roots)
+
+    def candidates(self, kind: str, name: str) -> List[Tuple[Path, int]]:
+        """
+        Files defining a symbol, best first.
+
+        Args:
+            kind: code() argument the name was given as ("function", "struct", ...)
+            name: Leaf or qualified name
+
+        Returns:
+            List of (path, rank) sorted by rank then path; definitions rank before declarations
+        """
+        ranks = LOOKUP_KINDS.get(kind)
+        if ranks is None:
+            raise ValueError(f"Cannot look up {kind}= without a file path")
+
+        self.wait()
+        best: Dict[Path, int] = {}
+        for path, found_kind, _ in self.index.find_files(name):
+            rank = ranks.get(found_kind)
+            if rank is None or not self._in_roots(path) or not path.exists():
+                continue
+            best[path] = min(rank, best.get(path, rank))
+        return sorted(best.items(), key=lambda item: (item[1], item[0]))
+
+    def resolve(self, kind: str, name: str, signature: Optional[str] = None) -> Path:
+        """
+        The single file defining a symbol.
+
+        Definitions win over declarations: a method declared in a header and defined
+        in a .cpp resolves to the .cpp.
+
+        Args:
+            kind: code() argument the name was given as ("function", "struct", ...)
+            name: Leaf or qualified name
+            signature: Overload filter, as for code(function=..., signature=...)
+
+        Raises:
+            ValueError: If no file or more than one file defines the symbol
+        """
+        candidates = self.candidates(kind, name)
+        if signature is not None:
+            candidates = [(path, rank) for path, rank in candidates if self._has_signature(path, name, signature)]
+        if not candidates:
+            roots = ", ".join(str(root) for root in self.roots)
+            detail = f" with signature matching '{signature}'" if signature else ""
+            raise ValueError(f"No file under {roots} defines {kind} '{name}'{detail}")
+
+        best_rank = candidates[0][1]
+        paths = [path for path, rank in candidates if rank == best_rank]
+        if len(paths) > 1:
+            listed = ", ".join(str(path) for path in paths[:5])
+            more = "..." if len(paths) > 5 else ""
+            raise ValueError(f"{kind} '{name}' is defined in {len(paths)} files ({listed}{more}); pass the file path")
+
+        logger.debug(f"Resolved {kind} '{name}' to {paths[0]}")
+        return paths[0]
+
+    @staticmethod
+    def _has_signature(path: Path, name: str, signature: str) -> bool:
+        """Whether some overload of name in the file matches signature (by the same rule as extraction)."""
+        from ..languages.cpp_symbols import get_symbol_table
+        from .parse_cache import get_parse_cache
+
+        table = get_symbol_table(get_parse_cache().read(path))
+        return bool(table.overload_set(name).select(signature))
+
+
+# Process-wide resolver (None when path-less code() calls are not supported)
+_symbol_resolver: Optional[SymbolResolver] = None
+
+
+def get_symbol_resolver() -> Optional[SymbolResolver]:
+    """Get the configured symbol resolver, if any."""
+    return _symbol_resolver
+
+
+def set_symbol_resolver(resolver: Optional[SymbolResolver]) -> None:
+    """Set (or clear) the process-wide symbol resolver."""
+    global _symbol_resolver
+    _symbol_resolver = resolver
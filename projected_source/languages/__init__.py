@@ -1,35 +1,90 @@
 """
 Language-specific extractors.
+
+Extractor modules (and with them tree-sitter grammars) are imported on first use of
+a file type, so rendering C++ snippets never loads the proto grammar.
 """
 
+import importlib
 import logging
+import threading
 from pathlib import Path
-
-from .cpp import CppExtractor
-from .proto import ProtoExtractor
+from typing import Dict
 
 logger = logging.getLogger(__name__)
 
-# Map file extensions to extractors
+# Map file extensions to extractors ("module:class" under this package, imported on first use)
 EXTRACTORS = {
-    ".cpp": CppExtractor,
-    ".cc": CppExtractor,
-    ".cxx": CppExtractor,
-    ".c++": CppExtractor,
-    ".hpp": CppExtractor,
-    ".h": CppExtractor,
-    ".hxx": CppExtractor,
-    ".h++": CppExtractor,
-    ".c": CppExtractor,  # C is close enough to C++ for our purposes
-    ".ipp": CppExtractor,  # Inline implementation files
-    ".proto": ProtoExtractor,  # Protocol Buffers
+    ".cpp": "cpp:CppExtractor",
+    ".cc": "cpp:CppExtractor",
+    ".cxx": "cpp:CppExtractor",
+    ".c++": "cpp:CppExtractor",
+    ".hpp": "cpp:CppExtractor",
+    ".h": "cpp:CppExtractor",
+    ".hxx": "cpp:CppExtractor",
+    ".h++": "cpp:CppExtractor",
+    ".c": "cpp:CppExtractor",  # C is close enough to C++ for our purposes
+    ".ipp": "cpp:CppExtractor",  # Inline implementation files
+    ".proto": "proto:ProtoExtractor",  # Protocol Buffers
 }
 
 
+def load_extractor_class(spec: str) -> type:
+    """Import the extractor class named by an EXTRACTORS entry."""
+    module_name, class_name = spec.split(":")
+    return getattr(importlib.import_module(f".{module_name}", __name__), class_name)
+
+
+class ExtractorRegistry:
+    """
+    Keeps one long-lived extractor instance per extractor class.
+
+    Extractors are stateless between calls (parse results live in the parse cache),
+    so sharing them avoids rebuilding parsers and sub-finders for every code() call.
+    """
+
+    def __init__(self):
+        # EXTRACTORS spec -> instance
+        self._instances: Dict[str, object] = {}
+        self._lock = threading.Lock()
+
+    def get(self, file_path: Path):
+        """
+        Get the extractor for a file based on its extension.
+
+        Raises:
+            ValueError: If no extractor is available for the file type
+        """
+        suffix = file_path.suffix.lower()
+
+        if suffix not in EXTRACTORS:
+            supported = ", ".join(EXTRACTORS.keys())
+            raise ValueError(f"No extractor for {suffix} files. Supported: {supported}")
+
+        spec = EXTRACTORS[suffix]
+        with self._lock:
+            extractor = self._instances.get(spec)
+            if extractor is None:
+                logger.debug(f"Loading extractor {spec} for {suffix} files")
+                extractor = self._instances[spec] = load_extractor_class(spec)()
+        return extractor
+
+    def clear(self) -> None:
+        """Drop all cached extractor instances."""
+        with self._lock:
+            self._instances.clear()
+
+
+# Process-wide registry
+_registry = ExtractorRegistry()
+
+
 def get_extractor(file_path: Path):
     """
     Get the appropriate extractor for a file based on its extension.
 
+    The same instance is returned for every file of a given type.
+
     Args:
         file_path: Path to the file
 
@@ -39,14 +94,15 @@ def get_extractor(file_path: Path):
     Raises:
         ValueError: If no extractor is available for the file type
     """
-    suffix = file_path.suffix.lower()
+    return _registry.get(file_path)
 
-    if suffix not in EXTRACTORS:
-        supported = ", ".join(EXTRACTORS.keys())
-        raise ValueError(f"No extractor for {suffix} files. Supported: {supported}")
 
-    extractor_class = EXTRACTORS[suffix]
-    return extractor_class()
+def __getattr__(name: str):
+    # `from projected_source.languages import CppExtractor` keeps working without eager imports
+    for spec in set(EXTRACTORS.values()):
+        if spec.endswith(f":{name}"):
+            return load_extractor_class(spec)
+    raise AttributeError(f"module {__name__!r} has no attribute {name!r}")
 
 
-__all__ = ["get_extractor", "CppExtractor"]
+__all__ = ["get_extractor", "ExtractorRegistry", "CppExtractor", "ProtoExtractor"]
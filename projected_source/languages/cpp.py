@@ -6,11 +6,14 @@ import logging
 from pathlib import Path
 from typing import Dict, Optional, Tuple
 
-import tree_sitter_cpp as tscpp
-from tree_sitter import Language, Node, Query, QueryCursor
+from tree_sitter import Node, QueryCursor
 
 from ..core.extractor import BaseExtractor
+from ..core.markers import marker_table, scan_markers
+from ..core.parse_cache import get_parse_cache
 from .cpp_parser import SimpleCppParser
+from .cpp_symbols import CppSymbolTable, MacroInvocation
+from .grammars import compile_query, cpp_language
 from .macro_definition_finder import MacroDefinitionFinder
 from .macro_finder_v3 import MacroFinder
 
@@ -21,11 +24,15 @@ class CppExtractor(BaseExtractor):
     """C++ specific extractor with function extraction support."""
 
     def __init__(self):
-        super().__init__(Language(tscpp.language()))
+        super().__init__(cpp_language())
         self.cpp_parser = SimpleCppParser()
         self.macro_finder = MacroFinder()
         self.macro_def_finder = MacroDefinitionFinder()
 
+    def symbols(self, file_path: Path) -> CppSymbolTable:
+        """Get the symbol table of a file (from memory, the symbol index, or a single tree walk)."""
+        return self.cpp_parser.symbol_table(self.read_source(file_path))
+
     def extract_function(self, file_path: Path, function_name: str, signature: str = None) -> Tuple[str, int, int]:
         """
         Extract a C++ function by name using tree-sitter.
@@ -42,21 +49,24 @@ class CppExtractor(BaseExtractor):
             file_path: Path to the source file
             function_name: Name of the function to extract
             signature: Optional string to match against parameter types for overload
-                       disambiguation. Use partial type names like "TMProposeSet"
-                       to select a specific overload.
+                       disambiguation. The exact parameter types ("int, std::string const&")
+                       select by a hashed lookup; partial type names like "TMProposeSet"
+                       also select a specific overload.
 
         Returns:
             Tuple of (code_text, start_line, end_line)
         """
-        source = file_path.read_bytes()
+        source = self.read_source(file_path)
 
-        # Use the SimpleCppParser to extract function - returns ExtractionResult
-        result = self.cpp_parser.extract_function_by_name(source, function_name, signature)
+        # Symbol table lookup plus a slice - the node is not needed here
+        result = self.cpp_parser.extract_function_by_name(source, function_name, signature, with_node=False)
 
         if not result:
             if signature:
+                available = self.symbols(file_path).overload_set(function_name).signatures()
                 raise ValueError(
                     f"Function '{function_name}' with signature matching '{signature}' not found in {file_path}"
+                    + (f". Available overloads: {', '.join(available)}" if available else "")
                 )
             raise ValueError(f"Function '{function_name}' not found in {file_path}")
 
@@ -79,8 +89,8 @@ class CppExtractor(BaseExtractor):
         node = result.node
 
         if node:
-            # Find markers within the node
-            markers = self.find_markers_in_node(node)
+            # Find markers within the node (from the file's marker table)
+            markers = self.find_markers_in_node(node, self.parse_source(file_path))
 
             if marker not in markers:
                 available = ", ".join(markers.keys()) if markers else "none"
@@ -89,19 +99,15 @@ class CppExtractor(BaseExtractor):
             marker_start, marker_end = markers[marker]
 
             # Extract the marked section from the file
-            lines = file_path.read_text().splitlines()
-            marker_lines = lines[marker_start - 1 : marker_end]
-            marker_text = "\n".join(marker_lines)
+            marker_text = self.read_lines(file_path, marker_start, marker_end)
 
             actual_start_line = marker_start
             actual_end_line = marker_end
         else:
-            # Fallback: parse just the text as a standalone tree
+            # Fallback: scan just the text
             node_text = result.text
-            node_tree = self.parser.parse(node_text.encode("utf8"))
-            node = node_tree.root_node
-
-            markers = self.find_markers_in_node(node)
+            node_bytes = node_text.encode("utf8")
+            markers = scan_markers(node_bytes).lines_in_range(0, len(node_bytes))
 
             if marker not in markers:
                 available = ", ".join(markers.keys()) if markers else "none"
@@ -126,7 +132,8 @@ class CppExtractor(BaseExtractor):
         When multiple overloads exist (including template vs non-template),
         searches all of them to find the one containing the marker.
         """
-        source = file_path.read_bytes()
+        parsed = self.parse_source(file_path)
+        source = parsed.data
 
         # Find ALL functions with this name (handles template vs non-template, overloads)
         nodes = self.cpp_parser._find_all_nodes_by_qualified_name(source, function_name, ["function_definition"])
@@ -151,7 +158,7 @@ class CppExtractor(BaseExtractor):
             )
 
             # Check if this overload has the marker
-            markers = self.find_markers_in_node(node)
+            markers = self.find_markers_in_node(node, parsed)
             if marker in markers:
                 return self._extract_node_marker(file_path, result, marker, f"function '{function_name}'")
 
@@ -180,10 +187,10 @@ class CppExtractor(BaseExtractor):
         Raises:
             ValueError: If struct/class not found
         """
-        source = file_path.read_bytes()
+        source = self.read_source(file_path)
 
-        # Use the SimpleCppParser to extract struct/class - returns ExtractionResult
-        result = self.cpp_parser.extract_struct_or_class_by_name(source, struct_name)
+        # Symbol table lookup plus a slice - the node is not needed here
+        result = self.cpp_parser.extract_struct_or_class_by_name(source, struct_name, with_node=False)
 
         if not result:
             raise ValueError(f"Struct/class '{struct_name}' not found in {file_path}")
@@ -193,7 +200,7 @@ class CppExtractor(BaseExtractor):
 
     def extract_struct_marker(self, file_path: Path, struct_name: str, marker: str) -> Tuple[str, int, int]:
         """Extract a marked section from within a struct/class/enum/variable declaration."""
-        source = file_path.read_bytes()
+        source = self.read_source(file_path)
         result = self.cpp_parser.extract_struct_or_class_by_name(source, struct_name)
 
         if not result:
@@ -217,22 +224,38 @@ class CppExtractor(BaseExtractor):
         Raises:
             ValueError: If no match or multiple matches found
         """
-        source = file_path.read_bytes()
+        source = self.read_source(file_path)
+        result = self._find_macro_invocation(source, macro_spec)
+
+        # Return the single match with its full body
+        full_text = source[result.start_byte : result.end_byte].decode("utf8")
+
+        start_line = result.start_row + 1
+        # Calculate end line from the full text
+        end_line = start_line + full_text.count("\n")
+
+        logger.debug(f"Found {result.name} at lines {start_line}-{end_line}")
+        return full_text, start_line, end_line
+
+    def _find_macro_invocation(self, source: bytes, macro_spec: Dict) -> MacroInvocation:
+        """
+        The single invocation matching a macro spec, from the file's symbol table.
 
+        Raises:
+            ValueError: If no match or multiple matches found
+        """
         macro_name = macro_spec.get("name")
         if not macro_name:
             raise ValueError("macro spec must include 'name'")
 
-        # Find all instances of the macro
-        results = self.macro_finder.find_by_name(source, macro_name)
+        # Find all instances of the macro in the symbol table
+        results = self.cpp_parser.symbol_table(source).find_macro_invocations(macro_name)
 
         # Filter by any specified arguments
         for key, value in macro_spec.items():
             if key.startswith("arg"):
                 position = int(key[3:])
-                results = [
-                    r for r in results if position < len(r["arguments"]) and r["arguments"][position].strip() == value
-                ]
+                results = [r for r in results if position < len(r.arguments) and r.arguments[position].strip() == value]
 
         # Check we have exactly one match
         if not results:
@@ -243,25 +266,11 @@ class CppExtractor(BaseExtractor):
             raise ValueError(
                 f"Multiple {macro_name} instances found ({len(results)} matches). "
                 f"Please be more specific. Found at lines: "
-                f"{', '.join(str(r['line']) for r in results[:5])}"
+                f"{', '.join(str(r.start_row + 1) for r in results[:5])}"
                 f"{'...' if len(results) > 5 else ''}"
             )
 
-        # Return the single match - need to get FULL text with body
-        result = results[0]
-
-        # Get the full text directly from the node (result['text'] is truncated)
-        # We need to re-extract with full_body=True
-        macro_node_start = result["start_byte"]
-        macro_node_end = result["end_byte"]
-        full_text = source[macro_node_start:macro_node_end].decode("utf8")
-
-        start_line = result["line"]
-        # Calculate end line from the full text
-        end_line = start_line + full_text.count("\n")
-
-        logger.debug(f"Found {macro_name} at lines {start_line}-{end_line}")
-        return full_text, start_line, end_line
+        return results[0]
 
     def extract_function_macro_marker(self, file_path: Path, macro_spec: Dict, marker: str) -> Tuple[str, int, int]:
         """
@@ -275,32 +284,18 @@ class CppExtractor(BaseExtractor):
         Returns:
             Tuple of (code_text, start_line, end_line)
         """
-        source = file_path.read_bytes()
-
-        macro_name = macro_spec.get("name")
-        if not macro_name:
-            raise ValueError("macro spec must include 'name'")
-
-        # Build macro_args dict for filtering
-        macro_args = {}
-        for key, value in macro_spec.items():
-            if key.startswith("arg"):
-                macro_args[key] = value
+        source = self.read_source(file_path)
+        result = self._find_macro_invocation(source, macro_spec)
 
-        # Use the unified macro_finder to find and extract
-        section_code = self.macro_finder.extract_macro_section(
-            source, macro_name, marker, macro_args if macro_args else None
-        )
-
-        # Get line info for the section
-        info = self.macro_finder.find_markers_in_macro(source, macro_name, macro_args if macro_args else None)
+        markers = marker_table(source).lines_in_range(result.start_byte, result.end_byte)
+        if marker not in markers:
+            available = ", ".join(markers.keys()) if markers else "none"
+            raise ValueError(f"Marker '{marker}' not found in {result.name}. Available: {available}")
 
-        if marker not in info["markers"]:
-            raise ValueError(f"Marker '{marker}' not found in macro")
+        start_line, end_line = markers[marker]
+        section_code = get_parse_cache().lines(source, start_line, end_line)
 
-        start_line, end_line = info["markers"][marker]
-
-        logger.debug(f"Found marker '{marker}' in {macro_name} at lines {start_line}-{end_line}")
+        logger.debug(f"Found marker '{marker}' in {result.name} at lines {start_line}-{end_line}")
         return section_code, start_line, end_line
 
     def extract_macro_definition(self, file_path: Path, macro_name: str) -> Tuple[str, int, int]:
@@ -317,10 +312,14 @@ class CppExtractor(BaseExtractor):
         Raises:
             ValueError: If macro definition not found
         """
-        source = file_path.read_bytes()
+        source = self.read_source(file_path)
+
+        definition = self.cpp_parser.symbol_table(source).find_macro_definition(macro_name)
+        if not definition:
+            raise ValueError(f"Macro definition '{macro_name}' not found")
 
-        # Use the macro definition finder to extract
-        text, start_line, end_line = self.macro_def_finder.extract_definition_text(source, macro_name)
+        text = source[definition.start_byte : definition.end_byte].decode("utf8")
+        start_line, end_line = definition.start_line, definition.end_line
 
         logger.debug(f"Found macro definition '{macro_name}' at lines {start_line}-{end_line}")
         return text, start_line, end_line
@@ -348,7 +347,7 @@ class CppExtractor(BaseExtractor):
         '''
 
         try:
-            query = Query(self.language, query_text)
+            query = compile_query(self.language, query_text)
             cursor = QueryCursor(query)
             matches = cursor.matches(root)
 
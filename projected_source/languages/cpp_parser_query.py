@@ -6,10 +6,11 @@ C++ parser using tree-sitter queries - much cleaner approach.
 import logging
 from typing import Optional
 
-import tree_sitter_cpp as tscpp
-from tree_sitter import Language, Parser, Query, QueryCursor
+from tree_sitter import Parser, Query, QueryCursor
 
+from ..core.parse_cache import get_parse_cache
 from .extraction_result import ExtractionResult
+from .grammars import cpp_language
 from .utils import node_text
 
 logger = logging.getLogger(__name__)
@@ -19,7 +20,7 @@ class QueryBasedCppParser:
     """C++ parser using tree-sitter queries for cleaner extraction."""
 
     def __init__(self):
-        self.language = Language(tscpp.language())
+        self.language = cpp_language()
         self.parser = Parser(self.language)
 
     def extract_struct_or_class_by_name(self, source_code: bytes, name: str) -> Optional[ExtractionResult]:
@@ -28,7 +29,7 @@ class QueryBasedCppParser:
 
         This is much cleaner than manual traversal!
         """
-        tree = self.parser.parse(source_code)
+        tree = get_parse_cache().parse(self.language, source_code).tree
         root = tree.root_node
 
         # Parse the qualified name
@@ -183,7 +184,7 @@ class QueryBasedCppParser:
         """
         Extract a function using tree-sitter queries.
         """
-        tree = self.parser.parse(source_code)
+        tree = get_parse_cache().parse(self.language, source_code).tree
         root = tree.root_node
 
         # Parse the qualified name
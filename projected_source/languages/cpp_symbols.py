@@ -0,0 +1,929 @@
+"""
+Per-file C++ symbol tables.
+
+A symbol table is built by walking a file's tree once and recording every candidate
+that the qualified-name lookups in SimpleCppParser could match: functions, out-of-line
+methods, field_declaration methods, structs/classes/enums, variable declarations,
+#define statements and function-macro invocations. Each entry carries its qualified
+name, parameter signature and byte/line range, so extraction becomes a table lookup
+plus a slice of the source bytes.
+
+Candidates are recorded in the order the original recursive searches visited them,
+which keeps "first match wins" lookups returning exactly the same node.
+
+Overload candidates also carry their normalized parameter types, so signature=
+selection is a hashed lookup in a per-name OverloadSet (built once per table) that
+only falls back to matching signature text when no parameter list equals it.
+
+Tables are cached in memory by content hash and, when a symbol index is configured
+(see core/symbol_index.py), persisted on disk so later runs skip the walk entirely.
+"""
+
+import logging
+import re
+from dataclasses import dataclass, field
+from typing import Dict, Iterator, List, NamedTuple, Optional, Sequence, Tuple
+
+from tree_sitter import Node
+
+from ..core.parse_cache import get_parse_cache
+from .grammars import cpp_language
+from .utils import node_text
+
+logger = logging.getLogger(__name__)
+
+# Bump when the table layout or the candidate rules change; persisted tables are rebuilt.
+SYMBOL_TABLE_VERSION = 2
+
+CLASS_TYPES = ("class_specifier", "struct_specifier", "enum_specifier")
+
+# Node types searched by extract_function_by_name / extract_struct_or_class_by_name
+FUNCTION_NODE_TYPES = ("function_definition",)
+TYPE_NODE_TYPES = ("class_specifier", "struct_specifier", "enum_specifier", "declaration")
+
+# Candidate kinds, each with its own matching rule (see symbol_matches)
+KIND_FUNCTION = "function"  # function_definition, template-aware name and qualifier matching
+KIND_METHOD_DECL = "method_declaration"  # field_declaration with a function_declarator
+KIND_TYPE = "type"  # struct/class/enum specifier
+KIND_VARIABLE = "variable"  # declaration with an init_declarator
+KIND_TEMPLATE_FUNCTION = "template_function"  # overload candidate inside template_declaration
+
+
+class Symbol(NamedTuple):
+    """One lookup candidate: name, context and the range of the node a match returns."""
+
+    kind: str
+    name: str
+    qualifiers: Tuple[str, ...]
+    node_type: str
+    start_byte: int
+    end_byte: int
+    start_row: int
+    start_column: int
+    end_row: int
+    end_column: int
+    signature: str = ""
+    # Parameter types without names or default values, normalized by normalize_signature()
+    parameter_types: str = ""
+
+
+class MacroInvocation(NamedTuple):
+    """A function-macro invocation (call or macro-defined function) with its arguments."""
+
+    name: str
+    arguments: Tuple[str, ...]
+    type: str  # 'call' or 'definition'
+    start_byte: int
+    end_byte: int
+    start_row: int
+    start_column: int
+    end_row: int
+    end_column: int
+
+
+class MacroDefinitionEntry(NamedTuple):
+    """A #define statement."""
+
+    name: str
+    type: str  # 'object' or 'function'
+    parameters: Optional[str]
+    start_byte: int
+    end_byte: int
+    start_line: int
+    end_line: int
+
+
+@dataclass
+class OverloadSet:
+    """The overload candidates of one qualified name, indexed by normalized parameter types."""
+
+    candidates: List[Symbol]
+    by_types: Dict[str, List[Symbol]] = field(default_factory=dict)
+
+    def __post_init__(self):
+        for symbol in self.candidates:
+            self.by_types.setdefault(symbol.parameter_types, []).append(symbol)
+
+    def select(self, signature: str) -> List[Symbol]:
+        """
+        Candidates matching a signature= argument, in document order.
+
+        A signature equal to a candidate's parameter types ("int, std::string const&")
+        is one hashed lookup. Otherwise candidates whose parameter list contains the
+        text are returned ("TMProposeSet", "int code"), and failing that, those whose
+        normalized parameter types contain it, which ignores spacing differences.
+        """
+        key = normalize_signature(signature)
+        exact = self.by_types.get(key)
+        if exact:
+            return list(exact)
+        matching = [symbol for symbol in self.candidates if signature in symbol.signature]
+        if matching:
+            return matching
+        return [symbol for symbol in self.candidates if key and key in symbol.parameter_types]
+
+    def signatures(self) -> List[str]:
+        """Parameter lists of all candidates, for error messages."""
+        return [symbol.signature for symbol in self.candidates]
+
+
+@dataclass
+class CppSymbolTable:
+    """
+    All lookup candidates of one C++ file.
+
+    Streams:
+        functions: candidates for the first-match function search
+        types: candidates for the first-match struct/class/enum/variable search
+        overloads: candidates for the collect-all (overload) search
+    """
+
+    functions: List[Symbol] = field(default_factory=list)
+    types: List[Symbol] = field(default_factory=list)
+    overloads: List[Symbol] = field(default_factory=list)
+    macro_definitions: List[MacroDefinitionEntry] = field(default_factory=list)
+    macro_invocations: List[MacroInvocation] = field(default_factory=list)
+
+    def __post_init__(self):
+        self._functions_by_leaf = _index_by_leaf(self.functions)
+        self._types_by_leaf = _index_by_leaf(self.types)
+        self._overloads_by_leaf = _index_by_leaf(self.overloads)
+        self._macros_by_name: Dict[str, List[MacroInvocation]] = {}
+        for invocation in self.macro_invocations:
+            self._macros_by_name.setdefault(invocation.name, []).append(invocation)
+        # (qualified name, include_functions) -> OverloadSet, built on first selection
+        self._overload_sets: Dict[Tuple[str, bool], OverloadSet] = {}
+
+    # ==================== Lookups ====================
+
+    def find_function(self, target_name: str) -> Optional[Symbol]:
+        """First function candidate matching a qualified name (same rules as the tree search)."""
+        return self._first(self.functions, self._functions_by_leaf, target_name)
+
+    def find_type(self, target_name: str) -> Optional[Symbol]:
+        """First struct/class/enum/variable candidate matching a qualified name."""
+        return self._first(self.types, self._types_by_leaf, target_name)
+
+    def find_overloads(self, target_name: str, include_functions: bool = True) -> List[Symbol]:
+        """
+        All overload candidates matching a qualified name, in document order.
+
+        Args:
+            target_name: Qualified name to search for
+            include_functions: False when function_definition is not among the searched
+                node types, in which case only template functions are collected
+        """
+        leaf, qualifiers = split_qualified_name(target_name)
+        results = []
+        for index in self._overloads_by_leaf.get(leaf, ()):
+            symbol = self.overloads[index]
+            if not include_functions and symbol.kind != KIND_TEMPLATE_FUNCTION:
+                continue
+            if symbol.kind == KIND_TEMPLATE_FUNCTION:
+                base = symbol.name.split("<")[0] if "<" in symbol.name else symbol.name
+                if base != leaf and symbol.name != leaf:
+                    continue
+            elif symbol.name != leaf:
+                continue
+            if qualifiers_match(symbol.qualifiers, qualifiers):
+                results.append(symbol)
+        return results
+
+    def overload_set(self, target_name: str, include_functions: bool = True) -> OverloadSet:
+        """Overload candidates of a qualified name with their signature index (see find_overloads())."""
+        key = (target_name, include_functions)
+        overloads = self._overload_sets.get(key)
+        if overloads is None:
+            overloads = self._overload_sets.setdefault(key, OverloadSet(self.find_overloads(*key)))
+        return overloads
+
+    def find_macro_invocations(self, name: str) -> List[MacroInvocation]:
+        """All invocations of a function-macro, in query match order."""
+        return list(self._macros_by_name.get(name, ()))
+
+    def find_macro_definition(self, name: str) -> Optional[MacroDefinitionEntry]:
+        """First #define of a macro."""
+        for definition in self.macro_definitions:
+            if definition.name == name:
+                return definition
+        return None
+
+    def _first(self, stream: List[Symbol], by_leaf: Dict[str, List[int]], target_name: str) -> Optional[Symbol]:
+        leaf, qualifiers = split_qualified_name(target_name)
+        for index in by_leaf.get(leaf, ()):
+            symbol = stream[index]
+            if symbol_matches(symbol, leaf, qualifiers):
+                return symbol
+        return None
+
+    # ==================== Serialization ====================
+
+    def to_dict(self) -> Dict:
+        """Plain-data form for the on-disk index."""
+        return {
+            "version": SYMBOL_TABLE_VERSION,
+            "functions": [list(s) for s in self.functions],
+            "types": [list(s) for s in self.types],
+            "overloads": [list(s) for s in self.overloads],
+            "macro_definitions": [list(m) for m in self.macro_definitions],
+            "macro_invocations": [list(m) for m in self.macro_invocations],
+        }
+
+    @classmethod
+    def from_dict(cls, data: Dict) -> Optional["CppSymbolTable"]:
+        """Rebuild a table from to_dict() output; None if it was written by another table version."""
+        if data.get("version") != SYMBOL_TABLE_VERSION:
+            return None
+
+        def symbols(rows):
+            return [Symbol(r[0], r[1], tuple(r[2]), *r[3:]) for r in rows]
+
+        return cls(
+            functions=symbols(data["functions"]),
+            types=symbols(data["types"]),
+            overloads=symbols(data["overloads"]),
+            macro_definitions=[MacroDefinitionEntry(*r) for r in data["macro_definitions"]],
+            macro_invocations=[MacroInvocation(r[0], tuple(r[1]), *r[2:]) for r in data["macro_invocations"]],
+        )
+
+    def names(self) -> Iterator[Tuple[str, str, str]]:
+        """(kind, leaf name, qualified name) for every symbol, used for cross-file name lookups."""
+        seen = set()
+        for symbol in self.functions + self.types + self.overloads:
+            qualified = "::".join(symbol.qualifiers + (symbol.name,))
+            key = (symbol.kind, symbol.name, qualified)
+            if key not in seen:
+                seen.add(key)
+                yield key
+        for definition in self.macro_definitions:
+            yield ("macro_definition", definition.name, definition.name)
+        for invocation in self.macro_invocations:
+            key = ("macro_invocation", invocation.name, invocation.name)
+            if key not in seen:
+                seen.add(key)
+                yield key
+
+
+def split_qualified_name(target_name: str) -> Tuple[str, Tuple[str, ...]]:
+    """Split "ns::Class::name" into ("name", ("ns", "Class"))."""
+    parts = target_name.split("::")
+    return parts[-1], tuple(parts[:-1])
+
+
+def _index_by_leaf(stream: List[Symbol]) -> Dict[str, List[int]]:
+    """Map leaf names (and template base names) to stream positions, preserving order."""
+    by_leaf: Dict[str, List[int]] = {}
+    for index, symbol in enumerate(stream):
+        by_leaf.setdefault(symbol.name, []).append(index)
+        if "<" in symbol.name:
+            base = symbol.name.split("<")[0]
+            if base != symbol.name:
+                by_leaf.setdefault(base, []).append(index)
+    return by_leaf
+
+
+def qualifiers_match(found: Sequence[str], target: Sequence[str]) -> bool:
+    """Check if qualifier lists match (exact or suffix)."""
+    found = tuple(found)
+    target = tuple(target)
+    if not target:
+        return True
+    if found == target:
+        return True
+    if len(found) >= len(target) and found[-len(target) :] == target:
+        return True
+    return False
+
+
+def template_qualifiers_match(found_quals: Sequence[str], target_quals: Sequence[str]) -> bool:
+    """Check if qualifier lists match, handling template types.
+
+    Container<T> matches Container<T> (exact)
+    Container<T> matches Container (base name)
+    """
+    if len(found_quals) != len(target_quals):
+        return False
+    for found_q, target_q in zip(found_quals, target_quals):
+        if found_q == target_q:
+            continue
+        # Try matching base name for templates
+        found_base = found_q.split("<")[0] if "<" in found_q else found_q
+        target_base = target_q.split("<")[0] if "<" in target_q else target_q
+        if found_base != target_base:
+            return False
+    return True
+
+
+def symbol_matches(symbol: Symbol, leaf: str, qualifiers: Tuple[str, ...]) -> bool:
+    """Apply the matching rule of the search that produced this candidate."""
+    if symbol.kind == KIND_FUNCTION:
+        # For template functions, also match the base name without template args
+        name_matches = symbol.name == leaf
+        if not name_matches and symbol.name and "<" in symbol.name:
+            name_matches = symbol.name.split("<")[0] == leaf
+        if not name_matches:
+            return False
+        if not qualifiers:
+            return True
+        found = symbol.qualifiers
+        if template_qualifiers_match(found, qualifiers):
+            return True
+        return len(found) >= len(qualifiers) and template_qualifiers_match(found[-len(qualifiers) :], qualifiers)
+
+    return symbol.name == leaf and qualifiers_match(symbol.qualifiers, qualifiers)
+
+
+# ==================== Tree walks ====================
+
+
+def extract_operator_name(op_node: Node) -> str:
+    """Extract operator name like 'operator+', 'operator==', 'operator[]'."""
+    # operator_name contains 'operator' keyword and the symbol(s)
+    parts = []
+    for child in op_node.children:
+        if child.text:
+            parts.append(node_text(child))
+    return "".join(parts)
+
+
+def _namespace_context(node: Node, context: Tuple[str, ...]) -> Tuple[str, ...]:
+    """Context inside a namespace_definition (nested "a::b" namespaces add both parts)."""
+    name_node = node.child_by_field_name("name")
+    namespace_name = None
+    if name_node:
+        # The name field could be different node types
+        namespace_name = node_text(name_node)
+        # Remove trailing :: if present
+        if namespace_name.endswith("::"):
+            namespace_name = namespace_name.rstrip(":")
+
+    if namespace_name and "::" in namespace_name:
+        return context + tuple(namespace_name.split("::"))
+    return context + ((namespace_name,) if namespace_name else ())
+
+
+def _class_name(node: Node) -> Optional[str]:
+    for child in node.children:
+        if child.type == "type_identifier":
+            return node_text(child)
+    return None
+
+
+def _variable_name(node: Node) -> Optional[str]:
+    """Variable name from a declaration's init_declarator."""
+    var_name = None
+    for child in node.children:
+        if child.type == "init_declarator":
+            # Look for identifier in array_declarator, pointer_declarator, or direct
+            for subchild in child.children:
+                if subchild.type == "identifier":
+                    var_name = subchild.text.decode("utf8") if subchild.text else None
+                    break
+                elif subchild.type in ["array_declarator", "pointer_declarator"]:
+                    for leaf in subchild.children:
+                        if leaf.type == "identifier":
+                            var_name = leaf.text.decode("utf8") if leaf.text else None
+                            break
+                    if var_name:
+                        break
+            break
+    return var_name
+
+
+def _template_type_name(tt_node: Node) -> Optional[str]:
+    """Name of a template_type including its arguments, like 'Container<T>'."""
+    type_id = None
+    template_args = None
+    for child in tt_node.children:
+        if child.type == "type_identifier":
+            type_id = node_text(child)
+        elif child.type == "template_argument_list":
+            template_args = child.text.decode("utf8")
+    if type_id and template_args:
+        return f"{type_id}{template_args}"
+    return type_id
+
+
+def _template_base_name(tt_node: Node) -> Optional[str]:
+    """Name of a template_type without its arguments, like 'Container'."""
+    type_id = None
+    for child in tt_node.children:
+        if child.type == "type_identifier":
+            type_id = node_text(child)
+    return type_id
+
+
+def _qualified_parts(qnode: Node, with_template_args: bool) -> List[Optional[str]]:
+    """
+    Parts of a qualified_identifier (identifiers, template types, operators).
+
+    Args:
+        qnode: The qualified_identifier node
+        with_template_args: Keep template arguments on template types (Container<T>)
+    """
+    parts = []
+    current_node = qnode
+    while current_node and current_node.type == "qualified_identifier":
+        found_nested = False
+        for child in current_node.children:
+            child_type = child.type
+            if child_type == "namespace_identifier" or child_type == "identifier":
+                parts.append(node_text(child))
+            elif child_type == "template_type":
+                if with_template_args:
+                    parts.append(_template_type_name(child))
+                else:
+                    type_id = _template_base_name(child)
+                    if type_id:
+                        parts.append(type_id)
+            elif child_type == "operator_name":
+                parts.append(extract_operator_name(child))
+            elif child_type == "qualified_identifier":
+                current_node = child
+                found_nested = True
+                break
+        if not found_nested:
+            break
+    return parts
+
+
+def _function_declarator(declarator: Node) -> Optional[Node]:
+    """Follow pointer/reference declarators down to the function_declarator, if any."""
+    current = declarator
+    while current:
+        current_type = current.type
+        if current_type == "function_declarator":
+            return current
+        elif current_type == "pointer_declarator":
+            current = current.child_by_field_name("declarator")
+        elif current_type == "reference_declarator":
+            func_decl = None
+            for child in current.children:
+                if child.type == "function_declarator":
+                    func_decl = child
+                    break
+            current = func_decl
+        else:
+            return None
+    return None
+
+
+def _definition_name(declarator: Node, context: Tuple[str, ...]) -> Tuple[Optional[str], Tuple[str, ...]]:
+    """
+    Name and qualifiers of a function_definition, as seen by the first-match search.
+
+    Unlike function_name_and_qualifiers(), this keeps template arguments on qualifiers
+    (Container<T>::method) and understands template specializations (templateAdd<int>).
+    """
+    found_name = None
+    found_qualifiers: Tuple[str, ...] = ()
+
+    current = _function_declarator(declarator)
+    if current is None:
+        return found_name, found_qualifiers
+
+    name_node = current.child_by_field_name("declarator")
+    if name_node:
+        name_type = name_node.type
+        if name_type == "qualified_identifier":
+            all_parts = _qualified_parts(name_node, with_template_args=True)
+            if all_parts:
+                found_name = all_parts[-1]
+                found_qualifiers = tuple(all_parts[:-1])
+        elif name_type == "identifier" or name_type == "field_identifier":
+            found_name = node_text(name_node)
+            found_qualifiers = context
+        elif name_type == "operator_name":
+            found_name = extract_operator_name(name_node)
+            found_qualifiers = context
+        elif name_type == "template_function":
+            # Template specialization like templateAdd<int>
+            base_name = template_args = ""
+            for child in name_node.children:
+                if child.type == "identifier":
+                    base_name = node_text(child)
+                elif child.type == "template_argument_list":
+                    template_args = node_text(child)
+            found_name = f"{base_name}{template_args}"
+            found_qualifiers = context
+    else:
+        # Sometimes for inline methods, the name is directly a child
+        for child in current.children:
+            if child.type == "field_identifier":
+                found_name = node_text(child)
+                found_qualifiers = context
+                break
+            elif child.type == "operator_name":
+                found_name = extract_operator_name(child)
+                found_qualifiers = context
+                break
+
+    return found_name, found_qualifiers
+
+
+def function_name_and_qualifiers(declarator: Node, context: Sequence[str]) -> Tuple[str, Tuple[str, ...]]:
+    """Extract function name and qualifiers from a declarator node."""
+    found_name = ""
+    found_qualifiers: Tuple[str, ...] = ()
+
+    current = _function_declarator(declarator)
+    if current is None:
+        return found_name, found_qualifiers
+
+    name_node = current.child_by_field_name("declarator")
+    if name_node:
+        name_type = name_node.type
+        if name_type == "qualified_identifier":
+            all_parts = _qualified_parts(name_node, with_template_args=False)
+            if all_parts:
+                found_name = all_parts[-1]
+                found_qualifiers = tuple(all_parts[:-1])
+        elif name_type == "identifier" or name_type == "field_identifier":
+            found_name = node_text(name_node)
+            found_qualifiers = tuple(context)
+        elif name_type == "operator_name":
+            found_name = extract_operator_name(name_node)
+            found_qualifiers = tuple(context)
+
+    return found_name, found_qualifiers
+
+
+def parameter_signature(node: Node) -> str:
+    """
+    Extract parameter types from a function definition or field_declaration node.
+
+    Returns a string like "(int, std::string const&, TMProposeSet)" - the full
+    parameter list text.
+    """
+    params_node = parameter_list(node)
+    return node_text(params_node) if params_node else ""
+
+
+def parameter_list(node: Node) -> Optional[Node]:
+    """The parameter_list node of a function definition, template or field_declaration."""
+    # Handle template_declaration by descending to inner function_definition
+    target_node = node
+    if node.type == "template_declaration":
+        for child in node.children:
+            if child.type == "function_definition":
+                target_node = child
+                break
+
+    # Handle field_declaration (class method declarations in headers)
+    # These don't have a "declarator" field - function_declarator is a direct child
+    if target_node.type == "field_declaration":
+        for child in target_node.children:
+            if child.type == "function_declarator":
+                params_node = child.child_by_field_name("parameters")
+                if params_node:
+                    return params_node
+        return None
+
+    declarator = target_node.child_by_field_name("declarator")
+    if not declarator:
+        return None
+
+    # Navigate to function_declarator
+    current = declarator
+    while current and current.type != "function_declarator":
+        if current.type == "pointer_declarator":
+            current = current.child_by_field_name("declarator")
+        elif current.type == "reference_declarator":
+            for child in current.children:
+                if child.type == "function_declarator":
+                    current = child
+                    break
+            else:
+                break
+        else:
+            break
+
+    if not current or current.type != "function_declarator":
+        return None
+
+    return current.child_by_field_name("parameters")
+
+
+_SPACE_RE = re.compile(r"\s+")
+# Spaces that do not separate words: before closing punctuation and declarator operators,
+# after opening punctuation, and around "::"
+_PUNCTUATION_SPACE_RE = re.compile(r" (?=[&*,)\]>])|(?<=[(\[<,]) | ?:: ?")
+
+
+def normalize_signature(text: str) -> str:
+    """
+    Canonical spelling of parameter type text: no enclosing parentheses, single spaces,
+    none before "&", "*" or closing brackets and one after each comma
+    ("std::vector<int> const &x" -> "std::vector<int> const&x").
+    """
+    text = _SPACE_RE.sub(" ", text).strip()
+    if text.startswith("(") and text.endswith(")"):
+        text = text[1:-1].strip()
+    text = _PUNCTUATION_SPACE_RE.sub(lambda m: "::" if "::" in m.group() else "", text)
+    return text.replace(",", ", ")
+
+
+def _declared_name(declarator: Node) -> Optional[Node]:
+    """The identifier a parameter declarator names, if any (abstract declarators have none)."""
+    while declarator is not None:
+        if declarator.type == "identifier":
+            return declarator
+        if declarator.type == "parameter_list":
+            # Names of a function pointer's own parameters are not the parameter's name
+            return None
+        inner = declarator.child_by_field_name("declarator")
+        if inner is None:
+            # Reference declarators hold their declarator as a plain child
+            inner = next((child for child in declarator.named_children if child.type != "type_qualifier"), None)
+        declarator = inner
+    return None
+
+
+def parameter_types(params_node: Optional[Node]) -> str:
+    """
+    Normalized parameter types of a parameter_list: names and default values dropped,
+    e.g. "(std::string const& name, int n = 0)" -> "std::string const&, int".
+    """
+    if params_node is None:
+        return ""
+    types = []
+    for param in params_node.named_children:
+        if param.type == "comment":
+            continue
+        data = param.text or b""
+        end = len(data)
+        default = param.child_by_field_name("default_value")
+        if default is not None:
+            # Cut at the "=" before the default value
+            for child in param.children:
+                if child.type == "=":
+                    end = child.start_byte - param.start_byte
+                    break
+        name = _declared_name(param.child_by_field_name("declarator"))
+        if name is not None and name.end_byte - param.start_byte <= end:
+            start, stop = name.start_byte - param.start_byte, name.end_byte - param.start_byte
+            data = data[:start] + data[stop:end]
+        else:
+            data = data[:end]
+        types.append(data.decode("utf8", errors="replace"))
+    return normalize_signature(", ".join(types))
+
+
+# A candidate event: (node a match returns, kind, name, qualifiers)
+Candidate = Tuple[Node, str, str, Tuple[str, ...]]
+
+
+def iter_first_match_candidates(root: Node, node_types: Sequence[str]) -> Iterator[Candidate]:
+    """
+    Yield candidates in the order the first-match qualified-name search tests them.
+
+    Namespace and class bodies are searched with their extended context and then
+    again by the generic child recursion with the outer context; a function found
+    inside a template_declaration is reported as the template_declaration itself.
+    A (node, context) pair is only expanded once: repeated visits can only produce
+    candidates that were already tested. Leaf nodes (tokens, which make up about
+    half of a tree) are never visited since no rule yields or recurses at a leaf.
+    """
+    node_types = set(node_types)
+    wants_declarations = "declaration" in node_types
+    wants_functions = "function_definition" in node_types
+    seen = set()
+
+    def visit(node: Node, context: Tuple[str, ...]) -> Iterator[Candidate]:
+        key = (node.id, context)
+        if key in seen:
+            return
+        seen.add(key)
+
+        children = node.children
+        node_type = node.type
+        if node_type == "namespace_definition":
+            new_context = _namespace_context(node, context)
+            body = node.child_by_field_name("body")
+            if body and body.type == "declaration_list":
+                for decl in body.children:
+                    if decl.child_count:
+                        yield from visit(decl, new_context)
+
+        elif node_type in CLASS_TYPES:
+            class_name = _class_name(node)
+            if node_type in node_types and class_name:
+                yield node, KIND_TYPE, class_name, context
+
+            # Search the class/struct body with updated context
+            if class_name:
+                new_context = context + (class_name,)
+                for child in children:
+                    if child.type == "field_declaration_list":
+                        for member in child.children:
+                            if member.child_count:
+                                yield from visit(member, new_context)
+
+        elif node_type == "declaration" and wants_declarations:
+            var_name = _variable_name(node)
+            if var_name:
+                yield node, KIND_VARIABLE, var_name, context
+
+        elif node_type == "function_definition" and wants_functions:
+            declarator = node.child_by_field_name("declarator")
+            if declarator:
+                found_name, found_qualifiers = _definition_name(declarator, context)
+                if found_name:
+                    yield node, KIND_FUNCTION, found_name, found_qualifiers
+
+        elif node_type == "field_declaration" and wants_functions:
+            # field_declaration can contain a function_declarator for method declarations
+            declarator = node.child_by_field_name("declarator")
+            if declarator and declarator.type == "function_declarator":
+                found_name, found_qualifiers = function_name_and_qualifiers(declarator, context)
+                if found_name:
+                    yield node, KIND_METHOD_DECL, found_name, found_qualifiers
+
+        elif node_type == "template_declaration":
+            for child in children:
+                if child.type == "function_definition":
+                    # Anything found in the function is reported as the whole template declaration
+                    for _, kind, name, qualifiers in visit(child, context):
+                        yield node, kind, name, qualifiers
+                elif child.type in CLASS_TYPES:
+                    yield from visit(child, context)
+
+        # Recurse into children
+        for child in children:
+            if child.child_count:
+                yield from visit(child, context)
+
+    yield from visit(root, ())
+
+
+def iter_overload_candidates(root: Node) -> Iterator[Candidate]:
+    """
+    Yield candidates in the order the collect-all (overload) search tests them.
+
+    Each node is visited once: namespace and class bodies are only searched with
+    their extended context, and template_declaration children are not recursed into.
+    Leaf nodes are skipped as in iter_first_match_candidates().
+    """
+
+    def visit(node: Node, context: Tuple[str, ...]) -> Iterator[Candidate]:
+        children = node.children
+        node_type = node.type
+        if node_type == "namespace_definition":
+            new_context = _namespace_context(node, context)
+            body = node.child_by_field_name("body")
+            if body and body.type == "declaration_list":
+                for decl in body.children:
+                    if decl.child_count:
+                        yield from visit(decl, new_context)
+            return
+
+        elif node_type in ("class_specifier", "struct_specifier"):
+            class_name = _class_name(node)
+            if class_name:
+                new_context = context + (class_name,)
+                for child in children:
+                    if child.type == "field_declaration_list":
+                        for member in child.children:
+                            if member.child_count:
+                                yield from visit(member, new_context)
+            return
+
+        elif node_type == "function_definition":
+            declarator = node.child_by_field_name("declarator")
+            if declarator:
+                found_name, found_qualifiers = function_name_and_qualifiers(declarator, context)
+                if found_name:
+                    yield node, KIND_FUNCTION, found_name, found_qualifiers
+
+        elif node_type == "field_declaration":
+            declarator = node.child_by_field_name("declarator")
+            if declarator and declarator.type == "function_declarator":
+                found_name, found_qualifiers = function_name_and_qualifiers(declarator, context)
+                if found_name:
+                    yield node, KIND_METHOD_DECL, found_name, found_qualifiers
+
+        elif node_type == "template_declaration":
+            for child in children:
+                if child.type == "function_definition":
+                    declarator = child.child_by_field_name("declarator")
+                    if declarator:
+                        found_name, found_qualifiers = function_name_and_qualifiers(declarator, context)
+                        yield node, KIND_TEMPLATE_FUNCTION, found_name, found_qualifiers
+            # Don't recurse into template children - we already handled the function
+            return
+
+        for child in children:
+            if child.child_count:
+                yield from visit(child, context)
+
+    yield from visit(root, ())
+
+
+def _symbol(node: Node, kind: str, name: str, qualifiers: Tuple[str, ...], with_signature: bool) -> Symbol:
+    return Symbol(
+        kind=kind,
+        name=name,
+        qualifiers=tuple(qualifiers),
+        node_type=node.type,
+        start_byte=node.start_byte,
+        end_byte=node.end_byte,
+        start_row=node.start_point.row,
+        start_column=node.start_point.column,
+        end_row=node.end_point.row,
+        end_column=node.end_point.column,
+        signature=parameter_signature(node) if with_signature else "",
+        parameter_types=parameter_types(parameter_list(node)) if with_signature else "",
+    )
+
+
+def build_symbol_table(source: bytes) -> CppSymbolTable:
+    """Walk a file once and record all lookup candidates."""
+    # Import here to avoid circular imports (the finders use the parse cache only)
+    from .macro_definition_finder import MacroDefinitionFinder
+    from .macro_finder_v3 import MacroFinder
+
+    root = get_parse_cache().parse(cpp_language(), source).root_node
+
+    functions = [_symbol(*c, with_signature=True) for c in iter_first_match_candidates(root, FUNCTION_NODE_TYPES)]
+    types = [_symbol(*c, with_signature=False) for c in iter_first_match_candidates(root, TYPE_NODE_TYPES)]
+    overloads = [_symbol(*c, with_signature=True) for c in iter_overload_candidates(root)]
+
+    macro_definitions = [
+        MacroDefinitionEntry(
+            name=d["name"],
+            type=d["type"],
+            parameters=d["parameters"],
+            start_byte=d["start_byte"],
+            end_byte=d["end_byte"],
+            start_line=d["start_line"],
+            end_line=d["end_line"],
+        )
+        for d in MacroDefinitionFinder().find_all_definitions(source)
+    ]
+    macro_invocations = [
+        MacroInvocation(
+            name=r["macro"],
+            arguments=tuple(r["arguments"]),
+            type=r["type"],
+            start_byte=r["start_byte"],
+            end_byte=r["end_byte"],
+            start_row=r["start_point"][0],
+            start_column=r["start_point"][1],
+            end_row=r["end_point"][0],
+            end_column=r["end_point"][1],
+        )
+        for r in MacroFinder().find_all_invocations(source)
+    ]
+
+    return CppSymbolTable(
+        functions=functions,
+        types=types,
+        overloads=overloads,
+        macro_definitions=macro_definitions,
+        macro_invocations=macro_invocations,
+    )
+
+
+def get_symbol_table(source: bytes) -> CppSymbolTable:
+    """
+    Get the symbol table for source bytes.
+
+    Looks in the in-memory cache (by content hash), then in the configured on-disk
+    symbol index, and only walks the tree when neither has the table.
+    """
+    from ..core.symbol_index import get_symbol_index
+
+    cache = get_parse_cache()
+    digest = cache.digest(source)
+
+    def build() -> CppSymbolTable:
+        index = get_symbol_index()
+        if index is not None:
+            table = index.load(digest)
+            if table is not None:
+                return table
+
+        table = build_symbol_table(source)
+        if index is not None:
+            index.store(digest, table)
+        return table
+
+    return cache.derived(digest, "cpp_symbols", build)
+
+
+def resolve_node(root: Node, symbol) -> Optional[Node]:
+    """
+    Find the tree node a table entry was recorded from.
+
+    The smallest node spanning the recorded range is the node itself or a descendant
+    with the same range, so walking up to the recorded node type finds it.
+    """
+    node = root.descendant_for_byte_range(symbol.start_byte, symbol.end_byte)
+    while node is not None:
+        if node.start_byte == symbol.start_byte and node.end_byte == symbol.end_byte:
+            if node.type == symbol.node_type:
+                return node
+        elif node.start_byte < symbol.start_byte or node.end_byte > symbol.end_byte:
+            break
+        node = node.parent
+    return None
@@ -0,0 +1,42 @@
+"""
+Shared tree-sitter Language objects.
+
+Each grammar is loaded once per process so that every parser, compiled query and
+the parse cache agree on the same Language instance.
+"""
+
+import ctypes
+from functools import lru_cache
+from pathlib import Path
+
+from tree_sitter import Language, Query
+
+# Proto grammar is bundled as a compiled .so file
+PROTO_SO_PATH = Path(__file__).parent / "proto_grammar" / "proto.so"
+
+
+@lru_cache(maxsize=None)
+def cpp_language() -> Language:
+    """Get the C/C++ language."""
+    # Imported here so processes that never touch C++ skip loading the grammar
+    import tree_sitter_cpp as tscpp
+
+    return Language(tscpp.language())
+
+
+@lru_cache(maxsize=None)
+def proto_language() -> Language:
+    """Load the proto language from the bundled .so file."""
+    if not PROTO_SO_PATH.exists():
+        raise RuntimeError(
+            f"Proto grammar not found at {PROTO_SO_PATH}. See .ai-docs/proto-investigations.md for build instructions."
+        )
+    lib = ctypes.CDLL(str(PROTO_SO_PATH))
+    lib.tree_sitter_proto.restype = ctypes.c_void_p
+    return Language(lib.tree_sitter_proto())
+
+
+@lru_cache(maxsize=256)
+def compile_query(language: Language, source: str) -> Query:
+    """Compile a tree-sitter query once per process."""
+    return Query(language, source)
@@ -9,9 +9,10 @@ This module finds the actual #define statements themselves.
 import logging
 from typing import List, Optional, Tuple, TypedDict
 
-import tree_sitter_cpp as tscpp
-from tree_sitter import Language, Node, Parser, Query, QueryCursor
+from tree_sitter import Node, QueryCursor
 
+from ..core.parse_cache import get_parse_cache
+from .grammars import compile_query, cpp_language
 from .utils import node_text
 
 logger = logging.getLogger(__name__)
@@ -37,9 +38,16 @@ class MacroDefinitionFinder:
     Find C/C++ macro definitions (#define statements) using tree-sitter.
     """
 
+    # Query for all macro definitions - compiled once, filtered by name in Python
+    DEFINITIONS_QUERY = """
+    [
+      (preproc_def) @macro
+      (preproc_function_def) @macro
+    ]
+    """
+
     def __init__(self):
-        self.language = Language(tscpp.language())
-        self.parser = Parser(self.language)
+        self.language = cpp_language()
 
     def find_definition(self, source: bytes, macro_name: str) -> Optional[MacroDefinition]:
         """
@@ -52,29 +60,10 @@ class MacroDefinitionFinder:
         Returns:
             MacroDefinition if found, None otherwise
         """
-        tree = self.parser.parse(source)
-
-        # Query for specific macro definition
-        query_text = f'''
-        [
-          (preproc_def
-            name: (identifier) @name (#eq? @name "{macro_name}")
-          ) @macro
-          
-          (preproc_function_def
-            name: (identifier) @name (#eq? @name "{macro_name}")
-          ) @macro
-        ]
-        '''
-
-        query = Query(self.language, query_text)
-        cursor = QueryCursor(query)
-        matches = cursor.matches(tree.root_node)
-
-        for pattern_index, captures in matches:
-            macro_nodes = captures.get("macro", [])
-            if macro_nodes:
-                return self._build_result(macro_nodes[0])
+        for node in self._definition_nodes(source):
+            name_node = node.child_by_field_name("name")
+            if name_node and node_text(name_node) == macro_name:
+                return self._build_result(node)
 
         return None
 
@@ -89,33 +78,27 @@ class MacroDefinitionFinder:
         Returns:
             List of MacroDefinition objects
         """
-        tree = self.parser.parse(source)
-
-        # Query for all macro definitions
-        query_text = """
-        [
-          (preproc_def) @macro
-          (preproc_function_def) @macro
-        ]
-        """
-
-        query = Query(self.language, query_text)
-        cursor = QueryCursor(query)
-        matches = cursor.matches(tree.root_node)
-
         results = []
-        for pattern_index, captures in matches:
-            macro_nodes = captures.get("macro", [])
-            for node in macro_nodes:
-                result = self._build_result(node)
-                if result:
-                    # Filter by prefix if specified
-                    if prefix and not result["name"].startswith(prefix):
-                        continue
-                    results.append(result)
+        for node in self._definition_nodes(source):
+            result = self._build_result(node)
+            if result:
+                # Filter by prefix if specified
+                if prefix and not result["name"].startswith(prefix):
+                    continue
+                results.append(result)
 
         return results
 
+    def _definition_nodes(self, source: bytes) -> List[Node]:
+        """All #define nodes in document order, using the single compiled definitions query."""
+        tree = get_parse_cache().parse(self.language, source).tree
+        cursor = QueryCursor(compile_query(self.language, self.DEFINITIONS_QUERY))
+
+        nodes = []
+        for pattern_index, captures in cursor.matches(tree.root_node):
+            nodes.extend(captures.get("macro", []))
+        return nodes
+
     def _build_result(self, node: Node) -> Optional[MacroDefinition]:
         """
         Build a MacroDefinition from a tree-sitter node.
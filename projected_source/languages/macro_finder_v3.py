@@ -5,13 +5,15 @@ Version 3: Ultra-DRY implementation with TypedDict and modern patterns.
 """
 
 import logging
-from enum import Enum
-from functools import lru_cache
-from typing import Any, Callable, Dict, List, Optional, Tuple, TypedDict
+import re
+from typing import Any, Dict, List, NamedTuple, Optional, Tuple, TypedDict
 
-import tree_sitter_cpp as tscpp
-from tree_sitter import Language, Node, Parser, Query, QueryCursor
+from tree_sitter import Node, QueryCursor
 
+from ..core.markers import marker_table, scan_markers
+from ..core.parse_cache import get_parse_cache
+from .cpp_symbols import resolve_node
+from .grammars import compile_query, cpp_language
 from .utils import node_text
 
 logger = logging.getLogger(__name__)
@@ -32,17 +34,20 @@ class MacroResult(TypedDict):
     end_point: Point
     line: int
     type: Optional[str]  # 'call' or 'definition'
-    node: Optional[Node]  # The actual tree-sitter node
-    args_node: Optional[Node]  # The arguments node
+    node: Optional[Node]  # The actual tree-sitter node (None in the cached table, see resolve_nodes())
+    args_node: Optional[Node]  # The arguments node (likewise)
 
 
-class PredicateType(Enum):
-    """Query predicate types."""
+class _Span(NamedTuple):
+    """Recorded range of an invocation, in the form resolve_node() takes."""
+
+    node_type: str
+    start_byte: int
+    end_byte: int
 
-    EQUALS = "#eq?"
-    MATCH = "#match?"
-    NOT_EQUALS = "#not-eq?"
-    NOT_MATCH = "#not-match?"
+
+# MacroResult type -> tree-sitter node type it was recorded from
+_NODE_TYPES = {"call": "call_expression", "definition": "function_definition"}
 
 
 class MacroFinder:
@@ -51,7 +56,7 @@ class MacroFinder:
     Focuses on code reuse and clean architecture.
     """
 
-    __slots__ = ("language", "parser", "_query_cache")
+    __slots__ = ("language",)
 
     # Single query template for all macro searches
     QUERY_TEMPLATE = """
@@ -70,20 +75,22 @@ class MacroFinder:
     ]
     """
 
+    # The one query every lookup runs (no name predicate; lookups filter its results)
+    INVOCATION_QUERY = QUERY_TEMPLATE.format(predicate="")
+
     def __init__(self):
-        self.language = Language(tscpp.language())
-        self.parser = Parser(self.language)
-        self._query_cache = {}
+        self.language = cpp_language()
 
     # ==================== Public API ====================
 
     def find_by_name(self, source: bytes, name: str) -> List[MacroResult]:
         """Find all macros with exact name match."""
-        return self._execute_query(source, self._build_query(PredicateType.EQUALS, name))
+        return list(self._by_name(source).get(name, ()))
 
     def find_by_pattern(self, source: bytes, pattern: str) -> List[MacroResult]:
         """Find all macros matching regex pattern."""
-        return self._execute_query(source, self._build_query(PredicateType.MATCH, pattern))
+        regex = re.compile(pattern)
+        return [r for r in self.invocations(source) if regex.search(r["macro"])]
 
     def find_by_argument(self, source: bytes, name: str, arg_pos: int, arg_val: str) -> List[MacroResult]:
         """Find macros where specific argument has specific value."""
@@ -92,17 +99,71 @@ class MacroFinder:
             args = result["arguments"]
             return arg_pos < len(args) and args[arg_pos].strip() == arg_val
 
-        return self._execute_query(source, self._build_query(PredicateType.EQUALS, name), filter_fn=arg_filter)
+        return [r for r in self.find_by_name(source, name) if arg_filter(r)]
 
     def find_all(self, source: bytes, names: List[str]) -> List[MacroResult]:
         """Find all occurrences of multiple macro names."""
-        # Use regex alternation for efficiency
-        pattern = "|".join(f"^{name}$" for name in names)
-        return self.find_by_pattern(source, pattern)
+        names_set = set(names)
+        return [r for r in self.invocations(source) if r["macro"] in names_set]
+
+    def find_all_invocations(self, source: bytes) -> List[MacroResult]:
+        """Find every macro-style call or definition, whatever its name (used to build symbol tables)."""
+        return list(self.invocations(source))
+
+    def invocations(self, source: bytes) -> List[MacroResult]:
+        """
+        Every macro-style call or definition of a file, in match order.
+
+        Collected by one run of the shared unfiltered query per file content; the
+        find_by_* lookups are filters over this table. Entries hold names, arguments
+        and ranges only - a tree-sitter node keeps its whole tree alive, which would
+        defeat evicting or releasing the tree - so node and args_node are None; use
+        resolve_nodes() for the nodes.
+        """
+        cache = get_parse_cache()
+
+        def build():
+            results = self._execute_query(source, self.INVOCATION_QUERY)
+            for result in results:
+                result["node"] = result["args_node"] = None
+            return results
+
+        return cache.derived(cache.digest(source), "macro_invocations", build)
+
+    def resolve_nodes(self, source: bytes, result: MacroResult) -> Tuple[Optional[Node], Optional[Node]]:
+        """
+        Nodes of an invocation table entry in the current parse of source.
+
+        Returns:
+            (macro node, argument or parameter list node); (None, None) if not found
+        """
+        if result["node"] is not None:
+            return result["node"], result["args_node"]
+
+        root = get_parse_cache().parse(self.language, source).root_node
+        node = resolve_node(root, _Span(_NODE_TYPES[result["type"]], result["start_byte"], result["end_byte"]))
+        if node is None:
+            return None, None
+        if node.type == "call_expression":
+            return node, node.child_by_field_name("arguments")
+        declarator = node.child_by_field_name("declarator")
+        return node, declarator.child_by_field_name("parameters") if declarator else None
+
+    def _by_name(self, source: bytes) -> Dict[str, List[MacroResult]]:
+        """Invocation table grouped by macro name."""
+        cache = get_parse_cache()
+
+        def build():
+            by_name: Dict[str, List[MacroResult]] = {}
+            for result in self.invocations(source):
+                by_name.setdefault(result["macro"], []).append(result)
+            return by_name
+
+        return cache.derived(cache.digest(source), "macro_invocations_by_name", build)
 
     def walk_tree(self, source: bytes, names: List[str]) -> List[MacroResult]:
         """Alternative tree-walking approach for simple searches."""
-        tree = self.parser.parse(source)
+        tree = get_parse_cache().parse(self.language, source).tree
         names_set = set(names)
         results = []
 
@@ -119,34 +180,22 @@ class MacroFinder:
 
     # ==================== Private DRY Methods ====================
 
-    def _build_query(self, predicate_type: PredicateType, value: str) -> str:
-        """Build query string with specified predicate."""
-        predicate = f'({predicate_type.value} @macro_name "{value}")'
-        return self.QUERY_TEMPLATE.format(predicate=predicate)
-
-    @lru_cache(maxsize=32)
-    def _get_query(self, query_text: str) -> Query:
-        """Get or create cached Query object."""
-        return Query(self.language, query_text)
-
-    def _execute_query(
-        self, source: bytes, query_text: str, filter_fn: Optional[Callable[[MacroResult], bool]] = None
-    ) -> List[MacroResult]:
-        """Execute query and process results with optional filtering."""
-        tree = self.parser.parse(source)
+    def _execute_query(self, source: bytes, query_text: str) -> List[MacroResult]:
+        """Execute query and process results."""
+        tree = get_parse_cache().parse(self.language, source).tree
 
         try:
-            query = self._get_query(query_text)
+            query = compile_query(self.language, query_text)
             cursor = QueryCursor(query)
             matches = cursor.matches(tree.root_node)
 
-            return self._process_matches(matches, filter_fn)
+            return self._process_matches(matches)
         except Exception as e:
             logger.error(f"Query failed: {e}")
             return []
 
-    def _process_matches(self, matches, filter_fn: Optional[Callable[[MacroResult], bool]] = None) -> List[MacroResult]:
-        """Process query matches into results with optional filtering."""
+    def _process_matches(self, matches) -> List[MacroResult]:
+        """Process query matches into results."""
         results = []
 
         for pattern_index, captures in matches:
@@ -157,15 +206,10 @@ class MacroFinder:
             if not (macro_nodes and args_nodes):
                 continue
 
-            # Build result
-            result = self._build_result(
-                macro_nodes[0], args_nodes[0], macro_name_nodes[0] if macro_name_nodes else None
+            results.append(
+                self._build_result(macro_nodes[0], args_nodes[0], macro_name_nodes[0] if macro_name_nodes else None)
             )
 
-            # Apply filter if provided
-            if filter_fn is None or filter_fn(result):
-                results.append(result)
-
         return results
 
     def _build_result(self, macro_node: Node, args_node: Node, name_node: Optional[Node] = None) -> MacroResult:
@@ -278,42 +322,20 @@ class MacroFinder:
 
         return None
 
-    def find_markers_in_node(self, node: Node) -> Dict[str, Tuple[int, int]]:
-        """Find comment markers within a node."""
-        markers = {}
-
-        # Query for comments
-        comment_query = Query(self.language, "(comment) @comment")
-        cursor = QueryCursor(comment_query)
-        matches = cursor.matches(node)
-
-        current_marker = None
-        start_line = None
-
-        for _, captures in matches:
-            for comment_node in captures.get("comment", []):
-                text = node_text(comment_node)
-
-                # Check for start marker
-                if "//@@start" in text:
-                    parts = text.split("//@@start")
-                    if len(parts) > 1:
-                        marker_name = parts[1].strip()
-                        current_marker = marker_name
-                        start_line = comment_node.start_point.row + 1
-
-                # Check for end marker
-                elif "//@@end" in text and current_marker:
-                    parts = text.split("//@@end")
-                    if len(parts) > 1:
-                        end_marker = parts[1].strip()
-                        if end_marker == current_marker:
-                            end_line = comment_node.start_point.row + 1
-                            markers[current_marker] = (start_line, end_line)
-                            current_marker = None
-                            start_line = None
-
-        return markers
+    def find_markers_in_node(self, node: Node, source: Optional[bytes] = None) -> Dict[str, Tuple[int, int]]:
+        """
+        Find comment markers within a node.
+
+        Returns:
+            Dict of marker_name -> (start directive line, end directive line)
+        """
+        if source is not None:
+            table = marker_table(source)
+            found = table.in_range(node.start_byte, node.end_byte)
+        else:
+            text = node.text or b""
+            found = scan_markers(text, first_line=node.start_point.row + 1).in_range(0, len(text))
+        return {m.name: (m.open_line, m.close_line) for m in found}
 
     def find_markers_in_macro(
         self, source: bytes, name: str, arg_filters: Optional[Dict[str, str]] = None
@@ -349,8 +371,9 @@ class MacroFinder:
 
         result = results[0]
 
-        # Now find markers within this node
-        markers = self.find_markers_in_node(result["node"])
+        # Now find markers within this macro's byte range
+        found = marker_table(source).in_range(result["start_byte"], result["end_byte"])
+        markers = {m.name: (m.open_line, m.close_line) for m in found}
 
         return {"macro": result, "markers": markers}
 
@@ -377,19 +400,8 @@ class MacroFinder:
 
         start_line, end_line = info["markers"][marker_name]
 
-        # Convert to source-relative lines
-        lines = source.decode("utf8").splitlines()
-
-        # Extract the marked section
-        section_lines = lines[start_line - 1 : end_line]
-
-        # Remove the marker comments themselves
-        if section_lines and "//@@start" in section_lines[0]:
-            section_lines = section_lines[1:]
-        if section_lines and "//@@end" in section_lines[-1]:
-            section_lines = section_lines[:-1]
-
-        return "\n".join(section_lines)
+        # The range covers the directive lines themselves; return what lies between them
+        return get_parse_cache().lines(source, start_line + 1, end_line - 1)
 
     # ==================== Context Manager Support ====================
 
@@ -398,8 +410,7 @@ class MacroFinder:
         return self
 
     def __exit__(self, exc_type, exc_val, exc_tb):
-        """Clear cache on exit."""
-        self._get_query.cache_clear()
+        """Compiled queries are process-wide, so there is nothing to release."""
         return False
 
 
@@ -0,0 +1,171 @@
+"""
+Per-file Protocol Buffers definition tables.
+
+A definition table is built by walking a .proto file's tree once and recording every
+message, enum, service and rpc with its nested name ("Outer.Inner", "Service.Method")
+and byte/line range, so extraction becomes a table lookup plus a slice of the source
+bytes. Definitions are recorded in pre-order, the order the recursive search that
+preceded the table visited them, so plain names still resolve to the first match.
+
+Tables are plain data: they are cached in memory by content hash and shared between
+the worker processes of a render (see core/shared_analysis.py), so a proto-heavy
+render parses each file once.
+"""
+
+import logging
+from dataclasses import dataclass, field
+from typing import Dict, Iterator, List, NamedTuple, Optional, Tuple
+
+from tree_sitter import Node
+
+from ..core.parse_cache import get_parse_cache
+from .grammars import proto_language
+from .utils import node_text
+
+logger = logging.getLogger(__name__)
+
+# Bump when the table layout or the recording rules change
+PROTO_TABLE_VERSION = 1
+
+# Definition node type -> node type of its name
+DEFINITION_NAME_TYPES = {
+    "message": "message_name",
+    "enum": "enum_name",
+    "service": "service_name",
+    "rpc": "rpc_name",
+}
+
+
+class Definition(NamedTuple):
+    """One message, enum, service or rpc."""
+
+    kind: str  # "message", "enum", "service" or "rpc"
+    name: str
+    qualified_name: str  # Enclosing message/service names joined with ".", without the package
+    start_byte: int
+    end_byte: int
+    start_line: int
+    end_line: int
+
+
+@dataclass
+class ProtoSymbolTable:
+    """All definitions of one .proto file, in pre-order."""
+
+    package: str = ""
+    definitions: List[Definition] = field(default_factory=list)
+
+    def __post_init__(self):
+        # (kind, name) and (kind, qualified name) -> first definition, in document order
+        self._by_name: Dict[Tuple[str, str], Definition] = {}
+        self._by_qualified: Dict[Tuple[str, str], Definition] = {}
+        for definition in self.definitions:
+            self._by_name.setdefault((definition.kind, definition.name), definition)
+            self._by_qualified.setdefault((definition.kind, definition.qualified_name), definition)
+
+    def find(self, kind: str, name: str) -> Optional[Definition]:
+        """
+        Definition of a kind by name.
+
+        A plain name matches the first definition so named at any depth. A dotted name
+        ("Outer.Inner") matches a definition's full nested name, optionally prefixed
+        with the package, or else the first one whose nested name ends with it.
+
+        Args:
+            kind: "message", "enum", "service" or "rpc"
+            name: Plain or dotted name
+
+        Returns:
+            The matching Definition or None
+        """
+        if "." not in name:
+            return self._by_name.get((kind, name))
+
+        if self.package and name.startswith(self.package + "."):
+            found = self._by_qualified.get((kind, name[len(self.package) + 1 :]))
+            if found is not None:
+                return found
+        found = self._by_qualified.get((kind, name))
+        if found is not None:
+            return found
+        suffix = "." + name
+        for definition in self.definitions:
+            if definition.kind == kind and definition.qualified_name.endswith(suffix):
+                return definition
+        return None
+
+    def names(self, kind: str) -> List[str]:
+        """Nested names of every definition of a kind, in document order (listed when a lookup fails)."""
+        return [definition.qualified_name for definition in self.definitions if definition.kind == kind]
+
+    # ==================== Serialization ====================
+
+    def to_dict(self) -> Dict:
+        """Plain-data form for sharing between processes."""
+        return {
+            "version": PROTO_TABLE_VERSION,
+            "package": self.package,
+            "definitions": [list(definition) for definition in self.definitions],
+        }
+
+    @classmethod
+    def from_dict(cls, data: Dict) -> Optional["ProtoSymbolTable"]:
+        """Rebuild a table from to_dict() output; None if it was written by another table version."""
+        if data.get("version") != PROTO_TABLE_VERSION:
+            return None
+        return cls(package=data["package"], definitions=[Definition(*row) for row in data["definitions"]])
+
+
+def _definition_name(node: Node) -> Optional[str]:
+    name_type = DEFINITION_NAME_TYPES[node.type]
+    for child in node.children:
+        if child.type == name_type:
+            return node_text(child)
+    return None
+
+
+def _walk(root: Node) -> Iterator[Tuple[Node, str, Tuple[str, ...]]]:
+    """Definition nodes in pre-order, with their name and the names of the definitions enclosing them."""
+    stack = [(root, ())]
+    while stack:
+        node, scope = stack.pop()
+        if node.type in DEFINITION_NAME_TYPES:
+            name = _definition_name(node)
+            if name:
+                yield node, name, scope
+                scope = scope + (name,)
+        stack.extend((child, scope) for child in reversed(node.children))
+
+
+def build_proto_table(source: bytes) -> ProtoSymbolTable:
+    """Walk a parsed .proto file once and record every definition."""
+    root = get_parse_cache().parse(proto_language(), source).root_node
+    package = ""
+    for child in root.children:
+        if child.type == "package":
+            for part in child.children:
+                if part.type == "full_ident":
+                    package = node_text(part)
+            break
+
+    definitions = []
+    for node, name, scope in _walk(root):
+        definitions.append(
+            Definition(
+                kind=node.type,
+                name=name,
+                qualified_name=".".join(scope + (name,)),
+                start_byte=node.start_byte,
+                end_byte=node.end_byte,
+                start_line=node.start_point.row + 1,
+                end_line=node.end_point.row + 1,
+            )
+        )
+    logger.debug(f"Recorded {len(definitions)} proto definition(s)")
+    return ProtoSymbolTable(package=package, definitions=definitions)
+
+
+def get_proto_table(source: bytes) -> ProtoSymbolTable:
+    """Definition table of .proto source bytes, built once per content (parsing only on first use)."""
+    cache = get_parse_cache()
+    return cache.derived(cache.digest(source), "proto_symbols", lambda: build_proto_table(source))
@@ -0,0 +1,31 @@
+"""Fixtures shared by the test modules."""
+
+import subprocess
+from pathlib import Path
+
+import pytest
+
+
+class GitRepo:
+    """A scratch git repository with a committer configured."""
+
+    def __init__(self, path: Path):
+        self.path = path
+        self.run("init", "-q")
+        self.run("config", "user.email", "test@test.com")
+        self.run("config", "user.name", "Test")
+
+    def run(self, *args: str) -> str:
+        """Run a git command in the repository and return its output."""
+        return subprocess.check_output(["git", *args], cwd=self.path).decode()
+
+    def commit(self, message: str, *paths: str) -> None:
+        """Commit the given paths (or every change to tracked and new files)."""
+        self.run("add", *(paths or ("-A",)))
+        self.run("commit", "-q", "-m", message)
+
+
+@pytest.fixture
+def git_repo(tmp_path):
+    """An empty repository in tmp_path; test modules add and commit their own content."""
+    return GitRepo(tmp_path)
@@ -0,0 +1,59 @@
+"""Tests for the benchmark helpers."""
+
+from projected_source.core.benchmark import (
+    compare_baselines,
+    generate_cpp,
+    generate_proto,
+    over_budget,
+    percentile,
+    summarize,
+    synthetic_cases,
+)
+
+
+def _baseline(cold, warm):
+    return {"version": 1, "cases": {"case": {"cold": {"p50_ms": cold}, "warm": {"p50_ms": warm}}}}
+
+
+def test_percentile_nearest_rank():
+    samples = [float(i) for i in range(1, 101)]
+    assert percentile(samples, 50) == 50.0
+    assert percentile(samples, 99) == 99.0
+    assert percentile([3.0], 90) == 3.0
+
+
+def test_summarize_reports_milliseconds():
+    summary = summarize([0.001, 0.002, 0.003])
+    assert summary["p50_ms"] == 2.0
+    assert summary["mean_ms"] == 2.0
+
+
+def test_compare_flags_only_slowdowns_over_threshold():
+    baseline = _baseline(10.0, 1.0)
+
+    assert compare_baselines(baseline, _baseline(11.0, 1.1), threshold=0.2) == []
+    assert compare_baselines(baseline, _baseline(13.0, 1.0), threshold=0.2) == [("case", "cold", 10.0, 13.0)]
+
+
+def test_startup_regressions_and_budget():
+    baseline = {"version": 1, "startup": {"import": {"p50_ms": 100.0}}}
+    current = {"version": 1, "startup": {"import": {"p50_ms": 150.0}, "render": {"error": "boom"}}}
+
+    assert compare_baselines(baseline, current, threshold=0.2) == [("startup/import", "cold", 100.0, 150.0)]
+    assert over_budget({"import": {"p50_ms": 1e6}, "render": {"error": "boom"}})[0][0] == "import"
+    assert over_budget(current["startup"]) == []
+
+
+def test_synthetic_cases_target_generated_symbols(tmp_path):
+    """Every synthetic case names a symbol that exists in the generated file."""
+    cases = synthetic_cases(tmp_path, 120)
+
+    for case in cases:
+        source = (tmp_path / case.file).read_text()
+        leaf = case.target.split("::")[-1]
+        assert leaf in source, case.name
+
+
+def test_generated_sizes_scale():
+    assert generate_cpp(10).count("int compute") == 10
+    assert generate_proto(5).count("message ") >= 5
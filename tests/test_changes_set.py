@@ -192,6 +192,82 @@ class TestChangesSetSubtract:
         assert regions[1].end_line == 35
 
 
+class TestChangesSetIntersection:
+    """Test intersection_update() used to merge parallel renders."""
+
+    def test_intersection_equals_sequential_subtract(self):
+        """Intersecting per-worker copies gives the same result as one set with all claims."""
+        claims = [[(Path("a.cpp"), 12, 14), (Path("b.cpp"), 1, 5)], [(Path("a.cpp"), 18, 30), (Path("a.cpp"), 10, 10)]]
+
+        def fresh():
+            cs = ChangesSet()
+            cs.add(Path("a.cpp"), 10, 25)
+            cs.add(Path("a.cpp"), 40, 50)
+            cs.add(Path("b.cpp"), 1, 5)
+            return cs
+
+        sequential = fresh()
+        workers = []
+        for worker_claims in claims:
+            worker = fresh()
+            for claim in worker_claims:
+                sequential.subtract(*claim)
+                worker.subtract(*claim)
+            workers.append(worker)
+
+        merged = fresh()
+        for worker in workers:
+            merged.intersection_update(worker)
+
+        assert merged.uncovered() == sequential.uncovered()
+        assert [(r.start_line, r.end_line) for r in merged.uncovered()] == [(11, 11), (15, 17), (40, 50)]
+        assert Path("b.cpp") not in merged.files()
+
+
+class TestChangesSetBulkAndCoverage:
+    """Test add_many() and the coverage report."""
+
+    def test_add_many_equals_repeated_add(self):
+        """Bulk insertion merges like one add() per region, in any order."""
+        regions = [(30, 35), (1, 5), (6, 8), (20, 25), (24, 28), (50, 50)]
+        one_by_one, bulk = ChangesSet(), ChangesSet()
+        one_by_one.add(Path("a.cpp"), 40, 45)
+        bulk.add(Path("a.cpp"), 40, 45)
+        for start, end in regions:
+            one_by_one.add(Path("a.cpp"), start, end)
+        bulk.add_many(Path("a.cpp"), regions)
+
+        assert bulk.uncovered() == one_by_one.uncovered()
+        expected = [(1, 8), (20, 28), (30, 35), (40, 45), (50, 50)]
+        assert [(r.start_line, r.end_line) for r in bulk.uncovered()] == expected
+
+    def test_coverage_per_file(self):
+        """Coverage counts changed lines once and only claims of changed lines."""
+        cs = ChangesSet()
+        cs.add(Path("a.cpp"), 10, 19)
+        cs.add(Path("a.cpp"), 15, 24)  # overlapping: 15 changed lines in total
+        cs.add(Path("b.cpp"), 1, 4)
+        cs.subtract(Path("a.cpp"), 1, 12)  # 3 changed lines
+        cs.subtract(Path("a.cpp"), 20, 21)
+        cs.subtract(Path("b.cpp"), 1, 4)
+
+        a, b = cs.coverage()
+        assert (a.file_path, a.changed_lines, a.uncovered_lines, a.covered_lines) == (Path("a.cpp"), 15, 10, 5)
+        assert round(a.percent) == 33
+        assert (b.file_path, b.changed_lines, b.uncovered_lines, b.percent) == (Path("b.cpp"), 4, 0, 100.0)
+
+    def test_is_covered(self):
+        cs = ChangesSet()
+        cs.add(Path("a.cpp"), 10, 20)
+        cs.subtract(Path("a.cpp"), 14, 15)
+
+        assert not cs.is_covered(Path("a.cpp"), 10)
+        assert cs.is_covered(Path("a.cpp"), 14)
+        assert not cs.is_covered(Path("a.cpp"), 20)
+        assert cs.is_covered(Path("a.cpp"), 21)
+        assert cs.is_covered(Path("other.cpp"), 1)
+
+
 class TestChangesSetQueries:
     """Test query methods."""
 
@@ -10,6 +10,7 @@ import pytest
 
 from projected_source.languages.cpp import CppExtractor
 from projected_source.languages.cpp_parser import SimpleCppParser
+from projected_source.languages.macro_finder_v3 import MacroFinder
 
 
 class TestCppParsers:
@@ -199,6 +200,30 @@ class TestCppExtractor:
         assert "int sum = value1 + value2;" in text
         assert "@@start" not in text
         assert "@@end" not in text
+        assert (start, end) == (129, 129)
+
+    def test_macro_lookups_share_one_invocation_table(self, test_file):
+        """Name, pattern and argument lookups filter the same per-file invocation table."""
+        finder = MacroFinder()
+        source = test_file.read_bytes()
+        table = finder.invocations(source)
+
+        assert finder.invocations(source) is table
+        by_name = finder.find_by_name(source, "DEFINE_JS_FUNCTION")
+        assert [r["arguments"][1] for r in by_name] == ["testFunc", "anotherFunc"]
+        assert finder.find_by_pattern(source, "^DEFINE_JS") == by_name
+        assert finder.find_by_argument(source, "DEFINE_JS_FUNCTION", 1, "anotherFunc") == by_name[1:]
+
+    def test_invocation_table_holds_no_nodes(self, test_file):
+        """Cached entries are plain data; nodes come from the current parse on request."""
+        finder = MacroFinder()
+        source = test_file.read_bytes()
+        (result, _) = finder.find_by_name(source, "DEFINE_JS_FUNCTION")
+
+        assert result["node"] is None and result["args_node"] is None
+        node, args_node = finder.resolve_nodes(source, result)
+        assert (node.start_byte, node.end_byte) == (result["start_byte"], result["end_byte"])
+        assert node.type == "function_definition" and args_node.type == "parameter_list"
 
     def test_extract_macro_definition(self, extractor, test_file):
         """Test extracting macro definitions."""
@@ -0,0 +1,47 @@
+"""Tests for deferred code() resolution on a thread pool (render --resolve-workers)."""
+
+from pathlib import Path
+
+from projected_source.core.changes_set import ChangesSet
+from projected_source.core.renderer import TemplateRenderer
+
+REPO = Path.cwd()
+COMPLETE = REPO / "tests" / "fixtures" / "complete.cpp"
+
+TEMPLATE = """# Snippets
+{{ code('tests/fixtures/complete.cpp', function='simpleFunction', github=False) }}
+{% for name in ['SimpleStruct'] %}
+{{ code('tests/fixtures/complete.cpp', struct=name, github=False) }}
+{% endfor %}
+{{ code('tests/fixtures/class_methods.h', function='ShuffleService::addProposal', github=False) }}
+{{ code('tests/fixtures/complete.cpp', macro_definition='MAX_SIZE', github=False) }}
+{{ code('tests/fixtures/complete.cpp', function='noSuchFunction', github=False) }}
+"""
+
+
+def _render(tmp_path: Path, workers: int):
+    changes = ChangesSet()
+    changes.add(COMPLETE, 1, 200)
+    renderer = TemplateRenderer(template_dir=tmp_path, repo_path=REPO, changes_set=changes, resolve_workers=workers)
+    return renderer.render_string(TEMPLATE), changes
+
+
+def test_deferred_matches_immediate(tmp_path):
+    """Output, including in-place errors, and coverage are the same as an immediate render."""
+    immediate, immediate_changes = _render(tmp_path, 1)
+    deferred, deferred_changes = _render(tmp_path, 4)
+
+    assert deferred == immediate
+    assert "\x00" not in deferred
+    assert "ERROR" in deferred
+    assert deferred_changes.uncovered() == immediate_changes.uncovered()
+
+
+def test_template_file_dependencies(tmp_path):
+    """Files read by deferred snippets are still recorded for watch mode."""
+    (tmp_path / "doc.md.j2").write_text(TEMPLATE)
+    renderer = TemplateRenderer(template_dir=tmp_path, repo_path=REPO, resolve_workers=4)
+
+    renderer.render_template("doc.md.j2")
+
+    assert COMPLETE.resolve() in renderer.dependencies["doc.md.j2"]
@@ -0,0 +1,62 @@
+"""Tests for the batch extract command."""
+
+import io
+import json
+from pathlib import Path
+
+from projected_source.cli.extract import iter_requests, run_request
+from projected_source.core.renderer import TemplateRenderer
+
+REPO = Path.cwd()
+
+
+def _renderer():
+    return TemplateRenderer(template_dir=REPO, repo_path=REPO)
+
+
+class TestIterRequests:
+    """Test batch parsing."""
+
+    def test_jsonl(self):
+        lines = io.StringIO('{"id": 1}\n\n{"id": 2}\n')
+        assert [request["id"] for request, _ in iter_requests(lines)] == [1, 2]
+
+    def test_json_array(self):
+        lines = io.StringIO('[\n  {"id": 1},\n  {"id": 2}\n]\n')
+        assert [request["id"] for request, _ in iter_requests(lines)] == [1, 2]
+
+    def test_bad_entries_do_not_stop_the_batch(self):
+        results = list(iter_requests(io.StringIO('{"id": 1\n42\n{"id": 3}\n')))
+
+        assert results[0][0] is None and "Invalid JSON" in results[0][1]
+        assert results[1] == (None, "Request must be a JSON object, got int")
+        assert results[2] == ({"id": 3}, None)
+
+
+class TestRunRequest:
+    """Test extracting single requests."""
+
+    def test_lines(self):
+        result = run_request(_renderer(), {"id": "a", "file": "tests/fixtures/complete.cpp", "lines": [1, 3]})
+
+        assert list(result)[0] == "id"
+        assert result["file"] == "tests/fixtures/complete.cpp"
+        assert (result["start_line"], result["end_line"]) == (1, 3)
+        assert result["code"] == "\n".join(Path("tests/fixtures/complete.cpp").read_text().splitlines()[:3])
+        assert result["language"] == "cpp"
+
+    def test_function(self):
+        result = run_request(_renderer(), {"file": "tests/fixtures/complete.cpp", "function": "simpleFunction"})
+
+        assert "id" not in result
+        assert "simpleFunction" in result["code"]
+        assert result["start_line"] <= result["end_line"]
+
+    def test_errors_are_reported_per_request(self):
+        renderer = _renderer()
+        missing = run_request(renderer, {"id": 1, "file": "tests/fixtures/missing.cpp", "function": "f"})
+        unknown = run_request(renderer, {"id": 2, "file": "tests/fixtures/complete.cpp", "functoin": "f"})
+
+        assert set(missing) == {"id", "error"}
+        assert "functoin" in unknown["error"]
+        json.dumps([missing, unknown])
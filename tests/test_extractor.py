@@ -5,6 +5,8 @@ Tests for the extractor module.
 import tempfile
 from pathlib import Path
 
+from projected_source.core.markers import marker_table
+from projected_source.languages import get_extractor
 from projected_source.languages.cpp import CppExtractor
 
 
@@ -120,8 +122,39 @@ line 5
         temp_path.unlink()
 
 
+def test_get_extractor_reuses_instances():
+    """Files of the same type share one long-lived extractor."""
+    first = get_extractor(Path("a.cpp"))
+
+    assert isinstance(first, CppExtractor)
+    assert get_extractor(Path("b.h")) is first
+    assert get_extractor(Path("c.CPP")) is first
+
+
+def test_markers_in_node_match_file_table():
+    """Node-scoped marker lookups through the per-file marker table match scanning the node."""
+    extractor = CppExtractor()
+    parsed = extractor.parse_source(Path("tests/fixtures/complete.cpp"))
+
+    functions = [node for node in parsed.root_node.children if node.type == "function_definition"]
+    functions += [
+        node
+        for ns in parsed.root_node.children
+        if ns.type == "namespace_definition"
+        for node in ns.child_by_field_name("body").children
+        if node.type == "function_definition"
+    ]
+    assert any(extractor.find_markers_in_node(node) for node in functions)
+
+    for node in functions:
+        assert extractor.find_markers_in_node(node, parsed) == extractor.find_markers_in_node(node)
+    assert marker_table(parsed.data) is marker_table(parsed.data)
+
+
 if __name__ == "__main__":
     test_find_markers()
     test_extract_function()
     test_extract_lines()
+    test_get_extractor_reuses_instances()
+    test_markers_in_node_match_file_table()
     print("✓ All tests passed!")
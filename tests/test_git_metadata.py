@@ -0,0 +1,148 @@
+"""Tests for per-render git metadata collection."""
+
+import shutil
+from pathlib import Path
+
+import pytest
+
+from projected_source.core.git_metadata import (
+    GitMetadata,
+    parse_blame_incremental,
+    parse_blame_porcelain,
+    parse_status_paths,
+    split_diff_by_path,
+)
+from projected_source.core.github import GitHubIntegration
+from projected_source.core.render_cache import RenderCache, set_render_cache
+
+FIXTURES_DIR = Path(__file__).parent / "fixtures"
+
+
+
+@pytest.fixture
+def repo(git_repo):
+    """A repository with two committed files."""
+    shutil.copy(FIXTURES_DIR / "line_mapping_base.cpp", git_repo.path / "a.cpp")
+    shutil.copy(FIXTURES_DIR / "line_mapping_base.cpp", git_repo.path / "b.cpp")
+    git_repo.commit("Initial commit", "a.cpp", "b.cpp")
+    return git_repo.path
+
+
+class TestParsing:
+    """Test parsing of git output."""
+
+    def test_status_paths(self):
+        """Untracked files are skipped and renames keep the new path."""
+        output = " M src/a.cpp\0M  b.cpp\0R  new.cpp\0old.cpp\0?? scratch.cpp\0"
+        assert parse_status_paths(output) == {"src/a.cpp", "b.cpp", "new.cpp"}
+
+    def test_split_diff_by_path(self):
+        """A multi-file diff is split into one section per file."""
+        diff = (
+            "diff --git a/a.cpp b/a.cpp\n--- a/a.cpp\n+++ b/a.cpp\n@@ -1 +1,2 @@\n+x\n y\n"
+            "diff --git a/gone.cpp b/gone.cpp\n--- a/gone.cpp\n+++ /dev/null\n@@ -1 +0,0 @@\n-y\n"
+        )
+        sections = split_diff_by_path(diff)
+
+        assert set(sections) == {"a.cpp", "gone.cpp"}
+        assert sections["a.cpp"].startswith("diff --git a/a.cpp")
+        assert "+x" in sections["a.cpp"] and "-y" not in sections["a.cpp"]
+
+    def test_blame_reuses_commit_metadata(self):
+        """Porcelain only lists metadata once per commit; later lines still get it."""
+        sha = "a" * 40
+        output = (
+            f"{sha} 1 1 2\nauthor Someone\nauthor-time 0\nfilename x.cpp\n\tline one\n"
+            f"{sha} 2 2\n\tline two\n"
+        )
+        blame = parse_blame_porcelain(output)
+
+        assert set(blame) == {1, 2}
+        assert blame[2]["author"] == "Someone"
+        assert blame[2]["commit"] == sha[:8]
+
+    def test_blame_sha256_hashes(self):
+        """Records of SHA-256 repositories are recognised by shape, not hash length."""
+        sha = "b" * 64
+        porcelain = f"{sha} 1 1 1\nauthor Someone\nauthor-time 0\nfilename x.cpp\n\tline one\n"
+        incremental = f"{sha} 1 1 2\nauthor Someone\nauthor-time 0\nfilename x.cpp\n"
+
+        assert parse_blame_porcelain(porcelain)[1]["commit"] == sha[:8]
+        table = parse_blame_incremental(incremental)
+        assert table.slice(1, 2)[2]["author"] == "Someone"
+
+
+class TestGitMetadata:
+    """Test that git runs once per render, not once per snippet."""
+
+    def test_status_and_diff_run_once(self, repo, git_repo):
+        """Many dirty checks and line mappings over several files cost a fixed number of git calls."""
+        (repo / "a.cpp").write_text("// new line\n" + (repo / "a.cpp").read_text())
+        metadata = GitMetadata(repo)
+
+        for _ in range(20):
+            assert metadata.is_dirty(repo / "a.cpp")
+            assert not metadata.is_dirty(repo / "b.cpp")
+            metadata.line_mapping(repo / "a.cpp")
+            metadata.line_mapping(repo / "b.cpp")
+        calls = metadata.git_calls
+
+        assert calls <= 3  # rev-parse, status, diff
+        assert metadata.diff(repo / "a.cpp") == git_repo.run("diff", "HEAD", "--", "a.cpp")
+        assert metadata.git_calls == calls
+
+    def test_clean_tree_skips_diff(self, repo):
+        """Without dirty files no diff is run."""
+        metadata = GitMetadata(repo)
+
+        assert metadata.diff(repo / "a.cpp") == ""
+        assert metadata.git_calls <= 2
+
+    def test_blame_sliced_from_one_run(self, repo, git_repo):
+        """Blame for several ranges matches `git blame -L` and runs git once per file."""
+        github = GitHubIntegration(repo)
+        expected = parse_blame_porcelain(git_repo.run("blame", "-L", "3,6", "--porcelain", "a.cpp"))
+
+        assert github.get_blame(repo / "a.cpp", 3, 6) == expected
+        calls = github.metadata.git_calls
+        github.get_blame(repo / "a.cpp", 1, 2)
+        github.get_blame(repo / "a.cpp", 10, 12)
+        assert github.metadata.git_calls == calls
+
+    def test_incremental_blame_matches_porcelain(self, repo, git_repo):
+        (repo / "a.cpp").write_text("// header\n" + (repo / "a.cpp").read_text())
+        git_repo.commit("Second commit", "a.cpp")
+
+        table = parse_blame_incremental(git_repo.run("blame", "--incremental", "a.cpp"))
+        expected = parse_blame_porcelain(git_repo.run("blame", "--porcelain", "a.cpp"))
+
+        assert len(table.commits) == 2
+        assert table.slice(1, len(table.lines)) == expected
+
+    def test_blame_cache_shared_between_renders(self, repo, tmp_path):
+        """A stored blame table spares later renders the blame; dirty files are never stored."""
+        set_render_cache(RenderCache(tmp_path / "cache"))
+        try:
+            expected = GitMetadata(repo).blame(repo / "a.cpp", 1, 20)
+            (repo / "b.cpp").write_text("// dirty\n" + (repo / "b.cpp").read_text())
+            GitMetadata(repo).blame(repo / "b.cpp", 1, 2)
+
+            metadata = GitMetadata(repo)
+            assert metadata.blame(repo / "a.cpp", 1, 20) == expected
+            calls = metadata.git_calls
+            assert metadata.blame(repo / "b.cpp", 1, 1)[1]["commit"] == "00000000"
+            assert metadata.git_calls == calls + 1
+        finally:
+            set_render_cache(None)
+
+        assert len(list((tmp_path / "cache" / "blame").rglob("*.json"))) == 1
+
+    def test_clear_sees_new_changes(self, repo):
+        """clear() drops the status snapshot."""
+        metadata = GitMetadata(repo)
+        assert not metadata.is_dirty(repo / "b.cpp")
+
+        (repo / "b.cpp").write_text("changed\n")
+        assert not metadata.is_dirty(repo / "b.cpp")
+        metadata.clear()
+        assert metadata.is_dirty(repo / "b.cpp")
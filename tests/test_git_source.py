@@ -0,0 +1,71 @@
+"""Tests for reading sources at a commit without a worktree."""
+
+from pathlib import Path
+
+import pytest
+
+from projected_source.core.git_source import GitTreeSource
+from projected_source.core.parse_cache import blob_hash, get_parse_cache
+from projected_source.languages.cpp import CppExtractor
+
+OLD = "int answer() {\n    return 41;\n}\n"
+NEW = "int answer() {\n    return 42;\n}\n"
+
+
+
+@pytest.fixture
+def repo(git_repo):
+    """A repository where src/answer.cpp changed between two commits."""
+    (git_repo.path / "src").mkdir()
+    (git_repo.path / "src" / "answer.cpp").write_text(OLD)
+    git_repo.commit("v1", "src/answer.cpp")
+    git_repo.run("tag", "v1")
+    (git_repo.path / "src" / "answer.cpp").write_text(NEW)
+    git_repo.commit("v2", "src/answer.cpp")
+    return git_repo.path
+
+
+class TestGitTreeSource:
+    """Test the cat-file backed source."""
+
+    def test_reads_committed_content(self, repo):
+        """Files are read at the commit, not from the working tree."""
+        with GitTreeSource(repo, "v1") as source:
+            data, digest = source.read(repo / "src" / "answer.cpp")
+
+        assert data == OLD.encode()
+        assert digest == blob_hash(data)
+
+    def test_same_bytes_per_path(self, repo):
+        """Repeated reads return the cached object without asking git again."""
+        with GitTreeSource(repo, "v1") as source:
+            first, _ = source.read(repo / "src" / "answer.cpp")
+            second, _ = source.read(Path("src/answer.cpp"))
+
+            assert first is second
+            assert source.blobs_read == 1
+
+    def test_missing_file(self, repo):
+        """Paths absent at the commit raise FileNotFoundError."""
+        with GitTreeSource(repo, "v1") as source:
+            assert not source.exists(repo / "src" / "nope.cpp")
+            with pytest.raises(FileNotFoundError):
+                source.read(repo / "src" / "nope.cpp")
+
+    def test_unknown_commit(self, repo):
+        """An unresolvable commit is reported up front."""
+        with pytest.raises(RuntimeError):
+            GitTreeSource(repo, "no-such-tag")
+
+    def test_extract_at_commit(self, repo):
+        """Extractors read through the parse cache's source."""
+        cache = get_parse_cache()
+        with GitTreeSource(repo, "v1") as source:
+            cache.set_source(source)
+            try:
+                code, _, _ = CppExtractor().extract_function(repo / "src" / "answer.cpp", "answer")
+            finally:
+                cache.set_source(None)
+
+        assert "return 41;" in code
+        assert "return 42;" in CppExtractor().extract_function(repo / "src" / "answer.cpp", "answer")[0]
@@ -14,7 +14,10 @@ import pytest
 
 from projected_source.core.github import (
     GitHubIntegration,
+    LineMap,
+    build_line_mapping,
     map_line_to_committed,
+    map_line_with_mapping,
     parse_diff_hunks,
 )
 
@@ -152,6 +155,53 @@ class TestMapLineToCommitted:
         assert map_line_to_committed(20, hunks) == 16  # 20 - 4 = 16
 
 
+class TestLineMap:
+    """Test the run-based line map built once per diff."""
+
+    DIFF = """diff --git a/test.cpp b/test.cpp
+--- a/test.cpp
++++ b/test.cpp
+@@ -3,4 +3,6 @@ void funcOne
+ context 3
+ context 4
++//@@start func-one
++//@@end func-one
+ context 5
+ context 6
+@@ -20,5 +22,4 @@ void funcTwo
+ context 20
+-removed 21
+-removed 22
++replaced
+ context 23
+ context 24"""
+
+    def test_matches_per_line_mapping(self):
+        """Every line maps as with build_line_mapping() + map_line_with_mapping()."""
+        line_map = LineMap.from_diff(self.DIFF)
+        mapping, hunks = build_line_mapping(self.DIFF), parse_diff_hunks(self.DIFF)
+
+        assert line_map.hunks == hunks
+        for line in range(1, 40):
+            assert line_map.to_committed(line) == map_line_with_mapping(line, mapping, hunks), line
+
+    def test_runs(self):
+        line_map = LineMap.from_diff(self.DIFF)
+
+        assert line_map.to_committed(2) == 2  # before any hunk
+        assert line_map.to_committed(5) == 4  # added marker: previous unchanged line
+        assert line_map.to_committed(7) == 5  # shifted by the markers
+        assert line_map.to_committed(15) == 13  # between hunks
+        assert line_map.to_committed(23) == 20  # replacement: previous unchanged line
+        assert line_map.to_committed(30) == 29  # after both hunks: +2 then -1
+
+    def test_empty_diff(self):
+        line_map = LineMap.from_diff("")
+
+        assert line_map.hunks == []
+        assert line_map.to_committed(42) == 42
+
+
 class TestGitHubIntegrationDirtyFile:
     """Integration tests with actual git repo."""
 
@@ -0,0 +1,91 @@
+"""Tests for finding and removing markers across a changeset."""
+
+import pytest
+
+from projected_source.core.marker_cleanup import (
+    find_changed_markers,
+    parse_added_hunks,
+    remove_directive_lines,
+    scan_hunks,
+)
+from projected_source.core.markers import iter_directives
+
+BASE = "int a() {\n    return 1;\n}\n"
+CHANGED = "int a() {\n    //@@start body\n    return 1;\n    //@@end body\n}\nint b(); //@@start inline\n"
+
+DIFF = b"""diff --git a/x.cpp b/x.cpp
+index 1..2 100644
+--- a/x.cpp
++++ b/x.cpp
+@@ -1,0 +2 @@ int a() {
++    //@@start body
+@@ -2,0 +4 @@ int a() {
++    //@@end body
+diff --git a/y.cpp b/y.cpp
+--- a/y.cpp
++++ b/y.cpp
+@@ -3 +3 @@
+-int y;
++int y = 1;
+diff --git a/gone.cpp b/gone.cpp
+--- a/gone.cpp
++++ /dev/null
+@@ -1 +0,0 @@
+-//@@start old
+"""
+
+
+
+@pytest.fixture
+def repo(git_repo):
+    (git_repo.path / "a.cpp").write_text(BASE)
+    (git_repo.path / "notes.txt").write_text("//@@start ignored\n")
+    git_repo.commit("base", "a.cpp", "notes.txt")
+    return git_repo.path
+
+
+def test_standalone_directives():
+    directives = list(iter_directives(CHANGED.encode()))
+
+    assert [(d.kind, d.name, d.line, d.standalone) for d in directives] == [
+        ("start", "body", 2, True),
+        ("end", "body", 4, True),
+        ("start", "inline", 6, False),
+    ]
+
+
+def test_parse_added_hunks_skips_files_without_markers():
+    hunks = parse_added_hunks(DIFF)
+
+    assert list(hunks) == ["x.cpp"]
+    assert [(d.kind, d.line) for d in scan_hunks(hunks["x.cpp"])] == [("start", 2), ("end", 4)]
+
+
+def test_hunk_and_whole_file_scans_agree(repo, git_repo):
+    (repo / "a.cpp").write_text(CHANGED)
+    git_repo.commit("markers", "a.cpp")
+
+    from_hunks = find_changed_markers(repo, "HEAD~1")
+    from_files = find_changed_markers(repo, "HEAD~1..HEAD", jobs=2)
+
+    assert list(from_hunks) == list(from_files) == [repo / "a.cpp"]
+    assert [d.line for d in from_hunks[repo / "a.cpp"]] == [d.line for d in from_files[repo / "a.cpp"]] == [2, 4]
+
+
+def test_hunks_include_uncommitted_edits(repo):
+    (repo / "a.cpp").write_text(CHANGED)
+
+    assert [d.name for d in find_changed_markers(repo, "HEAD")[repo / "a.cpp"]] == ["body", "body"]
+    assert find_changed_markers(repo, "HEAD", whole_files=True) == {}
+
+
+def test_remove_keeps_line_endings_and_moved_lines(tmp_path):
+    path = tmp_path / "a.cpp"
+    path.write_bytes(CHANGED.replace("\n", "\r\n").encode())
+    directives = list(iter_directives(path.read_bytes()))
+    # A line that changed since the scan is left alone
+    stale = directives[0]._replace(line=3)
+
+    assert remove_directive_lines(path, [stale, directives[1]]) == 1
+    expected = "int a() {\n    //@@start body\n    return 1;\n}\nint b(); //@@start inline\n"
+    assert path.read_bytes() == expected.replace("\n", "\r\n").encode()
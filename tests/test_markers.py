@@ -0,0 +1,77 @@
+"""Tests for the per-file marker table."""
+
+from projected_source.core.markers import marker_table, scan_markers
+
+SOURCE = b"""int a() {
+    //@@start setup
+    int x = 1;
+    //@@end setup
+    return x;
+}
+
+int b() {
+    //@@start setup
+    int y = 2;
+    //@@start inner
+    y++;
+    //@@end inner
+    //@@end setup
+    return y;
+}
+"""
+
+
+def test_scan_pairs_markers_with_content_lines():
+    table = scan_markers(SOURCE)
+
+    assert len(table) == 3
+    first = table.markers[0]
+    assert (first.name, first.open_line, first.close_line) == ("setup", 2, 4)
+    assert first.lines == (3, 3)
+
+
+def test_range_lookup_by_containment():
+    """Markers of the same name in different functions are told apart by byte range."""
+    second_function = SOURCE.index(b"int b()")
+
+    assert scan_markers(SOURCE).lines_in_range(0, second_function) == {"setup": (3, 3)}
+    assert scan_markers(SOURCE).lines_in_range(second_function, len(SOURCE)) == {
+        "setup": (10, 13),
+        "inner": (12, 12),
+    }
+
+
+def test_unmatched_directives_are_ignored():
+    table = scan_markers(b"//@@end orphan\n//@@start open\nx\n// @@start nope\n")
+    assert len(table) == 0
+
+
+def test_first_line_offsets_slices():
+    table = scan_markers(b"//@@start s\nbody\n//@@end s\n", first_line=40)
+    assert table.lines_in_range(0, 100) == {"s": (41, 41)}
+
+
+def test_table_is_built_once_per_content():
+    data = bytes(SOURCE)
+    assert marker_table(data) is marker_table(data)
+
+
+def test_directives_in_string_literals_are_not_markers():
+    source = (
+        b'const char* help = "//@@start fake";\n'
+        b"char quote = '\"'; //@@start real\n"
+        b'puts("a \\" b"); //@@end real\n'
+        b'puts("//@@end fake");\n'
+    )
+    table = scan_markers(source)
+
+    assert [(m.name, m.open_line, m.close_line) for m in table.markers] == [("real", 2, 3)]
+
+
+def test_directive_name_on_the_same_line():
+    """A // comment ends at the newline, so a name on the next line does not belong to it."""
+    source = b"//@@start\nname\n//@@start\ttabbed\n//@@end tabbed\n/* //@@start block */\n/* //@@end block */\n"
+
+    table = scan_markers(source)
+
+    assert {m.name: (m.open_line, m.close_line) for m in table.markers} == {"tabbed": (3, 4), "block": (5, 6)}
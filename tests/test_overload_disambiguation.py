@@ -108,6 +108,20 @@ class TestOverloadDisambiguation:
         assert result is not None
         assert "handleIntPair" in result.text
 
+    def test_extract_by_exact_parameter_types(self, parser, fixture_file):
+        """Exact parameter types select by the overload index, ignoring names and spacing."""
+        source = fixture_file.read_bytes()
+        overloads = parser.symbol_table(source).overload_set("PeerImp::process")
+
+        assert sorted(overloads.by_types) == ["const std::string&", "int", "int, int"]
+        # "int" is part of every parameter list, but only one overload takes exactly an int
+        result = parser.extract_function_by_name(source, "PeerImp::process", signature="int")
+        assert "handleInt(value)" in result.text
+        result = parser.extract_function_by_name(source, "PeerImp::process", signature="int ,int")
+        assert "handleIntPair" in result.text
+        result = parser.extract_function_by_name(source, "handleEvent", signature="int, const std::string &")
+        assert "Handle with code and message" in result.text
+
     def test_no_match_returns_none(self, parser, fixture_file):
         """Test that non-matching signature returns None."""
         source = fixture_file.read_bytes()
@@ -151,6 +165,7 @@ class TestOverloadDisambiguation:
             extractor.extract_function(fixture_file, "PeerImp::onMessage", signature="NonExistent")
 
         assert "NonExistent" in str(exc_info.value)
+        assert "Available overloads: (std::shared_ptr<protocol::TMProposeSet> const& m)" in str(exc_info.value)
 
     # === Parameter signature extraction tests ===
 
@@ -0,0 +1,45 @@
+"""Tests for rendering template directories across worker processes."""
+
+from pathlib import Path
+
+from projected_source.cli.render import _render_directory
+from projected_source.core.changes_set import ChangesSet
+
+REPO = Path.cwd()
+FIXTURE = REPO / "tests" / "fixtures" / "complete.cpp"
+
+TEMPLATES = {
+    "a.md.j2": "{{ code('%s', function='simpleFunction', github=False) }}\n",
+    "b.md.j2": "{{ code('%s', struct='SimpleStruct', github=False) }}\n",
+    "nested/c.md.j2": "{{ code('%s', macro_definition='MAX_SIZE', github=False) }}\n",
+}
+
+
+def _write_templates(directory: Path):
+    for name, text in TEMPLATES.items():
+        path = directory / name
+        path.parent.mkdir(parents=True, exist_ok=True)
+        path.write_text(text % "tests/fixtures/complete.cpp")
+
+
+def _changes() -> ChangesSet:
+    cs = ChangesSet()
+    cs.add(FIXTURE, 1, 200)
+    return cs
+
+
+def test_parallel_matches_serial(tmp_path):
+    """Output files and remaining coverage are the same with --jobs 2."""
+    serial_dir, parallel_dir = tmp_path / "serial", tmp_path / "parallel"
+    _write_templates(serial_dir)
+    _write_templates(parallel_dir)
+
+    serial_changes, parallel_changes = _changes(), _changes()
+    _render_directory(serial_dir, serial_dir, REPO, changes_set=serial_changes, jobs=1)
+    _render_directory(parallel_dir, parallel_dir, REPO, changes_set=parallel_changes, jobs=2)
+
+    for name in TEMPLATES:
+        output = Path(name).with_suffix("")
+        assert (parallel_dir / output).read_text() == (serial_dir / output).read_text()
+    assert parallel_changes.uncovered() == serial_changes.uncovered()
+    assert len(parallel_changes) > 1
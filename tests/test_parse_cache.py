@@ -0,0 +1,217 @@
+"""Tests for the shared parse cache."""
+
+import os
+import sys
+from pathlib import Path
+
+from tree_sitter import Parser
+
+from projected_source.core.parse_cache import (
+    LARGE_FILE_BYTES,
+    ParseCache,
+    blob_hash,
+    build_line_offsets,
+    compute_edit,
+    get_parse_cache,
+    slice_lines,
+)
+from projected_source.languages.cpp import CppExtractor
+from projected_source.languages.cpp_symbols import build_symbol_table
+from projected_source.languages.grammars import cpp_language
+
+
+class TestHelpers:
+    """Test content hashing and line offset tables."""
+
+    def test_blob_hash_matches_git(self):
+        """Digest is the same as `git hash-object`."""
+        assert blob_hash(b"") == "e69de29bb2d1d6434b8b29ae775ad8c2e48c5391"
+        assert blob_hash(b"hello\n") == "ce013625030ba8dba906f756967f9e9ca394464a"
+
+    def test_line_offsets(self):
+        """Each entry is the byte offset of a line start."""
+        assert build_line_offsets(b"") == [0]
+        assert build_line_offsets(b"ab\ncd\n") == [0, 3, 6]
+        assert build_line_offsets(b"ab\ncd") == [0, 3]
+
+    def test_slice_lines_matches_splitlines(self):
+        """Slicing through the offset table gives the same text as splitting the whole file."""
+        for data in (b"a\nbb\n\nccc\n", b"a\nbb\n\nccc", b"x\r\ny\r\nz\r\n", b""):
+            lines = data.decode().splitlines()
+            offsets = build_line_offsets(data)
+            for start in range(0, len(lines) + 2):
+                for end in range(start, len(lines) + 2):
+                    expected = "\n".join(lines[max(0, start - 1) : end])
+                    assert slice_lines(data, offsets, start, end) == expected, (data, start, end)
+
+    def test_compute_edit(self):
+        """The edit spans only the bytes that differ."""
+        old, new = b"int a;\nint b;\n", b"int a;\nlong b;\n"
+        edit = compute_edit(old, new, build_line_offsets(old), build_line_offsets(new))
+
+        assert (edit["start_byte"], edit["old_end_byte"], edit["new_end_byte"]) == (7, 10, 11)
+        assert (edit["start_point"], edit["old_end_point"], edit["new_end_point"]) == ((1, 0), (1, 3), (1, 4))
+
+
+class TestParseCache:
+    """Test caching of file contents and trees."""
+
+    def test_same_content_parsed_once(self):
+        """Equal bytes share one parse."""
+        cache = ParseCache()
+        first = cache.parse(cpp_language(), b"int main() { return 0; }")
+        second = cache.parse(cpp_language(), b"int main() { return 0; }")
+
+        assert first is second
+        assert cache.misses == 1
+        assert cache.hits == 1
+
+    def test_file_read_once_until_modified(self, tmp_path):
+        """Unchanged files return the same bytes; modified files are re-read."""
+        cache = ParseCache()
+        source = tmp_path / "test.cpp"
+        source.write_text("int a;\n")
+
+        data = cache.read(source)
+        assert cache.read(source) is data
+
+        source.write_text("int a;\nint b;\n")
+        stat = source.stat()
+        os.utime(source, ns=(stat.st_atime_ns, stat.st_mtime_ns + 1_000_000))
+
+        assert cache.read(source) == b"int a;\nint b;\n"
+        assert cache.parse_file(cpp_language(), source).line_count == 2
+
+    def test_changed_file_reparsed_incrementally(self, tmp_path):
+        """A modified file is re-parsed from its old tree and matches a fresh parse."""
+        cache = ParseCache()
+        source = tmp_path / "test.cpp"
+        source.write_text("int a() { return 1; }\nint b() { return 2; }\n")
+        cache.parse_file(cpp_language(), source)
+
+        new_text = "int a() { return 1; }\nint b() { return 2 + 3; }\n"
+        source.write_text(new_text)
+        stat = source.stat()
+        os.utime(source, ns=(stat.st_atime_ns, stat.st_mtime_ns + 1_000_000))
+        entry = cache.parse_file(cpp_language(), source)
+
+        assert cache.incremental == 1
+        assert str(entry.root_node) == str(Parser(cpp_language()).parse(new_text.encode()).root_node)
+
+    def test_changed_file_drops_old_derived_tables(self, tmp_path):
+        """Tables of a file's old content are forgotten once the file changes (e.g. under --watch)."""
+        cache = ParseCache()
+        source = tmp_path / "test.cpp"
+        source.write_text("int a;\n")
+        old_digest = cache.digest(cache.read(source))
+        cache.line_offsets(cache.read(source))
+
+        source.write_text("int a;\nint b;\n")
+        stat = source.stat()
+        os.utime(source, ns=(stat.st_atime_ns, stat.st_mtime_ns + 1_000_000))
+        cache.line_offsets(cache.read(source))
+
+        assert all(digest != old_digest for digest, _ in cache._derived)
+        assert old_digest not in cache._derived_keys
+
+    def test_extractors_share_process_cache(self):
+        """Repeated extractions from one file reuse the cached tree."""
+        fixture = Path("tests/fixtures/complete.cpp")
+        cache = get_parse_cache()
+        cache.clear()
+
+        extractor = CppExtractor()
+        extractor.extract_function(fixture, "simpleFunction")
+        extractor.extract_struct(fixture, "SimpleStruct")
+        extractor.extract_macro_definition(fixture, "MAX_SIZE")
+        extractor.extract_function_macro(fixture, {"name": "DEFINE_JS_FUNCTION", "arg1": "testFunc"})
+
+        assert cache.misses == 1
+
+
+class TestMemoryBudget:
+    """Test LRU eviction under a memory budget."""
+
+    def _files(self, tmp_path, count, size=1000):
+        paths = []
+        for i in range(count):
+            path = tmp_path / f"f{i}.cpp"
+            path.write_bytes(bytes([ord("a") + i]) * size)
+            paths.append(path)
+        return paths
+
+    def test_least_recently_used_evicted(self, tmp_path):
+        cache = ParseCache()
+        cache.set_memory_budget(2500)
+        first, second, third = self._files(tmp_path, 3)
+
+        data = cache.read(first)
+        cache.derived(cache.digest(data), "table", lambda: "first table")
+        cache.read(second)
+        cache.read(first)  # first is now the most recent
+        cache.read(third)
+
+        assert cache.evictions == 1
+        assert cache.memory_used <= 2500
+        assert set(cache.cached_paths()) == {first.resolve(), third.resolve()}
+        assert cache.derived(cache.digest(data), "table", lambda: "rebuilt") == "first table"
+
+    def test_evicted_content_drops_derived_tables(self, tmp_path):
+        cache = ParseCache()
+        cache.set_memory_budget(1500)
+        first, second = self._files(tmp_path, 2)
+
+        digest = cache.digest(cache.read(first))
+        cache.derived(digest, "table", lambda: "old")
+        cache.read(second)
+
+        assert first.resolve() not in cache.cached_paths()
+        assert cache.derived(digest, "table", lambda: "rebuilt") == "rebuilt"
+        assert cache.memory_peak > cache.memory_used
+
+    def test_removing_budget_resets_accounting(self, tmp_path):
+        cache = ParseCache()
+        cache.set_memory_budget(5000)
+        (first,) = self._files(tmp_path, 1)
+        cache.derived(cache.digest(cache.read(first)), "table", lambda: "table")
+
+        cache.set_memory_budget(None)
+        assert (cache.memory_used, cache.memory_peak) == (0, 0)
+        assert not (cache._costs or cache._sizes or cache._derived_keys)
+        assert cache.derived(cache.digest(cache.read(first)), "table", lambda: "rebuilt") == "table"
+
+    def test_unbounded_by_default(self, tmp_path):
+        cache = ParseCache()
+        for path in self._files(tmp_path, 5):
+            cache.read(path)
+
+        assert cache.evictions == 0
+        assert len(cache.cached_paths()) == 5
+
+    def test_large_file_tree_released(self):
+        cache = ParseCache()
+        cache.large_file_bytes = 100
+        data = b"int f() { return 1; }\n" * 10
+        cache.parse(cpp_language(), data)
+
+        assert cache.release_large(data)
+        assert not cache.release_large(b"int g();\n")
+        cache.parse(cpp_language(), data)
+        assert cache.misses == 2
+
+    def test_released_tree_is_not_pinned_by_tables(self):
+        """Tables derived from a large file (macro invocations included) do not keep its tree alive."""
+        cache = get_parse_cache()
+        cache.clear()
+        cache.large_file_bytes = 100
+        try:
+            data = b"int f() { return LOG(1, 2); }\nDEFINE_FN(a, b) { return 0; }\n" * 5
+            build_symbol_table(data)
+            tree = cache.parse(cpp_language(), data).tree
+
+            assert cache.release_large(data)
+            # Only this frame's reference and getrefcount's argument remain
+            assert sys.getrefcount(tree) == 2
+        finally:
+            cache.large_file_bytes = LARGE_FILE_BYTES
+            cache.clear()
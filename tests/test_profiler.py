@@ -0,0 +1,104 @@
+"""Tests for render profiling (render --profile)."""
+
+import json
+import time
+from pathlib import Path
+
+import pytest
+
+from projected_source.core import profiler
+from projected_source.core.profiler import Profiler, set_profiler
+from projected_source.core.renderer import TemplateRenderer
+
+REPO = Path.cwd()
+
+TEMPLATE = """{{ code('tests/fixtures/complete.cpp', function='simpleFunction', github=False) }}
+{{ code('tests/fixtures/complete.cpp', struct='SimpleStruct', github=False) }}
+"""
+
+
+@pytest.fixture
+def active():
+    active_profiler = Profiler()
+    set_profiler(active_profiler)
+    yield active_profiler
+    set_profiler(None)
+
+
+class TestProfiler:
+    """Test event collection and aggregation."""
+
+    def test_disabled_is_a_no_op(self):
+        with profiler.stage("parse", "a.cpp"):
+            pass
+        profiler.count("parse cache hits")
+
+    def test_self_time_excludes_nested_stages(self, active):
+        with profiler.stage("template", "doc.md.j2"):
+            with profiler.stage("snippet", "a.cpp function=main", template="doc.md.j2"):
+                time.sleep(0.02)
+
+        template, snippet = sorted(active.events, key=lambda e: e.category)[::-1]
+        assert template.category == "template"
+        assert template.duration_ns >= snippet.duration_ns
+        assert template.self_ns < snippet.duration_ns
+        assert snippet.self_ns == snippet.duration_ns
+
+    def test_summary(self, active):
+        for name in ("a.cpp", "a.cpp", "b.h"):
+            with profiler.stage("parse", name):
+                pass
+        with profiler.stage("git", "blame"):
+            pass
+        with profiler.stage("snippet", "slow"):
+            time.sleep(0.01)
+        with profiler.stage("snippet", "fast"):
+            pass
+        profiler.count("parse cache hits", 3)
+
+        summary = active.summary()
+
+        assert summary["parses"] == {"a.cpp": 2, "b.h": 1}
+        assert summary["git"]["processes"] == 1
+        assert [s["name"] for s in summary["snippets"]] == ["slow", "fast"]
+        assert summary["stages"]["parse"]["count"] == 3
+        assert summary["counters"]["parse cache hits"] == 3
+
+    def test_merge_worker_profile(self, active):
+        worker = Profiler()
+        with worker.stage("parse", "a.cpp"):
+            pass
+        worker.count("parse cache misses")
+
+        active.merge(*worker.export())
+
+        assert active.summary()["parses"] == {"a.cpp": 1}
+        assert active.counters["parse cache misses"] == 1
+
+    def test_chrome_trace(self, active, tmp_path):
+        with profiler.stage("template", "doc.md.j2"):
+            with profiler.stage("parse", "a.cpp", bytes=10):
+                pass
+
+        trace_path = tmp_path / "trace.json"
+        active.write_trace(trace_path)
+        events = json.loads(trace_path.read_text())["traceEvents"]
+
+        assert [e["name"] for e in events] == ["doc.md.j2", "a.cpp"]
+        assert all(e["ph"] == "X" for e in events)
+        assert events[0]["ts"] == 0
+        assert events[1]["args"] == {"bytes": 10}
+
+
+def test_profiled_render(active, tmp_path):
+    """A render records its template, snippets, reads and parses per file."""
+    renderer = TemplateRenderer(template_dir=tmp_path, repo_path=REPO)
+    (tmp_path / "doc.md.j2").write_text(TEMPLATE)
+
+    renderer.render_template("doc.md.j2")
+    summary = active.summary()
+
+    assert {"template", "snippet", "extract"} <= set(summary["stages"])
+    assert len(summary["snippets"]) == 2
+    assert all(s["template"] == "doc.md.j2" for s in summary["snippets"])
+    assert summary["stages"]["snippet"]["count"] == 2
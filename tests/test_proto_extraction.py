@@ -0,0 +1,120 @@
+"""Tests for .proto extraction through per-file definition tables."""
+
+from pathlib import Path
+
+import pytest
+
+from projected_source.core.parse_cache import get_parse_cache
+from projected_source.core.shared_analysis import SharedAnalysis
+from projected_source.languages.proto import ProtoExtractor
+from projected_source.languages.proto_symbols import Definition, ProtoSymbolTable, get_proto_table
+
+RIPPLE = Path("tests/fixtures/ripple.proto")
+
+PROTO = """syntax = "proto3";
+package demo.v1;
+
+message Outer {
+    message Inner {
+        int32 id = 1;
+    }
+    enum Kind {
+        KIND_A = 0;
+    }
+    //@@start fields
+    Inner inner = 1;
+    //@@end fields
+}
+
+message Inner {
+    string name = 1;
+}
+
+service Peers {
+    rpc Ping (Outer) returns (Outer);
+    rpc Fetch (Inner) returns (stream Inner);
+}
+"""
+
+
+@pytest.fixture
+def proto_file(tmp_path):
+    path = tmp_path / "demo.proto"
+    path.write_text(PROTO)
+    return path
+
+
+@pytest.fixture
+def extractor():
+    return ProtoExtractor()
+
+
+class TestProtoTable:
+    def test_nested_names(self, proto_file):
+        table = get_proto_table(proto_file.read_bytes())
+
+        assert table.package == "demo.v1"
+        assert table.names("message") == ["Outer", "Outer.Inner", "Inner"]
+        assert table.names("enum") == ["Outer.Kind"]
+        assert table.names("rpc") == ["Peers.Ping", "Peers.Fetch"]
+
+    def test_plain_name_finds_first_in_document_order(self, proto_file):
+        """As with the recursive search the table replaces, a nested definition may shadow a later one."""
+        table = get_proto_table(proto_file.read_bytes())
+
+        assert table.find("message", "Inner").qualified_name == "Outer.Inner"
+        assert table.find("message", "Outer.Inner").start_line == 5
+        assert table.find("message", "demo.v1.Outer.Inner").start_line == 5
+        assert table.find("enum", "Kind").qualified_name == "Outer.Kind"
+        assert table.find("rpc", "Fetch").qualified_name == "Peers.Fetch"
+        assert table.find("message", "Missing.Inner") is None
+
+    def test_round_trip_and_sharing(self, tmp_path):
+        table = ProtoSymbolTable(package="p", definitions=[Definition("message", "A", "A", 0, 10, 1, 2)])
+        shared = SharedAnalysis(tmp_path / "shared")
+        shared.publish("digest", "proto_symbols", table)
+
+        assert ProtoSymbolTable.from_dict(table.to_dict()) == table
+        assert shared.load("digest", "proto_symbols").find("message", "A") == table.definitions[0]
+
+
+class TestProtoExtractor:
+    def test_definitions(self, extractor, proto_file):
+        text, start, end = extractor.extract_message(proto_file, "Outer.Inner")
+        assert text.startswith("message Inner {") and "int32 id" in text
+        assert (start, end) == (5, 7)
+
+        text, start, end = extractor.extract_rpc(proto_file, "Peers.Ping")
+        assert text == "rpc Ping (Outer) returns (Outer);"
+        assert start == end == 21
+
+        assert extractor.extract_service(proto_file, "Peers")[1:] == (20, 23)
+        assert extractor.extract_enum(proto_file, "Outer.Kind")[0].startswith("enum Kind")
+
+    def test_message_marker(self, extractor, proto_file):
+        text, start, end = extractor.extract_message_marker(proto_file, "Outer", "fields")
+
+        assert text.strip() == "Inner inner = 1;"
+        assert start == end == 12
+
+    def test_missing_definition(self, extractor, proto_file):
+        with pytest.raises(ValueError, match="Message 'Nope' not found") as exc_info:
+            extractor.extract_message(proto_file, "Nope")
+
+        assert "Available: Outer, Outer.Inner, Inner" in str(exc_info.value)
+
+    def test_file_parsed_once(self, extractor):
+        """Every message and enum of ripple.proto costs one parse."""
+        cache = get_parse_cache()
+        cache.clear()
+        table = extractor.definitions(RIPPLE)
+
+        for definition in table.definitions:
+            extract = getattr(extractor, f"extract_{definition.kind}")
+            _, start, end = extract(RIPPLE, definition.qualified_name)
+            assert (start, end) == (definition.start_line, definition.end_line)
+
+        assert len(table.definitions) > 40
+        assert cache.misses == 1
+        assert extractor.extract_message(RIPPLE, "TMPing")[0].startswith("message TMPing")
+        assert cache.misses == 1
@@ -0,0 +1,79 @@
+"""Tests for the content-addressed render cache."""
+
+from pathlib import Path
+
+import pytest
+
+from projected_source.core.parse_cache import get_parse_cache
+from projected_source.core.render_cache import RenderCache, extraction_key, set_render_cache
+from projected_source.core.renderer import TemplateRenderer
+
+REPO = Path.cwd()
+TEMPLATE = (
+    "{{ code('tests/fixtures/complete.cpp', function='simpleFunction', github=False) }}\n"
+    "{{ code('tests/fixtures/complete.cpp', struct='SimpleStruct', github=False) }}\n"
+)
+
+
+@pytest.fixture
+def render_cache(tmp_path):
+    cache = RenderCache(tmp_path / "cache")
+    set_render_cache(cache)
+    yield cache
+    set_render_cache(None)
+
+
+def _render() -> str:
+    return TemplateRenderer(template_dir=REPO, repo_path=REPO).env.from_string(TEMPLATE).render()
+
+
+class TestRenderCache:
+    """Test cache entries and keys."""
+
+    def test_round_trip(self, tmp_path):
+        """Stored results come back as (code_text, start_line, end_line)."""
+        cache = RenderCache(tmp_path)
+        key = extraction_key("0" * 40, "CppExtractor", {"function": "f"})
+
+        assert cache.get(key) is None
+        cache.put(key, ("int f() {}", 3, 3))
+        assert cache.get(key) == ("int f() {}", 3, 3)
+        assert (cache.hits, cache.misses) == (1, 1)
+
+    def test_key_depends_on_content_and_arguments(self):
+        """Different content or arguments give different keys."""
+        key = extraction_key("0" * 40, "CppExtractor", {"function": "f"})
+
+        assert key == extraction_key("0" * 40, "CppExtractor", {"function": "f"})
+        assert key != extraction_key("1" * 40, "CppExtractor", {"function": "f"})
+        assert key != extraction_key("0" * 40, "CppExtractor", {"function": "g"})
+
+    def test_corrupt_entry_is_a_miss(self, tmp_path):
+        """Unreadable entries are ignored rather than failing the render."""
+        cache = RenderCache(tmp_path)
+        key = extraction_key("0" * 40, "CppExtractor", {"function": "f"})
+        cache._entry_path(key).parent.mkdir(parents=True)
+        cache._entry_path(key).write_text("not json")
+
+        assert cache.get(key) is None
+
+
+class TestRendererWithCache:
+    """Test code() through the cache."""
+
+    def test_second_render_does_not_parse(self, render_cache):
+        """With every extraction cached, a fresh process skips parsing entirely."""
+        first = _render()
+        assert render_cache.misses == 2
+
+        parse_cache = get_parse_cache()
+        parse_cache.clear()
+        assert _render() == first
+        assert render_cache.hits == 2
+        assert parse_cache.misses == 0
+
+    def test_matches_uncached_render(self, render_cache):
+        """Cached output is identical to rendering without a cache."""
+        cached = _render()
+        set_render_cache(None)
+        assert _render() == cached
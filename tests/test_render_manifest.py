@@ -0,0 +1,121 @@
+"""Tests for the render manifest and incremental directory renders."""
+
+from types import SimpleNamespace
+
+import pytest
+
+from projected_source.cli.render import _render_directory
+from projected_source.core.render_manifest import MANIFEST_NAME, RenderManifest, TemplateInputs, build_entry
+
+
+@pytest.fixture
+def project(tmp_path):
+    (tmp_path / "first.cpp").write_text("int first() { return 1; }\n")
+    (tmp_path / "second.cpp").write_text("int second() { return 2; }\n")
+    (tmp_path / "docs").mkdir()
+    (tmp_path / "docs" / "footer.inc").write_text("footer\n")
+    (tmp_path / "docs" / "a.md.j2").write_text(
+        "{{ code('first.cpp', function='first', github=False) }}\n{% include 'footer.inc' %}\n"
+    )
+    (tmp_path / "docs" / "b.md.j2").write_text("{{ code('second.cpp', function='second', github=False) }}\n")
+    return tmp_path
+
+
+def _entry(project, commit_sensitive=False, commit=("https://github.com/o/r", "abc")):
+    """Manifest entry of a.md.j2 as TemplateRenderer would have collected it."""
+    inputs = TemplateInputs(
+        templates={(project / "docs" / "a.md.j2").resolve(), (project / "docs" / "footer.inc").resolve()},
+        snippets=[((project / "first.cpp").resolve(), {"function": "first", "lines": (1, 2)})],
+        commit_sensitive=commit_sensitive,
+    )
+    renderer = SimpleNamespace(
+        repo_path=project,
+        inputs={"a.md.j2": inputs},
+        dependencies={"a.md.j2": {(project / "first.cpp").resolve()}},
+        github=SimpleNamespace(github_url=commit[0], commit_hash=commit[1]),
+    )
+    return build_entry(renderer, "a.md.j2")
+
+
+def _saved(project, entry, settings=None):
+    output = project / "out" / "a.md"
+    output.parent.mkdir(exist_ok=True)
+    output.write_text("rendered\n")
+    manifest = RenderManifest(project / "out", project, settings)
+    manifest.record("a.md", entry, output)
+    manifest.save(["a.md"])
+    return output
+
+
+class TestRenderManifest:
+    def test_entry_records_inputs(self, project):
+        entry = _entry(project)
+
+        assert set(entry["templates"]) == {"docs/a.md.j2", "docs/footer.inc"}
+        assert list(entry["sources"]) == ["first.cpp"]
+        assert entry["snippets"] == [["first.cpp", {"function": "first", "lines": [1, 2]}]]
+        assert entry["commit"] is None
+
+    def test_unchanged_inputs_are_current(self, project):
+        output = _saved(project, _entry(project))
+        manifest = RenderManifest.load(project / "out", project)
+
+        assert manifest.is_current("a.md", "a.md.j2", output, None, lambda: None)
+
+    @pytest.mark.parametrize("changed", ["first.cpp", "docs/footer.inc", "docs/a.md.j2", "out/a.md"])
+    def test_changed_input_or_output_is_stale(self, project, changed):
+        output = _saved(project, _entry(project))
+        (project / changed).write_text("changed\n")
+        manifest = RenderManifest.load(project / "out", project)
+
+        assert not manifest.is_current("a.md", "a.md.j2", output, None, lambda: None)
+
+    def test_new_custom_tags_file_is_stale(self, project):
+        output = _saved(project, _entry(project))
+        custom_tags = project / ".projected-source.py"
+        custom_tags.write_text("def setup_custom_tags(env, renderer):\n    pass\n")
+        manifest = RenderManifest.load(project / "out", project)
+
+        assert not manifest.is_current("a.md", "a.md.j2", output, custom_tags, lambda: None)
+
+    def test_permalinks_depend_on_commit(self, project):
+        output = _saved(project, _entry(project, commit_sensitive=True))
+        manifest = RenderManifest.load(project / "out", project)
+
+        assert manifest.is_current("a.md", "a.md.j2", output, None, lambda: ["https://github.com/o/r", "abc"])
+        assert not manifest.is_current("a.md", "a.md.j2", output, None, lambda: ["https://github.com/o/r", "def"])
+
+    def test_other_settings_drop_entries(self, project):
+        _saved(project, _entry(project), {"remap_dirty_lines": False})
+
+        assert RenderManifest.load(project / "out", project, {"remap_dirty_lines": False}).outputs
+        assert not RenderManifest.load(project / "out", project, {"remap_dirty_lines": True}).outputs
+
+    def test_save_drops_removed_templates(self, project):
+        _saved(project, _entry(project))
+        manifest = RenderManifest.load(project / "out", project)
+        manifest.save([])
+
+        assert RenderManifest.load(project / "out", project).outputs == {}
+
+
+def test_incremental_render_skips_unchanged_outputs(project):
+    """Only outputs whose sources or templates changed are written again."""
+    docs, out = project / "docs", project / "out"
+    _render_directory(docs, out, project)
+    assert (out / MANIFEST_NAME).exists()
+    manifest = RenderManifest.load(out, project, {"remap_dirty_lines": False})
+    assert set(manifest.outputs["a.md"]["templates"]) == {"docs/a.md.j2", "docs/footer.inc"}
+
+    untouched = (out / "b.md").stat().st_mtime_ns
+    (project / "first.cpp").write_text("int first() { return 11; }\n")
+    _render_directory(docs, out, project, incremental=True)
+
+    assert "return 11;" in (out / "a.md").read_text()
+    assert (out / "b.md").stat().st_mtime_ns == untouched
+
+    (docs / "footer.inc").write_text("new footer\n")
+    _render_directory(docs, out, project, incremental=True)
+
+    assert "new footer" in (out / "a.md").read_text()
+    assert (out / "b.md").stat().st_mtime_ns == untouched
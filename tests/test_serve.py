@@ -0,0 +1,104 @@
+"""Tests for the JSON-RPC server (projected-source serve)."""
+
+import json
+import os
+from pathlib import Path
+
+import click
+import pytest
+
+from projected_source.cli.serve import METHOD_NOT_FOUND, PARSE_ERROR, ChangePoller, SnippetServer, _serve_socket
+from projected_source.core.renderer import TemplateRenderer
+
+REPO = Path.cwd()
+LINES = {"file": "tests/fixtures/complete.cpp", "lines": [1, 2]}
+
+
+@pytest.fixture
+def server(tmp_path):
+    return SnippetServer(TemplateRenderer(template_dir=tmp_path, repo_path=REPO))
+
+
+def _call(server, method, params=None, request_id=1):
+    message = {"jsonrpc": "2.0", "id": request_id, "method": method, "params": params or {}}
+    return json.loads(server.handle_line(json.dumps(message)))
+
+
+class TestSnippetServer:
+    """Test request dispatch."""
+
+    def test_extract(self, server):
+        response = _call(server, "extract", LINES)
+
+        assert response["id"] == 1
+        assert response["result"]["file"] == "tests/fixtures/complete.cpp"
+        assert (response["result"]["start_line"], response["result"]["end_line"]) == (1, 2)
+
+    def test_errors(self, server):
+        missing = _call(server, "extract", {"file": "tests/fixtures/missing.cpp", "lines": [1, 1]})
+        unknown = _call(server, "frobnicate")
+
+        assert "missing.cpp" in missing["error"]["message"]
+        assert unknown["error"]["code"] == METHOD_NOT_FOUND
+        assert json.loads(server.handle_line("{not json"))["error"]["code"] == PARSE_ERROR
+
+    def test_batch_and_notifications(self, server):
+        batch = [
+            {"jsonrpc": "2.0", "id": 1, "method": "ping"},
+            {"jsonrpc": "2.0", "method": "invalidate"},
+            {"jsonrpc": "2.0", "id": 2, "method": "extract", "params": LINES},
+        ]
+        responses = json.loads(server.handle_line(json.dumps(batch)))
+
+        assert [response["id"] for response in responses] == [1, 2]
+        assert server.handle_line(json.dumps({"jsonrpc": "2.0", "method": "ping"})) is None
+
+    def test_mcp_tools(self, server):
+        initialized = _call(server, "initialize", {"protocolVersion": "2025-03-26"})["result"]
+        assert initialized["protocolVersion"] == "2025-03-26"
+        tools = _call(server, "tools/list")["result"]["tools"]
+        assert {tool["name"] for tool in tools} == {"extract", "render"}
+
+        result = _call(server, "tools/call", {"name": "extract", "arguments": LINES})["result"]
+        assert not result["isError"]
+        assert json.loads(result["content"][0]["text"])["start_line"] == 1
+
+        failed = _call(server, "tools/call", {"name": "extract", "arguments": {"file": "nope.cpp", "lines": [1, 1]}})
+        assert failed["result"]["isError"]
+
+    def test_serve_lines_until_shutdown(self, server):
+        lines = [
+            json.dumps({"jsonrpc": "2.0", "id": 1, "method": "status"}),
+            json.dumps({"jsonrpc": "2.0", "id": 2, "method": "shutdown"}),
+            json.dumps({"jsonrpc": "2.0", "id": 3, "method": "status"}),
+        ]
+        output = []
+        server.serve_lines(lines, output.append)
+
+        assert [json.loads(line)["id"] for line in output] == [1, 2]
+        status = json.loads(output[0])["result"]
+        assert status["requests"] == 1
+        assert status["memory_peak_mb"] >= status["memory_used_mb"]
+
+
+def test_poller_sees_changed_sources(server, tmp_path):
+    source = tmp_path / "a.cpp"
+    source.write_text("int a;\n")
+    _call(server, "extract", {"file": str(source), "lines": [1, 1]})
+    poller = ChangePoller(server, None, interval=1)
+
+    assert not poller.poll()
+    stat = source.stat()
+    os.utime(source, ns=(stat.st_atime_ns, stat.st_mtime_ns + 1_000_000))
+    assert poller.poll()
+    assert not poller.poll()
+
+
+def test_socket_path_must_not_be_a_regular_file(server, tmp_path):
+    """A mistyped --socket pointing at a file leaves the file alone."""
+    target = tmp_path / "notes.txt"
+    target.write_text("keep me\n")
+
+    with pytest.raises(click.ClickException, match="not a socket"):
+        _serve_socket(server, target)
+    assert target.read_text() == "keep me\n"
@@ -0,0 +1,68 @@
+"""Tests for sharing analysis artifacts between render worker processes."""
+
+from pathlib import Path
+
+import pytest
+
+from projected_source.core.markers import scan_markers
+from projected_source.core.parse_cache import ParseCache, build_line_offsets
+from projected_source.core.shared_analysis import SharedAnalysis
+from projected_source.languages.cpp_symbols import build_symbol_table
+
+COMPLETE = Path("tests/fixtures/complete.cpp")
+
+
+@pytest.fixture
+def shared(tmp_path):
+    return SharedAnalysis(tmp_path / "shared")
+
+
+class TestSharedAnalysis:
+    """Test publishing and loading artifacts."""
+
+    def test_round_trip(self, shared):
+        """Every shareable artifact loads back equal to what was published."""
+        data = COMPLETE.read_bytes()
+        artifacts = {
+            "cpp_symbols": build_symbol_table(data),
+            "markers": scan_markers(data),
+            "line_offsets": build_line_offsets(data),
+        }
+        for key, value in artifacts.items():
+            shared.publish("digest", key, value)
+
+        assert shared.load("digest", "cpp_symbols") == artifacts["cpp_symbols"]
+        assert shared.load("digest", "markers").markers == artifacts["markers"].markers
+        assert shared.load("digest", "line_offsets") == artifacts["line_offsets"]
+        assert (shared.published, shared.loaded) == (3, 3)
+
+    def test_unshareable_keys_are_ignored(self, shared):
+        """Artifacts holding tree nodes are never written."""
+        shared.publish("digest", "macro_invocations", [{"node": object()}])
+
+        assert shared.load("digest", "macro_invocations") is None
+        assert shared.published == 0
+
+    def test_missing_and_corrupt(self, shared):
+        assert shared.load("unknown", "markers") is None
+
+        path = shared.directory / "markers" / "broken.bin"
+        path.parent.mkdir(parents=True)
+        path.write_bytes(b"not a pickle")
+        assert shared.load("broken", "markers") is None
+
+    def test_second_process_does_not_rebuild(self, shared):
+        """A cache attached to the same directory reuses what the first one built."""
+        data = COMPLETE.read_bytes()
+        first, second = ParseCache(), ParseCache()
+        first.set_shared(shared)
+        second.set_shared(shared)
+        builds = []
+
+        def build():
+            builds.append(1)
+            return build_line_offsets(data)
+
+        offsets = first.derived(first.digest(data), "line_offsets", build)
+        assert second.derived(second.digest(data), "line_offsets", build) == offsets
+        assert len(builds) == 1
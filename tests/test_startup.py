@@ -0,0 +1,69 @@
+"""Tests that CLI startup stays lazy (and, opt-in, within its budget)."""
+
+import json
+import os
+import subprocess
+import sys
+from pathlib import Path
+
+import pytest
+
+from projected_source.core.benchmark import STARTUP_BUDGET_MS, measure_startup
+
+REPO = Path(__file__).parent.parent
+
+# Modules only some commands or file types need
+LAZY_MODULES = [
+    "projected_source.cli.bench",
+    "projected_source.cli.serve",
+    "projected_source.cli.extract",
+    "projected_source.languages.proto",
+    "tree_sitter_cpp",
+    "tree_sitter_proto",
+    "rich.table",
+]
+
+
+def _loaded_after(code):
+    """Modules from LAZY_MODULES present in a fresh interpreter after running code."""
+    script = f"import json, sys\n{code}\nprint(json.dumps([m for m in {LAZY_MODULES!r} if m in sys.modules]))"
+    output = subprocess.check_output([sys.executable, "-c", script], cwd=REPO)
+    return json.loads(output)
+
+
+def test_cli_import_loads_no_subcommands():
+    assert _loaded_after("import projected_source.cli") == []
+
+
+def test_cpp_extraction_skips_proto_grammar():
+    loaded = _loaded_after(
+        "from pathlib import Path\nfrom projected_source.languages import get_extractor\n"
+        "source = Path('tests/fixtures/complete.cpp')\n"
+        "get_extractor(source).extract_function(source, 'simpleFunction')"
+    )
+    assert loaded == ["tree_sitter_cpp"]
+
+
+def test_lazy_extractor_attributes():
+    from projected_source.languages import EXTRACTORS, CppExtractor, get_extractor
+
+    assert type(get_extractor(Path("a.hpp"))) is CppExtractor
+    assert all(isinstance(spec, str) for spec in EXTRACTORS.values())
+
+
+def test_startup_commands_run(tmp_path):
+    results = measure_startup(tmp_path, iterations=1)
+
+    for name in STARTUP_BUDGET_MS:
+        assert "error" not in results[name], results[name]
+
+
+# Wall-clock budgets flake on loaded CI runners and under coverage; `projected-source bench`
+# enforces them. Set PROJECTED_SOURCE_TIMING_TESTS=1 to check them here as well.
+@pytest.mark.skipif(not os.environ.get("PROJECTED_SOURCE_TIMING_TESTS"), reason="timing checks are opt-in")
+def test_cold_startup_within_budget(tmp_path):
+    results = measure_startup(tmp_path, iterations=3)
+
+    for name, budget in STARTUP_BUDGET_MS.items():
+        assert "error" not in results[name], results[name]
+        assert results[name]["p50_ms"] <= budget, (name, results[name])
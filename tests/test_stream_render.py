@@ -0,0 +1,57 @@
+"""Tests for streaming template output (render --stream)."""
+
+from pathlib import Path
+
+import pytest
+
+from projected_source.cli.render import _render_directory, _write_chunks
+from projected_source.core.renderer import TemplateRenderer
+
+REPO = Path.cwd()
+
+TEMPLATE = (
+    "# Bundle\n"
+    "{% for name in ['simpleFunction', 'namespacedFunction'] %}\n"
+    "{{ code('tests/fixtures/complete.cpp', function=name, github=False) }}\n"
+    "{% endfor %}\n"
+)
+
+
+def test_stream_matches_render(tmp_path):
+    """Joined chunks equal the rendered string, and are produced incrementally."""
+    (tmp_path / "bundle.md.j2").write_text(TEMPLATE)
+    renderer = TemplateRenderer(template_dir=tmp_path, repo_path=REPO)
+
+    chunks = list(renderer.stream_template("bundle.md.j2"))
+
+    assert len(chunks) > 1
+    assert "".join(chunks) == renderer.render_template("bundle.md.j2")
+
+
+def test_stream_directory_matches_serial(tmp_path):
+    """render --stream writes the same files as a buffered render."""
+    for directory in ("buffered", "streamed"):
+        (tmp_path / directory).mkdir()
+        (tmp_path / directory / "bundle.md.j2").write_text(TEMPLATE)
+
+    _render_directory(tmp_path / "buffered", tmp_path / "buffered", REPO)
+    _render_directory(tmp_path / "streamed", tmp_path / "streamed", REPO, stream=True)
+
+    assert (tmp_path / "streamed" / "bundle.md").read_text() == (tmp_path / "buffered" / "bundle.md").read_text()
+    assert not (tmp_path / "streamed" / "bundle.md.partial").exists()
+
+
+def test_failed_stream_keeps_previous_output(tmp_path):
+    """A render that fails midway leaves the old output file and no partial file."""
+    output = tmp_path / "out.md"
+    output.write_text("previous\n")
+
+    def chunks():
+        yield "half of the "
+        raise RuntimeError("template error")
+
+    with pytest.raises(RuntimeError):
+        _write_chunks(chunks(), output)
+
+    assert output.read_text() == "previous\n"
+    assert not (tmp_path / "out.md.partial").exists()
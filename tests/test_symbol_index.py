@@ -0,0 +1,136 @@
+"""Tests for per-file symbol tables and the on-disk symbol index."""
+
+import json
+from pathlib import Path
+
+import pytest
+from tree_sitter import Node
+
+from projected_source.core.parse_cache import get_parse_cache
+from projected_source.core.symbol_index import SymbolIndex, index_files, set_symbol_index
+from projected_source.languages.cpp import CppExtractor
+from projected_source.languages.cpp_symbols import CppSymbolTable, build_symbol_table
+
+COMPLETE = Path("tests/fixtures/complete.cpp")
+CLASS_METHODS = Path("tests/fixtures/class_methods.h")
+
+
+def _holds_node(value) -> bool:
+    if isinstance(value, Node):
+        return True
+    if isinstance(value, dict):
+        return any(_holds_node(item) for item in value.values())
+    if isinstance(value, (list, tuple)):
+        return any(_holds_node(item) for item in value)
+    return False
+
+
+@pytest.fixture
+def index(tmp_path):
+    symbol_index = SymbolIndex(tmp_path / ".projected-source" / "index.db")
+    yield symbol_index
+    set_symbol_index(None)
+    symbol_index.close()
+
+
+class TestSymbolTable:
+    """Test building and serializing symbol tables."""
+
+    def test_records_all_symbol_kinds(self):
+        """Functions, methods, types, #defines and macro invocations are recorded."""
+        table = build_symbol_table(COMPLETE.read_bytes())
+
+        assert table.find_function("simpleFunction") is not None
+        assert table.find_type("SimpleStruct") is not None
+        assert table.find_macro_definition("MAX_SIZE") is not None
+        assert table.find_macro_invocations("DEFINE_JS_FUNCTION")
+
+    def test_field_declaration_methods(self):
+        """Method declarations in headers are candidates with their parameter list."""
+        table = build_symbol_table(CLASS_METHODS.read_bytes())
+
+        overloads = table.find_overloads("ShuffleService::addProposal")
+        assert overloads
+        assert all(s.node_type == "field_declaration" for s in overloads)
+        assert "uint256 const& prevLedger" in overloads[0].signature
+
+    def test_round_trip(self):
+        """to_dict()/from_dict() through JSON gives an equal table."""
+        table = build_symbol_table(COMPLETE.read_bytes())
+        restored = CppSymbolTable.from_dict(json.loads(json.dumps(table.to_dict())))
+
+        assert restored == table
+        assert restored.find_function("simpleFunction") == table.find_function("simpleFunction")
+
+    def test_other_version_is_ignored(self):
+        """Tables written by another table version are not loaded."""
+        data = build_symbol_table(COMPLETE.read_bytes()).to_dict()
+        data["version"] = -1
+        assert CppSymbolTable.from_dict(data) is None
+
+
+class TestSymbolIndex:
+    """Test the SQLite index."""
+
+    def test_index_files_is_incremental(self, index):
+        """Files are walked once, then skipped by (mtime, size)."""
+        first = index_files([COMPLETE, CLASS_METHODS], index)
+        assert (first.files, first.built, first.unchanged) == (2, 2, 0)
+
+        second = index_files([COMPLETE, CLASS_METHODS], index)
+        assert (second.built, second.unchanged) == (0, 2)
+
+    def test_identical_content_is_reused(self, index, tmp_path):
+        """A copy of an indexed file is recognized by its blob hash."""
+        index_files([COMPLETE], index)
+        copy = tmp_path / "copy.cpp"
+        copy.write_bytes(COMPLETE.read_bytes())
+
+        stats = index_files([copy], index)
+        assert (stats.built, stats.reused) == (0, 1)
+
+    def test_extraction_from_index_does_not_parse(self, index):
+        """With an index, extract_function is a table lookup plus a slice."""
+        index_files([COMPLETE], index)
+        expected = CppExtractor().extract_function(COMPLETE, "simpleFunction")
+
+        cache = get_parse_cache()
+        cache.clear()
+        set_symbol_index(index)
+
+        assert CppExtractor().extract_function(COMPLETE, "simpleFunction") == expected
+        assert cache.misses == 0
+
+    def test_find_files(self, index):
+        """Symbols can be looked up across indexed files."""
+        index_files([COMPLETE, CLASS_METHODS], index)
+
+        matches = index.find_files("ShuffleService::addProposal")
+        assert {path.name for path, _, _ in matches} == {"class_methods.h"}
+        assert index.find_files("noSuchSymbol") == []
+
+    def test_indexed_files_are_not_kept_in_memory(self, index):
+        """Building the index leaves no file bytes, trees or tree-holding tables behind in the parse cache."""
+        cache = get_parse_cache()
+        cache.clear()
+
+        index_files([COMPLETE, CLASS_METHODS], index)
+        assert cache.cached_paths() == []
+        assert not cache._parsed
+        # Nothing derived may pin a tree: a node keeps its whole tree alive
+        assert not any(_holds_node(value) for value in cache._derived.values())
+
+    def test_deleted_files_are_dropped(self, index, tmp_path):
+        """Files removed from disk no longer resolve on the next build."""
+        header = tmp_path / "gone.h"
+        header.write_text("void goneFunction();\n")
+        index_files([header], index)
+        assert index.find_files("goneFunction")
+
+        header.unlink()
+        index_files([], index)
+        assert index.find_files("goneFunction") == []
+
+    def test_gitignore_created(self, index):
+        """The default index directory keeps itself out of git."""
+        assert (index.path.parent / ".gitignore").read_text() == "*\n"
@@ -0,0 +1,137 @@
+"""Tests for code() symbol lookups without a file path."""
+
+import pytest
+
+from projected_source.core.renderer import TemplateRenderer
+from projected_source.core.symbol_index import get_symbol_index, set_symbol_index
+from projected_source.core.symbol_resolver import SymbolResolver, set_symbol_resolver
+
+HEADER = """namespace ns {
+class Server {
+public:
+    void run();
+    void send(int code);
+    void send(const char* text);
+};
+}
+"""
+
+SOURCE = """#include "server.h"
+
+namespace ns {
+void Server::run() {
+    send(1);
+}
+
+void Server::send(int code) {
+    (void)code;
+}
+
+void Server::send(const char* text) {
+    (void)text;
+}
+}
+"""
+
+OTHER = """namespace other {
+struct Config {
+    int size;
+};
+}
+
+namespace ns {
+struct Config {
+    int limit;
+};
+}
+"""
+
+
+@pytest.fixture
+def repo(tmp_path):
+    (tmp_path / "include").mkdir()
+    (tmp_path / "src").mkdir()
+    (tmp_path / "include" / "server.h").write_text(HEADER)
+    (tmp_path / "src" / "server.cpp").write_text(SOURCE)
+    (tmp_path / "src" / "config.h").write_text(OTHER)
+    return tmp_path
+
+
+@pytest.fixture
+def resolver(repo):
+    symbol_resolver = SymbolResolver([repo], repo / ".projected-source" / "index.db")
+    set_symbol_resolver(symbol_resolver)
+    yield symbol_resolver
+    set_symbol_resolver(None)
+    index = get_symbol_index()
+    if index:
+        index.close()
+        set_symbol_index(None)
+
+
+class TestSymbolResolver:
+    """Test resolving symbols to files."""
+
+    def test_definition_wins_over_declaration(self, repo, resolver):
+        """A method declared in a header and defined in a .cpp resolves to the .cpp."""
+        assert resolver.resolve("function", "ns::Server::run") == (repo / "src" / "server.cpp").resolve()
+
+    def test_signature_filters_overloads(self, repo, resolver):
+        """signature= must match one of the overloads in the resolved file."""
+        assert resolver.resolve("function", "Server::send", "const char*").name == "server.cpp"
+        with pytest.raises(ValueError, match="signature"):
+            resolver.resolve("function", "Server::send", "double")
+
+    def test_signature_by_parameter_types(self, resolver):
+        """Exact parameter types select an overload as they do when the path is given."""
+        assert resolver.resolve("function", "Server::send", "const char *").name == "server.cpp"
+        assert resolver.resolve("function", "ns::Server::send", "int").name == "server.cpp"
+
+    def test_ambiguous_name(self, resolver):
+        """A leaf name defined in several files needs qualifying."""
+        (resolver.roots[0] / "src" / "client.cpp").write_text("void run() {}\n")
+        with pytest.raises(ValueError, match="2 files"):
+            resolver.resolve("function", "run")
+
+    def test_qualified_type(self, resolver):
+        """A qualified name picks one of several same-named types."""
+        assert resolver.resolve("struct", "other::Config").name == "config.h"
+
+    def test_unknown_symbol(self, resolver):
+        with pytest.raises(ValueError, match="No file under"):
+            resolver.resolve("function", "missing")
+
+    def test_roots_restrict_search(self, repo):
+        """Files outside the include roots are not considered."""
+        symbol_resolver = SymbolResolver([repo / "include"], repo / ".projected-source" / "index.db")
+        try:
+            path = symbol_resolver.resolve("function", "ns::Server::run")
+        finally:
+            symbol_resolver.index.close()
+            set_symbol_index(None)
+        assert path == (repo / "include" / "server.h").resolve()
+
+    def test_background_build(self, resolver):
+        """start() builds the index without blocking; lookups wait for it."""
+        resolver.start()
+        resolver.wait()
+        assert resolver.stats.files == 3
+        assert resolver.stats.built == 3
+
+
+class TestPathlessCode:
+    """Test code() calls without a file path."""
+
+    def test_code_finds_file(self, repo, resolver):
+        renderer = TemplateRenderer(template_dir=repo, repo_path=repo)
+        result = renderer.env.from_string("{{ code(function='ns::Server::run', github=False) }}").render()
+
+        assert "src/server.cpp:4-6" in result
+        assert "send(1);" in result
+
+    def test_code_without_resolver(self, repo):
+        renderer = TemplateRenderer(template_dir=repo, repo_path=repo)
+        result = renderer.env.from_string("{{ code(function='ns::Server::run') }}").render()
+
+        assert "ERROR" in result
+        assert "needs a file path" in result
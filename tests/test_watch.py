@@ -0,0 +1,35 @@
+"""Tests for watch-mode dependency tracking."""
+
+import pytest
+
+from projected_source.cli.watch import TemplateWatcher
+from projected_source.core.renderer import TemplateRenderer
+
+
+@pytest.fixture
+def project(tmp_path):
+    (tmp_path / "first.cpp").write_text("int first() { return 1; }\n")
+    (tmp_path / "second.cpp").write_text("int second() { return 2; }\n")
+    (tmp_path / "a.md.j2").write_text("{{ code('first.cpp', function='first', github=False) }}\n")
+    (tmp_path / "b.md.j2").write_text("{{ code('second.cpp', function='second', github=False) }}\n")
+    return tmp_path
+
+
+def test_renderer_records_dependencies(project):
+    """Each template remembers the source files its code() calls read."""
+    renderer = TemplateRenderer(template_dir=project, repo_path=project)
+    renderer.render_template("a.md.j2")
+
+    assert renderer.dependencies["a.md.j2"] == {(project / "first.cpp").resolve()}
+
+
+def test_only_dependent_templates_rerendered(project):
+    """A source change selects its templates; a template change selects all."""
+    renderer = TemplateRenderer(template_dir=project, repo_path=project)
+    targets = [("a.md.j2", project / "a.md"), ("b.md.j2", project / "b.md")]
+    watcher = TemplateWatcher(renderer, targets)
+    watcher.render(targets)
+
+    assert "return 1;" in (project / "a.md").read_text()
+    assert watcher.affected_targets({(project / "second.cpp").resolve()}) == [targets[1]]
+    assert watcher.affected_targets({(project / "a.md.j2").resolve()}) == targets